@@ -9,15 +9,27 @@
 #define LEXIMAXIST_IPASIRWRAP
 
 #include <leximaxIST_types.h>
+#include <leximaxIST_ClauseArena.h>
 #include <vector>
 
 namespace leximaxIST {
+    
+    class Deadline;
+    
+    /* Wrapper of an IPASIR solver. If LEXIMAXIST_CADICAL is defined the CaDiCaL API is used directly,
+     * so that copy_to can use CaDiCaL's native copy of the clauses.
+     */
     class IpasirWrap {
     public:
         IpasirWrap();
+        // if snapshot is true, the solver can be copied with copy_to (an IPASIR solver keeps a copy of its clauses)
+        explicit IpasirWrap(bool snapshot);
+        IpasirWrap(const IpasirWrap &) = delete;
+        IpasirWrap& operator=(const IpasirWrap &) = delete;
         virtual ~IpasirWrap();
         void addClauses(const std::vector<Clause> &cls);
-        void addClause(const Clause &clause);
+        void addClauses(const ClauseArena &cls);
+        void addClause(ClauseRef clause);
         void addClause(int p);
         void addClause(int p, int q);
         void addClause(int p, int q, int r);
@@ -26,6 +38,14 @@ namespace leximaxIST {
         bool is_ok_lit(int l);
         // return a non-const reference to be able to steal _model's data with move semantics
         std::vector<int>& model();
+        
+        /* only the variables 1..nb_vars are extracted into model() after a SAT answer (0 means all variables)
+         * the other variables can be looked up with val until the solver is modified
+         */
+        void set_model_vars(int nb_vars);
+        
+        // value (+v or -v) of variable v in the last model
+        int val(int v);
         const std::vector<int>& conflict() const;
 
         /* set a timeout (in seconds) counting from when this function is called
@@ -33,6 +53,9 @@ namespace leximaxIST {
          */
         void set_timeout(double timeout, double init_time);
         
+        // the solver is interrupted when the deadline is reached (nullptr removes the deadline)
+        void set_deadline(Deadline *deadline);
+        
         int nVars() const;
 
         /* Returns the return value of the ipasir function:
@@ -43,20 +66,32 @@ namespace leximaxIST {
         int solve(const std::vector<int>& assumps);
         int solve();
         
+        /* adds the clauses of this solver to the empty solver other (a warm start instead of adding the clauses again)
+         * the assumptions, the model, the conflict and the timeout are not copied (the model variables and the deadline are)
+         */
+        void copy_to(IpasirWrap &other) const;
+        
     private:
         //const int           _verb = 1;
         int                _nvars;
         void*              _s;
         std::vector<int> _model;
+        int _model_vars; // if positive, only the variables 1.._model_vars are in _model
         std::vector<int> _conflict;
+        bool _snapshot;
+        std::vector<int> _clauses; // clauses added (separated by 0) if _snapshot and IPASIR is used
+        void* _terminator; // CaDiCaL terminator (if LEXIMAXIST_CADICAL is defined)
     public:
         struct TimeParams {
             double m_timeout;
             double m_init_time;
+            Deadline *m_deadline;
         };
     private:
         TimeParams _time_params;
 
+        void connect_terminate();
+
         void add(int p);
 
         void f();
@@ -0,0 +1,153 @@
+#ifndef LEXIMAXIST_CLAUSEARENA
+#define LEXIMAXIST_CLAUSEARENA
+#include <leximaxIST_types.h>
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+namespace leximaxIST {
+
+    // view of the literals of a clause (in a ClauseArena or in a Clause)
+    class ClauseRef {
+    public:
+        ClauseRef(const int *first, const int *last) : m_first(first), m_last(last) {}
+        ClauseRef(const Clause &cl) : m_first(cl.data()), m_last(cl.data() + cl.size()) {}
+
+        const int* begin() const { return m_first; }
+        const int* end() const { return m_last; }
+        size_t size() const { return m_last - m_first; }
+        bool empty() const { return m_first == m_last; }
+        int operator[](size_t i) const { return m_first[i]; }
+
+    private:
+        const int *m_first;
+        const int *m_last;
+    };
+
+    /* Set of clauses stored contiguously: the literals of all clauses are in m_lits and
+     * the literals of clause i are in positions [m_offsets[i], m_offsets[i+1]).
+     * If the arena does not retain its clauses, only the last clause is stored (for back())
+     * but size() still counts every clause that was added.
+     */
+    class ClauseArena {
+    public:
+        class const_iterator {
+        public:
+            const_iterator(const ClauseArena *arena, size_t i) : m_arena(arena), m_i(i) {}
+            ClauseRef operator*() const { return (*m_arena)[m_i]; }
+            const_iterator& operator++() { ++m_i; return *this; }
+            bool operator==(const const_iterator &other) const { return m_i == other.m_i; }
+            bool operator!=(const const_iterator &other) const { return m_i != other.m_i; }
+        private:
+            const ClauseArena *m_arena;
+            size_t m_i;
+        };
+
+        ClauseArena() : m_offsets(1, 0), m_size(0), m_retain(true) {}
+
+        // number of clauses
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        size_t nb_lits() const { return m_lits.size(); }
+        bool retains() const { return m_retain; }
+
+        void clear()
+        {
+            m_lits.clear();
+            m_offsets.assign(1, 0);
+            m_size = 0;
+        }
+
+        // the clauses that are already stored are dropped if retain is false
+        void set_retain(bool retain)
+        {
+            m_retain = retain;
+            if (!m_retain) {
+                m_lits.clear();
+                m_lits.shrink_to_fit();
+                m_offsets.assign(1, 0);
+                m_offsets.shrink_to_fit();
+            }
+        }
+
+        void reserve(size_t nb_clauses, size_t nb_lits)
+        {
+            m_offsets.reserve(nb_clauses + 1);
+            m_lits.reserve(nb_lits);
+        }
+
+        void push_back(ClauseRef cl)
+        {
+            new_clause();
+            m_lits.insert(m_lits.end(), cl.begin(), cl.end());
+            m_offsets.push_back(m_lits.size());
+        }
+
+        // fixed-arity clauses, without a temporary Clause
+        void push_back(int l1)
+        {
+            new_clause();
+            m_lits.push_back(l1);
+            m_offsets.push_back(m_lits.size());
+        }
+
+        void push_back(int l1, int l2)
+        {
+            new_clause();
+            m_lits.push_back(l1);
+            m_lits.push_back(l2);
+            m_offsets.push_back(m_lits.size());
+        }
+
+        void push_back(int l1, int l2, int l3)
+        {
+            new_clause();
+            m_lits.push_back(l1);
+            m_lits.push_back(l2);
+            m_lits.push_back(l3);
+            m_offsets.push_back(m_lits.size());
+        }
+
+        // i indexes the stored clauses, so a non-retaining arena only has the last one
+        ClauseRef operator[](size_t i) const
+        {
+            assert(i + 1 < m_offsets.size());
+            const int *lits (m_lits.data());
+            return ClauseRef(lits + m_offsets[i], lits + m_offsets[i + 1]);
+        }
+
+        ClauseRef back() const { return (*this)[m_offsets.size() - 2]; }
+
+        // adds offset to the variables greater than last_var, keeping the sign of the literals
+        void shift_vars(int last_var, int offset)
+        {
+            for (int &lit : m_lits) {
+                if (lit > last_var)
+                    lit += offset;
+                else if (lit < -last_var)
+                    lit -= offset;
+            }
+        }
+
+        // iterates over the stored clauses (all of them only if the arena retains its clauses)
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_offsets.size() - 1); }
+
+    private:
+        void new_clause()
+        {
+            ++m_size;
+            if (!m_retain) {
+                m_lits.clear();
+                m_offsets.resize(1);
+            }
+        }
+
+        std::vector<int> m_lits;
+        std::vector<size_t> m_offsets;
+        size_t m_size; // number of clauses added (including the ones that were not retained)
+        bool m_retain;
+    };
+
+}
+#endif /* LEXIMAXIST_CLAUSEARENA */
@@ -0,0 +1,61 @@
+#ifndef LEXIMAXIST_DEADLINE
+#define LEXIMAXIST_DEADLINE
+#include <chrono>
+
+namespace leximaxIST {
+
+    // thrown when the deadline or the memory budget is reached, caught by optimise() and approximate()
+    struct DeadlineReached {};
+
+    /* Wall-clock deadline and memory budget (current resident set size) of the algorithms.
+     * check() reads the monotonic clock, and the RSS if it was last read at least memory_period ago.
+     * poll() is meant for tight loops (and the terminate callback of the SAT solver)
+     * and only calls check() once every poll_period calls.
+     * Once reached, the deadline stays reached until it is set again.
+     */
+    class Deadline {
+    public:
+        Deadline();
+
+        // the deadline is the current time plus seconds
+        void set_time(double seconds);
+
+        // budget of the RSS in megabytes
+        void set_memory(double megabytes);
+
+        // mark the deadline as reached (_UNKNOWN_ or _MEMOUT_), e.g. if an allocation failed
+        void interrupt(int reason);
+
+        bool check();
+
+        bool poll()
+        {
+            if (++m_polls < poll_period)
+                return m_reason != 0;
+            m_polls = 0;
+            return check();
+        }
+
+        bool reached() const { return m_reason != 0; }
+
+        // 0 if not reached, _UNKNOWN_ if the time is up, _MEMOUT_ if the memory budget was exceeded
+        int reason() const { return m_reason; }
+
+        bool has_time() const { return m_has_time; }
+
+        // seconds until the deadline (0 if it has passed)
+        double remaining() const;
+
+    private:
+        static constexpr unsigned poll_period = 1024;
+        static constexpr std::chrono::milliseconds memory_period {100};
+        std::chrono::steady_clock::time_point m_end;
+        bool m_has_time;
+        long m_memory_kb; // 0 if there is no memory budget
+        std::chrono::steady_clock::time_point m_next_memory_check;
+        unsigned m_polls;
+        int m_reason;
+    };
+
+}
+#endif /* LEXIMAXIST_DEADLINE */
@@ -0,0 +1,44 @@
+#ifndef LEXIMAXIST_ILPBACKEND
+#define LEXIMAXIST_ILPBACKEND
+#include <leximaxIST_ILPConstraint.h>
+#include <string>
+#include <vector>
+
+namespace leximaxIST {
+
+    /* ILP solver linked into leximaxIST, used by the ilp algorithm instead of an external solver.
+     * The model is kept across the iterations of the algorithm, which only add variables
+     * and constraints and change the objective. Variable v of leximaxIST is column v - 1.
+     */
+    class ILPBackend {
+    public:
+        virtual ~ILPBackend() {}
+
+        // number of variables in the model
+        virtual int nb_vars() const = 0;
+
+        // adds variable nb_vars() + 1, which is either binary or a non-negative integer
+        virtual void add_var(bool binary) = 0;
+
+        virtual void add_constraint(const ILPConstraint &constraint) = 0;
+
+        // the objective becomes the minimisation of var
+        virtual void minimise(int var) = 0;
+
+        // values[v] is the value of variable v in a feasible solution, used as a MIP start
+        virtual void set_start(const std::vector<int> &values) = 0;
+
+        /* solves the model, stopping after time_limit seconds if time_limit > 0
+         * returns _OPTIMUM_, _SATISFIABLE_ (not proven optimal), _UNSATISFIABLE_ or _UNKNOWN_ (no solution found)
+         * if there is a solution, values[v] is the value of variable v in the best solution found
+         */
+        virtual int solve(double time_limit, std::vector<int> &values) = 0;
+    };
+
+    /* returns the ILP solver called name if it is linked into leximaxIST (e.g. "cbc")
+     * and nullptr if name is an external solver (e.g. "gurobi")
+     */
+    ILPBackend* new_ilp_backend(const std::string &name, int verbosity);
+
+}
+#endif /* LEXIMAXIST_ILPBACKEND */
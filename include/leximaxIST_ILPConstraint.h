@@ -4,8 +4,7 @@
 #include <string>
 #include <vector>
 #include <cmath>
-#include <iostream>
-#include <fstream>
+#include <leximaxIST_Writer.h>
 
 namespace leximaxIST {
 
@@ -30,20 +29,17 @@ namespace leximaxIST {
         std::string m_sign; // can be either '<=', '>=' or '='
         int m_rhs;
         
-        void print(std::ostream &os) const
+        void print(Writer &os) const
         {
-            std::string line ("");
+            size_t line_start (os.nb_bytes());
             for (size_t i (0); i < m_vars.size(); ++i) {
-                line += (m_coeffs.at(i) > 0) ? " + " : " - ";
-                line += std::to_string(std::abs(m_coeffs.at(i)));
-                line += " x" + std::to_string(m_vars.at(i)) + " ";
-                if (line.size() >= 80) {
-                    os << line << '\n';
-                    line = "";
+                os << ((m_coeffs[i] > 0) ? " + " : " - ") << std::abs(m_coeffs[i]) << " x" << m_vars[i] << ' ';
+                if (os.nb_bytes() - line_start >= 80) {
+                    os << '\n';
+                    line_start = os.nb_bytes();
                 }
             }
-            line += m_sign + " " + std::to_string(m_rhs);
-            os << line << '\n';
+            os << m_sign << ' ' << m_rhs << '\n';
         }
     }; // ILPConstraint definition
 
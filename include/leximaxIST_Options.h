@@ -39,17 +39,24 @@ namespace leximaxIST {
 
     class Options {
     public:
-        enum FileType { OPB, MCNF };
+        enum FileType { OPB, MCNF, SNAPSHOT };
 
     private:
         Option<int> m_help;
         Option<int> m_verbosity;
         Option<int> m_leave_tmp_files;
+        Option<int> m_gzip_input;
         Option<std::string> m_optimise;
         Option<std::string> m_input_file_name;
         Option<int> m_disjoint_cores;
+        Option<int> m_maxsat_presolve;
+        Option<int> m_half_comparators;
+        Option<std::string> m_sorter;
+        Option<std::string> m_retention;
         Option<std::string> m_approx;
         Option<double> m_timeout;
+        Option<double> m_deadline;
+        Option<double> m_mem_limit;
         Option<int> m_mss_tol;
         Option<int> m_mss_add_cls;
         Option<int> m_mss_incr;
@@ -60,6 +67,10 @@ namespace leximaxIST {
         Option<std::string> m_ilp_solver;
 
         Option<int> m_input_file_type;
+        Option<int> m_parse_threads;
+        Option<int> m_encode_threads;
+        Option<std::string> m_enc_policy;
+        Option<std::string> m_write_snapshot;
         Option<int> m_preprocessing;
         Option<std::string> m_maxpre_techniques;
         
@@ -70,11 +81,18 @@ namespace leximaxIST {
         int get_help();
         int get_verbosity();
         int get_leave_tmp_files();
+        int get_gzip_input();
         int get_disjoint_cores();
+        int get_maxsat_presolve();
+        int get_half_comparators();
+        const std::string& get_sorter();
+        const std::string& get_retention();
         const std::string& get_optimise();
         const std::string& get_approx();
         const std::string& get_input_file_name();
         double get_timeout();
+        double get_deadline();
+        double get_mem_limit();
         int get_mss_tol();
         int get_mss_add_cls();
         int get_mss_incr();
@@ -85,6 +103,10 @@ namespace leximaxIST {
         const std::string& get_ilp_solver();
 
         FileType get_input_file_type();
+        int get_parse_threads();
+        int get_encode_threads();
+        int get_enc_policy();
+        const std::string& get_write_snapshot();
 
         bool get_preprocessing();
         const std::string& get_maxpre_techiques();
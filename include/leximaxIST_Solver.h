@@ -1,9 +1,12 @@
 #ifndef LEXIMAXIST_SOLVER
 #define LEXIMAXIST_SOLVER
 #include <leximaxIST_types.h>
+#include <leximaxIST_ClauseArena.h>
+#include <leximaxIST_Deadline.h>
 #include <IpasirWrap.h>
 #include <leximaxIST_parsing_utils.h>
 #include <leximaxIST_ILPConstraint.h>
+#include <leximaxIST_Writer.h>
 #include <string> // std::string
 #include <vector> // std::vector
 #include <unordered_map> // std::unordered_map
@@ -11,11 +14,14 @@
 #include <list> // std::list
 #include <sys/types.h> // pid_t
 #include <cstdint>
+#include <iosfwd> // std::ostream
 
 
 namespace leximaxIST
 {
 
+    class ILPBackend;
+
     class Solver {
         /* TODO: check if pointers can be removed without affecting performance
          * The problem is reallocation of vector while growing
@@ -31,12 +37,19 @@ namespace leximaxIST
         int m_verbosity; // 0: nothing, 1: solving phases, time + obj vector, 2: everything including encoding
         int m_id_count;
         int m_input_nb_vars; // number of vars of input problem - useful to return assignment of only these variables
-        std::vector<Clause> m_input_hard; // also contains the equivalence between soft clauses and obj variables
-        std::vector<Clause> m_encoding; // encoding clauses
+        ClauseArena m_input_hard; // also contains the equivalence between soft clauses and obj variables
+        ClauseArena m_encoding; // encoding clauses
         std::vector<int> m_soft_clauses; // unit clauses
+        std::vector<int> m_soft_weights; // weight of each soft clause
+        std::vector<int> m_max_values; // the max (and soft) variables are true if the maximum is at least these values, in decreasing order
         std::vector<std::vector<int>> m_objectives;
+        std::vector<uint64_t> m_obj_weights; // weight of each objective variable, indexed by variable (0 if not an objective variable)
+        uint64_t m_weights_gcd; // gcd of all objective weights - internally, objective values are multiples of it
         int m_num_objectives;
         std::vector<std::vector<int>> m_sorted_vecs;
+        std::vector<std::vector<int>> m_sorted_values; // m_sorted_vecs[j][k] is true iff the jth objective is at least m_sorted_values[j][k]
+        std::vector<std::vector<GTE_OUT>> m_sorted_runs; // sorted runs of each objective in core_merge (merged into the sorted vector)
+        std::vector<std::vector<GTE_OUT>> m_sorted_prefixes; // m_sorted_prefixes[j][r] is the merge of the sorted runs 0..r of the jth objective
         std::vector<std::vector<std::vector<int>>>  m_sorted_relax_collection;
         std::vector<std::list<int>> m_all_relax_vars; // relax_vars of each iteration
         std::string m_ext_solver_cmd; // for external call to optimisation solver
@@ -46,9 +59,14 @@ namespace leximaxIST
         std::string m_opt_mode; // optimisation algorithm : lin-su, lin-us, bin, core-merge, ...
         std::string m_approx; // approximation algorithm : mss, gia
         bool m_disjoint_cores; // use disjoint cores strategy in the core-guided algorithm
+        bool m_half_comparators; // encode only the polarity of the comparators that is needed by the use of the sorted vectors
+        int m_sorted_polarity; // polarity of the comparators of the current sorted vectors
+        std::string m_sorter; // encoding of the sorted vectors : odd_even, totalizer, pairwise, auto
+        std::string m_retention; // clauses kept after being given to the SAT solver : all, inputs, none
         pid_t m_child_pid;
         double m_timeout; // timeout for signal handling in milliseconds
         bool m_leave_tmp_files;
+        bool m_gzip_input; // compress the input files of the external solvers
         bool m_simplify_last; // if true the algorithm does not use the sorting networks in the last iteration
         char m_status; // 's' for SATISFIABLE, 'u' for UNSATISFIABLE, '?' for UNKNOWN, 'o' for OPTIMUM FOUND
         double m_approx_tout; // timeout for approximation
@@ -59,16 +77,27 @@ namespace leximaxIST
         int m_mss_nb_limit; // stop the enumeration when this number of MSSes is reached
         int m_mss_tolerance; // tolerance for choosing the next clause from a maximum objective
         bool m_maxsat_presolve; // to get lower bound (and upper bound) of optimum
-        std::string m_maxsat_psol_cmd;
+        std::string m_maxsat_psol_cmd; // external MaxSAT solver of the presolve (empty for the internal OLL search)
+        std::vector<SumCore> m_sum_cores; // cores of the internal presolve, they seed the disjoint cores
         // the next one is usefull if computation is stopped and you get an intermediate solution
         // you want to know which values of the objective vector are in theory guaranteed to be optimal
         //int m_num_opts; // number of optimal values found: 0 = none; 1 = first maximum is optimal; 2 = first and second; ...
         std::string m_multiplication_string;
         std::vector<int> m_solution;
+        std::vector<int> m_solution_obj_vec; // objective vector of m_solution (cached)
+        std::vector<int> m_solution_sorted; // m_solution_obj_vec sorted in descending order
+        std::vector<int> m_eval_weights; // weight of each objective variable divided by the gcd, indexed by variable
+        bool m_eval_ranges; // whether the variables of each objective are consecutive (see evaluate)
+        std::vector<int> m_eval_obj_vec; // objective vector of the last model evaluated in set_solution (reused buffer)
+        std::vector<int> m_eval_sorted; // m_eval_obj_vec sorted in descending order (reused buffer)
         std::vector<std::pair<int, int>> m_snet_info; // first = nb wires and second = nb comparators 
+        std::vector<CoreVar> m_core_vars; // core-guided search: objective and position of each variable, indexed by variable
         //std::vector<double> m_times; // time of each step of solving (only external solver times)
         IpasirWrap *m_sat_solver;
         std::vector<std::string> m_tmp_files; // container with the names of all temporary files used by the solver
+        std::vector<int> m_instance_fds; // memory files with the input of the external solver
+        static constexpr size_t ext_read_size = 65536; // bytes read from the pipe of the external solver at a time
+        Deadline m_deadline; // wall-clock deadline and memory budget of optimise() and approximate()
         
     public:    
 
@@ -84,6 +113,10 @@ namespace leximaxIST
         
         char get_status() const;
         
+        // _UNKNOWN_ if the last optimise()/approximate() stopped at the deadline, _MEMOUT_ if it exceeded the memory budget, 0 otherwise
+        // (the status is then 's' and the best solution found can be retrieved, or '?' if there is none)
+        int get_interrupt() const;
+        
         void print_solution() const; // prints solution in a similar format to the MaxSAT output format
 
         void print_solution(std::vector<int>) const; // prints solution in a similar format to the MaxSAT output format
@@ -100,11 +133,25 @@ namespace leximaxIST
         // empty if unsat; not a const reference because it is not a member variable
         std::vector<int> get_objective_vector() const;
         
-        void add_hard_clause(const Clause &cl);
+        void add_hard_clause(ClauseRef cl);
+        
+        void add_hard_clauses(const ClauseArena &clauses);
+        
+        // variables 1..nb_vars are input variables, even if they are not in a clause yet
+        void reserve_vars(int nb_vars);
         
         void add_soft_clauses(const std::vector<Clause> &soft_clauses);
 
         void add_soft_clauses(const std::vector<std::pair<uint64_t, Clause>> &soft_clauses);
+
+        // soft clause i has weight weights[i]
+        void add_soft_clauses(const std::vector<uint64_t> &weights, const ClauseArena &soft_clauses);
+        
+        // binary file with the input hard clauses and the objective functions (see snapshot.cpp)
+        void write_snapshot(const std::string &file_name) const;
+        
+        // loads the instance of a snapshot into a solver without clauses and objective functions
+        void read_snapshot(const std::string &file_name);
         
         void set_simplify_last(bool val);
         
@@ -112,6 +159,7 @@ namespace leximaxIST
         
         void set_opt_mode(const std::string &mode);
         
+        // the command is split into arguments at spaces and quotation marks, it is not run by a shell
         void set_ext_solver_cmd(const std::string &command);
         
         void set_formalism(const std::string &format);
@@ -122,11 +170,13 @@ namespace leximaxIST
         
         void set_leave_tmp_files(bool val);
         
+        void set_gzip_input(bool val);
+        
         void set_multiplication_string(const std::string &str);
         
         void set_maxsat_presolve(bool v);
         
-        void set_maxsat_psol_cmd(const std::string &cmd);
+        void set_maxsat_psol_cmd(const std::string &cmd); // split as in set_ext_solver_cmd
         
         void set_approx_tout(double t);
         
@@ -149,6 +199,19 @@ namespace leximaxIST
         void set_mss_tol(int t);
         
         void set_disjoint_cores(bool v);
+        
+        void set_half_comparators(bool v);
+        
+        void set_sorter(const std::string &sorter);
+        
+        // should be called before adding clauses; clauses already stored are dropped if not retained
+        void set_retention(const std::string &policy);
+        
+        // wall-clock time limit in seconds from now, for all subsequent calls to optimise() and approximate()
+        void set_deadline(double seconds);
+        
+        // limit of the memory in use (resident set size) in megabytes
+        void set_memory_budget(double megabytes);
                 
         int terminate(); // kill external solver and read approximate solution
         
@@ -160,11 +223,28 @@ namespace leximaxIST
         
         int fresh();
         
+        void new_objective();
+        
+        void add_soft_clause(uint64_t w, ClauseRef soft_clause);
+        
         void reset_file_name();
         
         void reset_id_count();
         
-        void update_id_count(const Clause &clause);
+        void update_id_count(ClauseRef clause);
+        
+        // exits with an error if the algorithm needs clauses that the retention policy does not keep
+        void check_retention(bool approx) const;
+        
+        // only the input and objective variables are extracted from the models of solver,
+        // which is interrupted at the deadline
+        void configure_sat_solver(IpasirWrap *solver);
+        
+        // throws DeadlineReached if the deadline or the memory budget has been reached
+        void check_deadline();
+        
+        // cleans up after optimise() or approximate() is stopped by the deadline or the memory budget
+        void interrupted();
         
         // update m_solution if the model is leximax-better than the current solution
         // e.g. in the case the external solver is killed and outputs a suboptimal solution
@@ -172,19 +252,38 @@ namespace leximaxIST
         // returns the objective vector of the leximax-best assignment
         // the model is moved to m_solution and then cleared
         // if the model is better and if verbode, the obj vec and the time is printed
-        // Returns the best objective vector of the two
-        std::vector<int> set_solution(std::vector<int> &model);
+        // Returns the best objective vector of the two (i.e. m_solution_obj_vec)
+        const std::vector<int>& set_solution(std::vector<int> &model);
+        
+        // recompute m_solution_obj_vec and m_solution_sorted
+        void update_solution_cache();
+        
+        // divide all objective weights by their gcd
+        void reduce_weights();
         
         // getters.cpp
         
         std::vector<int> get_objective_vector(const std::vector<int> &assignment) const;
         
+        // same as get_objective_vector(model) but without allocations; also sorts the objective vector
+        void evaluate(const std::vector<int> &model, std::vector<int> &obj_vec, std::vector<int> &sorted) const;
+        
+        int weight(int var) const; // weight of objective variable var, divided by the gcd
+        
+        int weight_sum(const std::vector<int> &lits) const;
+        
+        bool is_weighted(int i) const; // true if the ith objective has some weight different from 1
+        
+        uint64_t hard_weight() const; // weight of the hard clauses in the MaxSAT formula (larger than the weight of all soft clauses)
+        
         // constructors.cpp
         
-        void add_clause(const Clause &cl, std::vector<Clause> &set_of_clauses);
+        void add_clause(ClauseRef cl, ClauseArena &set_of_clauses);
         
         void add_clause_enc(const Clause &cl);
         
+        void encoding_clause_added();
+        
         void add_clause(int l);
         
         void add_clause(int l1, int l2);
@@ -193,23 +292,53 @@ namespace leximaxIST
         
         // sorting_net.cpp
         
-        void encode_max(int var_out_max, int var_in1, int var_in2);
+        void encode_max(int var_out_max, int var_in1, int var_in2, int polarity);
+        
+        void encode_min(int var_out_min, int var_in1, int var_in2, int polarity);
         
-        void encode_min(int var_out_min, int var_in1, int var_in2);
+        void insert_comparator(int el1, int el2, const std::vector<int> *objective, SNET &sorting_network, int polarity);
         
-        void insert_comparator(int el1, int el2, const std::vector<int> *objective, SNET &sorting_network);
+        int odd_even_merge(std::pair<std::pair<int,int>,int> seq1, std::pair<std::pair<int,int>,int> seq2, const std::vector<int> *objective, SNET &sorting_network, int polarity);
         
-        int odd_even_merge(std::pair<std::pair<int,int>,int> seq1, std::pair<std::pair<int,int>,int> seq2, const std::vector<int> *objective, SNET &sorting_network);
+        int encode_network(const std::pair<int,int> elems_to_sort, const std::vector<int> *objective, SNET &sorting_network, int polarity);
         
-        int encode_network(const std::pair<int,int> elems_to_sort, const std::vector<int> *objective, SNET &sorting_network);
+        int sort_run(const std::vector<int> &obj_vars, int sorter, int polarity, GTE_OUT &run);
+        
+        int merge_runs(const GTE_OUT &run1, const GTE_OUT &run2, int sorter, int polarity, GTE_OUT &merged);
         
         void merge_core_guided(const std::vector<std::vector<int>> &inputs_to_sort, const std::vector<std::vector<int>> &unit_core_vars);
         
+        std::pair<int,int> pairwise_comparator(int in1, int in2, int polarity, int &nb_comparators);
+        
+        std::vector<int> pairwise_merge(const std::vector<int> &larger, const std::vector<int> &smaller, int polarity, int &nb_comparators);
+        
+        std::vector<int> pairwise_sort(const std::vector<int> &wires, int polarity, int &nb_comparators);
+        
+        int encode_pairwise(const std::vector<int> &objective, std::vector<int> &outputs, int polarity);
+        
+        int encode_selection(const std::vector<int> &objective, int k, std::vector<int> &outputs, int polarity, int sorter);
+        
+        int gte_merge(const GTE_OUT &outputs1, const GTE_OUT &outputs2, GTE_OUT &outputs, int polarity, int max_sum);
+        
+        int encode_gte(const std::pair<int,int> elems_to_sort, const std::vector<int> &objective, GTE_OUT &outputs, int polarity, int max_sum);
+        
         //void delete_snet(SNET &sorting_network);
         
         // encoding.cpp
         
-        void encode_sorted(const std::vector<int> &inputs_to_sort, int i);
+        int comparator_polarity(int use) const;
+        
+        int objective_sorter(int i) const;
+        
+        void check_polarity(int use) const;
+        
+        void encode_sorted(const std::vector<int> &inputs_to_sort, int i, int polarity, int ub);
+        
+        int sorted_geq(int j, int value) const;
+        
+        void set_max_values();
+        
+        int incumbent_max() const;
         
         size_t largest_obj() const;
         
@@ -219,6 +348,8 @@ namespace leximaxIST
         
         void all_subsets(std::list<int> set, int i, Clause &clause);
         
+        int sequential_counter(const std::vector<int> &vars, int k);
+        
         void at_most(const std::list<int> &set, int i);
         
         void encode_relaxation(int i);
@@ -256,34 +387,55 @@ namespace leximaxIST
                      
         bool disjoint_cores(std::vector<std::vector<int>> &inputs_not_sorted,
                                  std::vector<std::vector<int>> &unit_core_vars,
-                                 std::vector<int> &lower_bounds, std::unordered_map<int, int> &lb_map);
+                                 std::vector<int> &lower_bounds, std::vector<CoreLB> &lb_map);
         
         void increase_lb(std::vector<int> &lower_bounds, const std::vector<int> &core,
                               const std::vector<std::vector<int>> &max_vars_vec) const;
                               
         void fix_max(int j, const std::vector<std::vector<int>> &max_vars_vec, const std::vector<int> &lower_bounds);
                                     
+        void index_core_vars(const std::vector<std::vector<int>> &inputs_not_sorted);
+        
+        const CoreVar& core_var(int var) const;
+                                    
         bool find_vars_in_core(std::vector<std::vector<int>> &inputs_not_sorted, const std::vector<int> &core,
-                                    std::vector<std::vector<int>> &new_inputs) const;
+                                    std::vector<std::vector<int>> &new_inputs);
                                     
-        void initialise_lb_map(std::unordered_map<int, int> &lb_map, int nb_objs) const;
-        
         void change_lb_map(int min_index, std::vector<int> &lower_bounds, const std::vector<int> &core,
-                      const std::vector<std::vector<int>> &max_vars_vec, std::unordered_map<int, int> &lb_map) const;
+                      std::vector<CoreLB> &lb_map) const;
+                      
+        void update_lb_map(int min_index, std::vector<int> &lower_bounds, const std::vector<uint64_t> &intersect,
+                           int core_weight, std::vector<CoreLB> &lb_map) const;
+                      
+        void seed_sum_cores(std::vector<std::vector<int>> &inputs_not_sorted, std::vector<std::vector<int>> &inputs_to_sort,
+                            std::vector<std::vector<int>> &unit_core_vars, std::vector<int> &lower_bounds,
+                            std::vector<CoreLB> &lb_map);
                       
         void add_unit_core_vars(const std::vector<std::vector<int>> &unit_core_vars, int j);
         
+        // alg_presolve_oll.cpp
+        
+        int oll_presolve();
+        
         // alg_opt_ilp.cpp
         
         void optimise_ilp();
         
-        int ilp_bound() const;
+        int ilp_bound(int j) const;
+        
+        std::vector<int> ilp_start(const std::vector<int> &max_vars, const std::vector<std::vector<int>> &relax_vars) const;
         
         // solver_call.cpp
         
-        void call_ilp_solver(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i);
+        void call_ilp_solver(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars,
+                             const std::vector<std::vector<int>> &relax_vars, int i);
         
-        void write_lp_file(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i) const;
+        void call_ilp_backend(ILPBackend &backend, const std::vector<ILPConstraint> &constraints, size_t &nb_sent,
+                              const std::vector<int> &max_vars, const std::vector<std::vector<int>> &relax_vars, int i);
+        
+        void write_lp_file(Writer &os, const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i) const;
+        
+        void write_mip_start(Writer &os, const std::vector<int> &values) const;
         
         bool call_sat_solver(IpasirWrap *solver, const std::vector<int> &assumps);
         
@@ -295,6 +447,8 @@ namespace leximaxIST
         
         void gia();
         
+        void gia_encode_snapshot(IpasirWrap &snapshot, int first_id, int ub);
+        
         int pareto_search(int &max_index, IpasirWrap *solver);
         
         void internal_solve(const int i, const int lb);
@@ -321,9 +475,19 @@ namespace leximaxIST
 
         void split_command(const std::string &command, std::vector<std::string> &command_split);
         
-        void call_ext_solver(const std::string &cmd);
+        void call_ext_solver(const std::string &command, const std::string &file_name, std::vector<char> *output);
+        
+        void open_instance_file(Writer &out, std::string &file_name);
         
-        void read_solver_output(std::vector<int> &model, const std::string &filename);
+        void end_instance_file(Writer &out, const std::string &file_name, double initial_time);
+        
+        void close_instance_file();
+        
+        void read_solver_output(std::vector<int> &model, const std::string &filename, bool sat_output);
+        
+        void read_solver_output(std::vector<int> &model, std::vector<char> &&output, bool sat_output);
+        
+        void read_solver_output(std::vector<int> &model, FileBuffer &r, bool sat_output);
         
         void external_solve(int i);
         
@@ -337,11 +501,11 @@ namespace leximaxIST
         
         void write_wcnf_file(int i);
         
-        void read_sat_output(std::vector<int> &model, bool &sat, StreamBuffer &r);
+        void read_sat_output(std::vector<int> &model, bool &sat, FileBuffer &r);
         
-        void read_cplex_output(std::vector<int> &model, bool &sat, StreamBuffer &r);
+        void read_cplex_output(std::vector<int> &model, bool &sat, FileBuffer &r);
         
-        void read_gurobi_output(std::vector<int> &model, bool &sat, StreamBuffer &r);
+        void read_gurobi_output(std::vector<int> &model, bool &sat, FileBuffer &r);
         /*
         int read_glpk_output(std::vector<int> &model);
         
@@ -354,9 +518,9 @@ namespace leximaxIST
         
         // printing.cpp
         
-        void print_hard_clauses(std::ostream &output) const;
+        void print_hard_clauses(Writer &output) const;
         
-        void print_soft_clauses(std::ostream &output) const;
+        void print_soft_clauses(Writer &output) const;
         
         void print_soft_clauses() const;
         
@@ -382,36 +546,22 @@ namespace leximaxIST
         
         void print_waitpid_error(const std::string &errno_str) const;
         
-        void print_clause(std::ostream &output, const Clause &cl, const std::string &leadingStr = "") const;
+        void print_clause(std::ostream &output, ClauseRef cl, const std::string &leadingStr = "") const;
         
 //         void print_wcnf_clauses(std::ostream &output, const std::vector<Clause*> &clauses, size_t weight) const;
         
 //         void print_atmost_lp(int i, std::ostream &output) const;
         
-        void print_lp_constraint(const Clause &cl, std::ostream &output) const;
+        void print_lp_constraint(ClauseRef cl, Writer &output) const;
         
 //         void print_sum_equals_lp(int i, std::ostream &output) const;
         
 //         void print_atmost_pb(int i, std::ostream &output) const;
         
-        void print_pb_constraint(const Clause &cl, std::ostream &output) const;
+        void print_pb_constraint(ClauseRef cl, Writer &output) const;
         
 //         void print_sum_equals_pb(int i, std::ostream &output) const;
         
-        /* Friend classes:
-         * openwbo PB encodings so that they can call fresh() to produce new variables
-         * I do not want fresh() to be public
-         */
-        
-        friend class SWC;
-        friend class Totalizer;
-        friend class MTotalizer;
-        friend class Adder;
-        friend class Ladder;
-        friend class KPA;
-        friend class CNetworks;
-        friend class GTE;
-        
     }; /* Solver class definition */
 
 } /* namespace leximaxIST */
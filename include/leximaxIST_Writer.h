@@ -0,0 +1,77 @@
+#ifndef LEXIMAXIST_WRITER
+#define LEXIMAXIST_WRITER
+#include <zlib.h>
+#include <charconv> // std::to_chars
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace leximaxIST {
+
+    /* Buffered output of the formulas given to the external solvers.
+     * Text and numbers (formatted with std::to_chars) are appended to a large buffer,
+     * which is written to the file, or compressed with gzip, when it is full.
+     * Errors are not reported until good() is checked (usually after close()).
+     */
+    class Writer {
+    public:
+        Writer();
+
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // truncates or creates the file
+        void open(const std::string &file_name, bool gzip);
+
+        // writes the buffer and closes the file
+        void close();
+
+        bool good() const { return m_good; }
+
+        // number of bytes written so far (before compression)
+        size_t nb_bytes() const { return m_nb_flushed + (m_pos - m_buffer.data()); }
+
+        Writer& operator<<(char c)
+        {
+            if (m_pos == m_end)
+                flush_buffer();
+            *m_pos++ = c;
+            return *this;
+        }
+
+        Writer& operator<<(const char *s) { write(s, strlen(s)); return *this; }
+
+        Writer& operator<<(const std::string &s) { write(s.data(), s.size()); return *this; }
+
+        template<typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+        Writer& operator<<(T value)
+        {
+            if (m_end - m_pos < max_digits)
+                flush_buffer();
+            m_pos = std::to_chars(m_pos, m_end, value).ptr;
+            return *this;
+        }
+
+        // raw bytes
+        void write(const char *data, size_t size);
+
+    private:
+        static constexpr size_t buffer_size = 1 << 20;
+        static constexpr int max_digits = 24; // enough for any 64-bit integer and its sign
+
+        void flush_buffer();
+
+        std::vector<char> m_buffer;
+        char *m_pos;
+        char *m_end;
+        int m_fd; // -1 if the file is compressed or closed
+        gzFile m_gz; // nullptr if the file is not compressed or closed
+        size_t m_nb_flushed;
+        bool m_good;
+    };
+
+}
+#endif /* LEXIMAXIST_WRITER */
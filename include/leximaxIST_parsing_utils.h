@@ -43,8 +43,17 @@
 #define SMALL_CHUNK_LIMIT 1024
 
 #include <zlib.h>
+#include <sys/mman.h> // mmap()
+#include <sys/stat.h> // fstat()
+#include <unistd.h> // close(), pread()
 #include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <cstring>
 #include <string>
+#include <vector>
+#include <utility>
 
 namespace leximaxIST {
 
@@ -52,21 +61,20 @@ namespace leximaxIST {
     protected:
     gzFile  in;
     char    *buf;
+    int     capacity;
     int     pos;
     int     size;
 
     void assureLookahead() {
         if (pos >= size) {
         pos  = 0;
-        size = gzread(in, buf, sizeof(buf)); } }
-
-    virtual void resize_buffer() { buf = new char[CHUNK_LIMIT]; }
+        size = gzread(in, buf, capacity); } }
 
     public:
-    StreamBuffer(gzFile i) : in(i), pos(0), size(0) {
-        resize_buffer(); assureLookahead(); }
+    StreamBuffer(gzFile i, int cap = CHUNK_LIMIT) : in(i), buf(new char[cap]), capacity(cap), pos(0), size(0) {
+        assureLookahead(); }
 
-    virtual ~StreamBuffer() { delete buf; }
+    virtual ~StreamBuffer() { delete[] buf; }
 
     int  operator *  () { return (pos >= size) ? EOF : buf[pos]; }
     void operator ++ () { pos++; assureLookahead(); }
@@ -74,13 +82,138 @@ namespace leximaxIST {
 
 
     class SmallStreamBuffer : public StreamBuffer {
+    public:
+    SmallStreamBuffer(gzFile i) : StreamBuffer(i, SMALL_CHUNK_LIMIT) { }
+    virtual ~SmallStreamBuffer() { }
+    };
+
+
+    /* Reads the whole file into memory: an uncompressed file is mapped, otherwise the file
+     * is read with CHUNK_LIMIT sized gzread calls (zlib reads uncompressed files transparently,
+     * so gzipped solver output also works).
+     * Characters are then accessed with pointer arithmetic, without a refill check,
+     * and integers are parsed 8 digits at a time.
+     * The buffer is padded with zeros so that 8 bytes can always be loaded from pos.
+     */
+    class FileBuffer {
     protected:
-    virtual void resize_buffer() { buf = new char[SMALL_CHUNK_LIMIT]; }
+    std::vector<char>   data;
+    const char          *start;
+    const char          *pos;
+    const char          *end;
+    size_t              mapped_size = 0; // the length of the mapping, 0 if the bytes are in data
+
+    // size_hint (e.g. the size of the file on disk) sizes the buffer up front
+    void read_all(gzFile in, size_t size_hint) {
+        gzbuffer(in, CHUNK_LIMIT);
+        data.resize(size_hint + CHUNK_LIMIT);
+        size_t nb_bytes (0);
+        int nb_read (0);
+        do {
+            if (data.size() < nb_bytes + CHUNK_LIMIT)
+                data.resize(2 * data.size() + CHUNK_LIMIT); // double to avoid copying the buffer at every chunk
+            nb_read = gzread(in, data.data() + nb_bytes, CHUNK_LIMIT);
+            if (nb_read > 0)
+                nb_bytes += nb_read;
+        } while (nb_read > 0);
+        data.resize(nb_bytes);
+        pad(); }
+
+    void pad() {
+        const size_t nb_bytes (data.size());
+        data.resize(nb_bytes + 8, 0);
+        start = pos = data.data();
+        end = pos + nb_bytes; }
 
     public:
-    SmallStreamBuffer(gzFile i) : StreamBuffer(i) { }
-    //virtual ~SmallStreamBuffer() { delete buf; }
-    virtual ~SmallStreamBuffer() { }
+    static int digit_count(uint64_t word) { // number of leading decimal digits in the 8 bytes
+        const uint64_t x (word ^ 0x3030303030303030ULL); // digits become 0..9
+        const uint64_t non_digits (((x + 0x7676767676767676ULL) | x) & 0x8080808080808080ULL);
+        return non_digits == 0 ? 8 : __builtin_ctzll(non_digits) / 8; }
+
+    static int digits_value(uint64_t word) { // word holds 8 digits, the first one in the lowest byte
+        word = ((word & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+        word = ((word & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+        return static_cast<int>(((word & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32); }
+
+    FileBuffer(gzFile in, size_t size_hint = 0) { read_all(in, size_hint); }
+
+    /* takes ownership of fd and maps the file if it is not gzipped
+     * the mapping is only used if the page of the last byte has room for the padding,
+     * since the kernel zero-fills the rest of that page
+     */
+    explicit FileBuffer(int fd) {
+        struct stat st;
+        const bool is_file (fstat(fd, &st) == 0 && S_ISREG(st.st_mode));
+        const size_t page (sysconf(_SC_PAGESIZE));
+        const size_t size (is_file ? st.st_size : 0);
+        unsigned char magic[2] = {0, 0};
+        if (is_file && size % page != 0 && size % page <= page - 8 && pread(fd, magic, 2, 0) == 2
+            && !(magic[0] == 0x1f && magic[1] == 0x8b)) {
+            void *addr (mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0));
+            if (addr != MAP_FAILED) {
+                close(fd);
+                mapped_size = size;
+                start = pos = static_cast<const char*>(addr);
+                end = pos + size;
+                return; }
+        }
+        gzFile in (gzdopen(fd, "rb"));
+        if (in == Z_NULL) {
+            close(fd);
+            pad();
+            return; }
+        read_all(in, size);
+        gzclose(in); }
+
+    // takes the bytes that were already read into memory (e.g. from a pipe)
+    FileBuffer(std::vector<char> &&bytes) : data(std::move(bytes)) { pad(); }
+
+    FileBuffer(const FileBuffer&) = delete;
+    FileBuffer& operator = (const FileBuffer&) = delete;
+
+    ~FileBuffer() {
+        if (mapped_size != 0)
+            munmap(const_cast<char*>(start), mapped_size); }
+
+    size_t nb_bytes() const { return end - start; }
+
+    int  operator *  () const { return (pos < end) ? *pos : EOF; }
+    void operator ++ () { pos++; }
+
+    void skip_whitespace() { // the padding is not whitespace, so there is no need to check for the end
+        while ((*pos >= 9 && *pos <= 13) || *pos == 32) ++pos; }
+
+    void skip_true_whitespace() {
+        while (*pos == ' ' || *pos == '\t') ++pos; }
+
+    void skip_line() {
+        const char *nl (static_cast<const char*>(memchr(pos, '\n', end - pos)));
+        pos = (nl == nullptr) ? end : nl + 1; }
+
+    int parse_int() {
+        int64_t val = 0;
+        bool   neg = false;
+        skip_whitespace();
+        if      (*pos == '-') neg = true, ++pos;
+        else if (*pos == '+') ++pos;
+        if (*pos < '0' || *pos > '9') fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *pos), exit(3);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint64_t word;
+        memcpy(&word, pos, 8);
+        const int n (digit_count(word));
+        if (n < 8) {
+            pos += n;
+            val = digits_value(word << (8 * (8 - n)));
+            return neg ? -static_cast<int>(val) : static_cast<int>(val); }
+        val = digits_value(word);
+        pos += 8;
+#endif
+        while (*pos >= '0' && *pos <= '9') {
+            val = val*10 + (*pos - '0');
+            ++pos;
+            if (val > INT_MAX) fprintf(stderr, "PARSE ERROR! Integer does not fit in an int\n"), exit(3); }
+        return neg ? -static_cast<int>(val) : static_cast<int>(val); }
     };
 
 
@@ -145,6 +278,14 @@ namespace leximaxIST {
             val = val*10 + (*in - '0'),
             ++in;
         return neg ? -val : val; }
+
+    inline void skipWhitespace(FileBuffer& in) { in.skip_whitespace(); }
+
+    inline void skipTrueWhitespace(FileBuffer& in) { in.skip_true_whitespace(); }
+
+    inline void skipLine(FileBuffer& in) { in.skip_line(); }
+
+    inline int parseInt(FileBuffer& in) { return in.parse_int(); }
 /*
     template<class B>
     static XLINT parseLongInt(B& in) {
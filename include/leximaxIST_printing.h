@@ -3,7 +3,7 @@
 #include <string>
 #include <iostream>
 #include <vector>
-#include <unordered_map>
+#include <leximaxIST_types.h>
 
 namespace leximaxIST {
     
@@ -13,7 +13,7 @@ namespace leximaxIST {
     
     std::string ordinal(int i);
     
-    void print_lb_map(const std::unordered_map<int, int> &lb_map);
+    void print_lb_map(const std::vector<CoreLB> &lb_map);
     
     void print_lower_bounds(const std::vector<int> &lower_bounds);
     
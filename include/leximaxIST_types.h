@@ -2,6 +2,7 @@
 #define LEXIMAXIST_TYPES
 #include <vector>
 #include <utility>
+#include <cstdint>
 
 namespace leximaxIST {
 
@@ -26,13 +27,43 @@ namespace leximaxIST {
     _INCREMENTAL_WEAKENING_,
     _INCREMENTAL_ITERATIVE_
     };
-    enum { _CARD_CNETWORKS_ = 0, _CARD_TOTALIZER_, _CARD_MTOTALIZER_ };
+    // _CARD_AUTO_ and _PB_AUTO_: choose the encoding of each constraint from the predicted sizes
+    enum { _CARD_CNETWORKS_ = 0, _CARD_TOTALIZER_, _CARD_MTOTALIZER_, _CARD_AUTO_ };
     enum { _AMO_LADDER_ = 0 };
-    enum { _PB_SWC_ = 0, _PB_GTE_, _PB_ADDER_, _PB_IGTE_, _PB_KP_, _PB_KP_MINISATP_};
+    enum { _PB_SWC_ = 0, _PB_GTE_, _PB_ADDER_, _PB_IGTE_, _PB_KP_, _PB_KP_MINISATP_, _PB_AUTO_ };
+    // encodings allowed in the automatic choice: the ones where unit propagation keeps generalized arc
+    // consistency, also the smaller ones (Adder, modulo totalizer) if the others are much larger, or all
+    enum { _ENC_POLICY_STRONG_ = 0, _ENC_POLICY_BALANCED_, _ENC_POLICY_SIZE_ };
     enum { _PART_SEQUENTIAL_ = 0, _PART_SEQUENTIAL_SORTED_, _PART_BINARY_ };
+    // clauses of a comparator: equivalence, inputs imply outputs (enough to bound the outputs from above),
+    // or outputs imply inputs (enough to bound the outputs from below)
+    enum { _POLARITY_FULL_ = 0, _POLARITY_UPWARD_, _POLARITY_DOWNWARD_ };
+    // encoding of the sorted vector of an objective (weighted objectives always use the generalized totalizer)
+    enum { _SORTER_ODD_EVEN_ = 0, _SORTER_TOTALIZER_, _SORTER_PAIRWISE_ };
     
     // sorting network and clauses:
     typedef std::vector<std::pair<int, int>> SNET;
+    // outputs of a generalized totalizer: pairs (sum, output variable) in increasing order of sum
+    typedef std::vector<std::pair<int, int>> GTE_OUT;
     typedef std::vector<int> Clause;
+    // variable of the core-guided search, so that a core can be processed in time linear in its size
+    struct CoreVar {
+        int obj; // objective of the variable, or maximum of a max variable (-1 if neither)
+        int pos; // position in inputs_not_sorted.at(obj), or in max_vars_vec.at(obj) for a max variable
+        bool in_network; // objective variable that is no longer in inputs_not_sorted
+        bool is_max;
+    };
+    // lower bound of the sum of a set of objectives, derived from the disjoint cores found so far
+    struct CoreLB {
+        std::vector<uint64_t> objs; // bit j % 64 of objs[j / 64] is set iff objective j is in the set
+        int weight; // total weight of the cores that intersect exactly the objectives of the set
+        int lb; // total weight of the cores that only intersect objectives of the set
+    };
+    // core found while minimising the sum of the objectives: the sum of the vars is at least weight more
+    // than the bound given by the previous cores (the variables of the totalizers in the core are replaced by their inputs)
+    struct SumCore {
+        std::vector<int> vars; // objective variables
+        int weight;
+    };
 }
 #endif /* LEXIMAXIST_TYPES */
@@ -0,0 +1,71 @@
+#include <leximaxIST_Deadline.h>
+#include <leximaxIST_types.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+
+namespace leximaxIST {
+
+    // current resident set size in kilobytes, or the peak RSS if /proc/self/statm can not be read
+    static long resident_kb()
+    {
+        long size (0), resident (0);
+        FILE *statm (fopen("/proc/self/statm", "r"));
+        if (statm != nullptr) {
+            const int nb_read (fscanf(statm, "%ld %ld", &size, &resident)); // in pages
+            fclose(statm);
+            if (nb_read == 2)
+                return resident * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru); // ru_maxrss is in kilobytes
+        return ru.ru_maxrss;
+    }
+
+    Deadline::Deadline() :
+    m_has_time(false),
+    m_memory_kb(0),
+    m_next_memory_check(),
+    m_polls(0),
+    m_reason(0)
+    {}
+
+    void Deadline::set_time(double seconds)
+    {
+        const auto duration (std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)));
+        m_end = std::chrono::steady_clock::now() + duration;
+        m_has_time = true;
+        m_reason = 0;
+    }
+
+    void Deadline::set_memory(double megabytes)
+    {
+        m_memory_kb = static_cast<long>(megabytes * 1024);
+        m_next_memory_check = std::chrono::steady_clock::time_point();
+        m_reason = 0;
+    }
+
+    void Deadline::interrupt(int reason) { m_reason = reason; }
+
+    bool Deadline::check()
+    {
+        if (m_reason != 0)
+            return true;
+        const std::chrono::steady_clock::time_point now (std::chrono::steady_clock::now());
+        if (m_has_time && now >= m_end)
+            m_reason = _UNKNOWN_;
+        else if (m_memory_kb > 0 && now >= m_next_memory_check) {
+            m_next_memory_check = now + memory_period;
+            if (resident_kb() > m_memory_kb)
+                m_reason = _MEMOUT_;
+        }
+        return m_reason != 0;
+    }
+
+    double Deadline::remaining() const
+    {
+        const std::chrono::duration<double> left (m_end - std::chrono::steady_clock::now());
+        return left.count() > 0 ? left.count() : 0;
+    }
+
+}
@@ -0,0 +1,112 @@
+#include <leximaxIST_ILPBackend.h>
+#include <leximaxIST_types.h>
+#include <leximaxIST_printing.h>
+#ifdef LEXIMAXIST_CBC
+#include <Cbc_C_Interface.h>
+#endif
+#include <cfloat> // DBL_MAX
+#include <cmath>
+#include <cstdlib>
+
+namespace leximaxIST {
+
+#ifdef LEXIMAXIST_CBC
+    // Cbc through its C interface
+    class CbcBackend : public ILPBackend {
+    public:
+        explicit CbcBackend(int verbosity) :
+        m_model(Cbc_newModel()),
+        m_objective(0)
+        {
+            Cbc_setParameter(m_model, "logLevel", verbosity >= 2 ? "1" : "0");
+            Cbc_setParameter(m_model, "threads", "1");
+        }
+
+        ~CbcBackend() override { Cbc_deleteModel(m_model); }
+
+        CbcBackend(const CbcBackend&) = delete;
+        CbcBackend& operator=(const CbcBackend&) = delete;
+
+        int nb_vars() const override { return Cbc_getNumCols(m_model); }
+
+        void add_var(bool binary) override
+        {
+            const std::string name ("x" + std::to_string(nb_vars() + 1));
+            Cbc_addCol(m_model, name.c_str(), 0.0, binary ? 1.0 : DBL_MAX, 0.0, 1, 0, nullptr, nullptr);
+        }
+
+        void add_constraint(const ILPConstraint &constraint) override
+        {
+            m_cols.clear();
+            m_coeffs.clear();
+            for (size_t j (0); j < constraint.m_vars.size(); ++j) {
+                m_cols.push_back(constraint.m_vars[j] - 1);
+                m_coeffs.push_back(constraint.m_coeffs[j]);
+            }
+            char sense ('E');
+            if (constraint.m_sign == "<=")
+                sense = 'L';
+            else if (constraint.m_sign == ">=")
+                sense = 'G';
+            Cbc_addRow(m_model, "", m_cols.size(), m_cols.data(), m_coeffs.data(), sense, constraint.m_rhs);
+        }
+
+        void minimise(int var) override
+        {
+            if (m_objective != 0)
+                Cbc_setObjCoeff(m_model, m_objective - 1, 0.0);
+            Cbc_setObjCoeff(m_model, var - 1, 1.0);
+            Cbc_setObjSense(m_model, 1.0);
+            m_objective = var;
+        }
+
+        void set_start(const std::vector<int> &values) override
+        {
+            m_cols.clear();
+            m_coeffs.clear();
+            for (int v (1); v < static_cast<int>(values.size()) && v <= nb_vars(); ++v) {
+                m_cols.push_back(v - 1);
+                m_coeffs.push_back(values[v]);
+            }
+            Cbc_setMIPStartI(m_model, m_cols.size(), m_cols.data(), m_coeffs.data());
+        }
+
+        int solve(double time_limit, std::vector<int> &values) override
+        {
+            if (time_limit > 0)
+                Cbc_setMaximumSeconds(m_model, time_limit);
+            Cbc_solve(m_model);
+            if (Cbc_isProvenInfeasible(m_model))
+                return _UNSATISFIABLE_;
+            const double *solution (Cbc_bestSolution(m_model));
+            if (solution == nullptr)
+                return _UNKNOWN_;
+            const int n (nb_vars());
+            values.assign(n + 1, 0);
+            for (int v (1); v <= n; ++v)
+                values[v] = static_cast<int>(std::lround(solution[v - 1]));
+            return Cbc_isProvenOptimal(m_model) ? _OPTIMUM_ : _SATISFIABLE_;
+        }
+
+    private:
+        Cbc_Model *m_model;
+        int m_objective; // variable that is minimised (0 if none)
+        std::vector<int> m_cols; // buffers
+        std::vector<double> m_coeffs;
+    };
+#endif
+
+    ILPBackend* new_ilp_backend(const std::string &name, int verbosity)
+    {
+        if (name != "cbc")
+            return nullptr;
+#ifdef LEXIMAXIST_CBC
+        return new CbcBackend(verbosity);
+#else
+        (void) verbosity;
+        print_error_msg("leximaxIST was compiled without the ILP solver Cbc (compile with 'make CBC=1')");
+        exit(EXIT_FAILURE);
+#endif
+    }
+
+}
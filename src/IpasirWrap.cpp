@@ -1,20 +1,65 @@
 #include <leximaxIST_printing.h>
 #include <leximaxIST_rusage.h>
 #include <IpasirWrap.h>
+#include <leximaxIST_Deadline.h>
+#ifdef LEXIMAXIST_CADICAL
+#include <cadical.hpp>
+#else
 #include <ipasir.h>
+#endif
 #include <cstdlib>
 #include <cmath>
 #include <iostream>
+#include <limits>
 
 namespace leximaxIST {
     
+    int terminate(void *time_params);
+    
+#ifdef LEXIMAXIST_CADICAL
+    // the same timeout as the IPASIR terminate callback
+    class TimeoutTerminator : public CaDiCaL::Terminator {
+    public:
+        explicit TimeoutTerminator(IpasirWrap::TimeParams *time_params) : m_time_params(time_params) {}
+        bool terminate() override { return leximaxIST::terminate(m_time_params) != 0; }
+    private:
+        IpasirWrap::TimeParams *m_time_params;
+    };
+    
+    CaDiCaL::Solver* cadical(void *s) { return static_cast<CaDiCaL::Solver*>(s); }
+#endif
+    
     IpasirWrap::IpasirWrap() :
-    _nvars(0)
+    _nvars(0),
+    _model_vars(0),
+    _snapshot(false),
+    _terminator(nullptr)
     {
+        _time_params.m_timeout = std::numeric_limits<double>::max();
+        _time_params.m_init_time = 0;
+        _time_params.m_deadline = nullptr;
+#ifdef LEXIMAXIST_CADICAL
+        _s = new CaDiCaL::Solver();
+#else
         _s = ipasir_init();  
+#endif
     }
     
-    IpasirWrap::~IpasirWrap() { ipasir_release(_s); }
+    IpasirWrap::IpasirWrap(bool snapshot) :
+    IpasirWrap()
+    {
+        _snapshot = snapshot;
+    }
+    
+    IpasirWrap::~IpasirWrap()
+    {
+#ifdef LEXIMAXIST_CADICAL
+        delete cadical(_s);
+        delete static_cast<TimeoutTerminator*>(_terminator);
+#else
+        ipasir_release(_s);
+#endif
+    }
     
     // From the ipasir.h file:
     /**
@@ -25,10 +70,14 @@ namespace leximaxIST {
     */
     int terminate(void *time_params)
     {
+        IpasirWrap::TimeParams *params (static_cast<IpasirWrap::TimeParams*>(time_params));
+        if (params->m_deadline != nullptr && params->m_deadline->poll())
+            return 1;
         // if cpu time is greater than timeout, return 1, otherwise return 0
-        double init_time (static_cast<IpasirWrap::TimeParams*>(time_params)->m_init_time);
-        double timeout (static_cast<IpasirWrap::TimeParams*>(time_params)->m_timeout);
-        if (read_cpu_time() - init_time > timeout)
+        // (the cpu time is only read if there is a timeout)
+        if (params->m_timeout == std::numeric_limits<double>::max())
+            return 0;
+        if (read_cpu_time() - params->m_init_time > params->m_timeout)
             return 1;
         else
             return 0;
@@ -46,7 +95,44 @@ namespace leximaxIST {
         }
         _time_params.m_timeout = timeout;
         _time_params.m_init_time = init_time;
+        connect_terminate();
+    }
+    
+    void IpasirWrap::set_deadline(Deadline *deadline)
+    {
+        _time_params.m_deadline = deadline;
+        connect_terminate();
+    }
+    
+    void IpasirWrap::connect_terminate()
+    {
+#ifdef LEXIMAXIST_CADICAL
+        if (_terminator == nullptr) {
+            _terminator = new TimeoutTerminator(&_time_params);
+            cadical(_s)->connect_terminator(static_cast<TimeoutTerminator*>(_terminator));
+        }
+#else
         ipasir_set_terminate (_s, &_time_params, terminate);
+#endif
+    }
+    
+    void IpasirWrap::copy_to(IpasirWrap &other) const
+    {
+        if (!_snapshot) {
+            print_error_msg("IpasirWrap::copy_to called on a solver that is not a snapshot!");
+            exit(EXIT_FAILURE);
+        }
+#ifdef LEXIMAXIST_CADICAL
+        cadical(_s)->copy(*cadical(other._s));
+#else
+        for (int lit : _clauses)
+            ipasir_add(other._s, lit);
+#endif
+        if (other._nvars < _nvars)
+            other._nvars = _nvars;
+        other._model_vars = _model_vars;
+        if (_time_params.m_deadline != nullptr)
+            other.set_deadline(_time_params.m_deadline);
     }
     
     void IpasirWrap::addClauses(const std::vector<Clause> &cls)
@@ -55,7 +141,13 @@ namespace leximaxIST {
             addClause(cl);
     }
     
-    void IpasirWrap::addClause(const Clause &clause)  {
+    void IpasirWrap::addClauses(const ClauseArena &cls)
+    {
+        for (const ClauseRef cl : cls)
+            addClause(cl);
+    }
+    
+    void IpasirWrap::addClause(ClauseRef clause)  {
         for (int literal : clause)
             add(literal);
         f();
@@ -76,6 +168,19 @@ namespace leximaxIST {
     // return a non-const reference to be able to steal _model's data with move semantics
     std::vector<int>& IpasirWrap::model() {return _model; }
     
+    void IpasirWrap::set_model_vars(int nb_vars) { _model_vars = nb_vars; }
+    
+    int IpasirWrap::val(int v)
+    {
+        if (v < (int) _model.size())
+            return _model[v];
+#ifdef LEXIMAXIST_CADICAL
+        return cadical(_s)->val(v);
+#else
+        return ipasir_val(_s, v);
+#endif
+    }
+    
     const std::vector<int>& IpasirWrap::conflict() const { return _conflict; }
 
     int IpasirWrap::nVars() const {return _nvars;}
@@ -86,10 +191,23 @@ namespace leximaxIST {
     }
 
     int IpasirWrap::solve(const std::vector<int>& assumps) {
+        // the terminate callback may not be called in short SAT calls
+        if (_time_params.m_deadline != nullptr && _time_params.m_deadline->check()) {
+            _model.clear();
+            _conflict.clear();
+            return 0;
+        }
+#ifdef LEXIMAXIST_CADICAL
+        CaDiCaL::Solver *s (cadical(_s));
+        for (auto l : assumps)
+            s->assume(l);
+        const int r = s->solve();
+#else
         for (auto l : assumps)
             ipasir_assume(_s, l);
 
         const int r = ipasir_solve(_s);
+#endif
         if (r != 10 && r != 20 && r != 0) {
             print_error_msg("Something went wrong with ipasir_solve call, retv: " + r);
             exit(EXIT_FAILURE);
@@ -97,13 +215,23 @@ namespace leximaxIST {
         _model.clear();
         _conflict.clear();
         if (r == 10) {
-            _model.resize(_nvars + 1, 0);
-            for (int v = _nvars; v; v--) {
+            // the encoding variables are not extracted if _model_vars is set
+            const int nvars ((_model_vars > 0 && _model_vars < _nvars) ? _model_vars : _nvars);
+            _model.resize(nvars + 1, 0);
+            for (int v = nvars; v; v--) {
+#ifdef LEXIMAXIST_CADICAL
+            _model[v] = s->val(v);
+#else
             _model[v] = ipasir_val(_s, v);
+#endif
             }
         } else if (r == 20) {
             for (auto l : assumps) {
+#ifdef LEXIMAXIST_CADICAL
+                if (s->failed(l))
+#else
                 if (ipasir_failed(_s, l))
+#endif
                     _conflict.push_back(-l);
             }
         }
@@ -113,11 +241,23 @@ namespace leximaxIST {
     void IpasirWrap::add(int p) {
          if (std::abs(p) > _nvars)
              _nvars = std::abs(p);
+#ifdef LEXIMAXIST_CADICAL
+        cadical(_s)->add(p);
+#else
+        if (_snapshot)
+            _clauses.push_back(p);
         ipasir_add(_s, p);
+#endif
     }
 
     void IpasirWrap::f() {
+#ifdef LEXIMAXIST_CADICAL
+        cadical(_s)->add(0);
+#else
+        if (_snapshot)
+            _clauses.push_back(0);
         ipasir_add(_s, 0);
+#endif
     }
 
 }
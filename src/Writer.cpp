@@ -0,0 +1,94 @@
+#include <leximaxIST_Writer.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+
+namespace leximaxIST {
+
+    Writer::Writer() :
+    m_buffer(buffer_size),
+    m_pos(m_buffer.data()),
+    m_end(m_buffer.data() + m_buffer.size()),
+    m_fd(-1),
+    m_gz(nullptr),
+    m_nb_flushed(0),
+    m_good(false)
+    {}
+
+    Writer::~Writer() { close(); }
+
+    void Writer::open(const std::string &file_name, bool gzip)
+    {
+        close();
+        m_pos = m_buffer.data();
+        m_nb_flushed = 0;
+        m_fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        m_good = m_fd != -1;
+        if (m_good && gzip) {
+            m_gz = gzdopen(m_fd, "wb1"); // fast compression, the file is only read once
+            if (m_gz == nullptr) {
+                ::close(m_fd);
+                m_good = false;
+            }
+            m_fd = -1; // owned by m_gz
+        }
+    }
+
+    void Writer::close()
+    {
+        if (m_fd == -1 && m_gz == nullptr)
+            return;
+        flush_buffer();
+        if (m_gz != nullptr) {
+            if (gzclose(m_gz) != Z_OK)
+                m_good = false;
+            m_gz = nullptr;
+        }
+        else {
+            if (::close(m_fd) != 0)
+                m_good = false;
+            m_fd = -1;
+        }
+    }
+
+    void Writer::write(const char *data, size_t size)
+    {
+        while (size > 0) {
+            if (m_pos == m_end)
+                flush_buffer();
+            const size_t n (std::min(size, static_cast<size_t>(m_end - m_pos)));
+            memcpy(m_pos, data, n);
+            m_pos += n;
+            data += n;
+            size -= n;
+        }
+    }
+
+    void Writer::flush_buffer()
+    {
+        const char *data (m_buffer.data());
+        size_t size (m_pos - data);
+        m_nb_flushed += size;
+        m_pos = m_buffer.data();
+        if (!m_good)
+            return; // the data is dropped, the error is reported by good()
+        if (m_gz != nullptr) {
+            if (size > 0 && gzwrite(m_gz, data, size) != static_cast<int>(size))
+                m_good = false;
+            return;
+        }
+        while (size > 0) {
+            const ssize_t n (::write(m_fd, data, size));
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                m_good = false;
+                return;
+            }
+            data += n;
+            size -= n;
+        }
+    }
+
+}
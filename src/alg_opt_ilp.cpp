@@ -1,5 +1,6 @@
 #include <leximaxIST_Solver.h>
 #include <leximaxIST_ILPConstraint.h>
+#include <leximaxIST_ILPBackend.h>
 #include <leximaxIST_rusage.h>
 #include <leximaxIST_printing.h>
 #include <string>
@@ -10,6 +11,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <algorithm>
+#include <numeric> // std::iota
+#include <memory> // std::unique_ptr
 
 namespace leximaxIST {
     
@@ -18,9 +21,11 @@ namespace leximaxIST {
     void Solver::optimise_ilp()
     {
         std::vector<ILPConstraint> constraints;
-        // first copy the hard clauses to constraints
-        assert(m_encoding.empty());
-        for (const Clause &cl : m_input_hard) {
+        /* first copy the hard clauses to constraints
+         * the model only has the input hard clauses: m_encoding may have the totalizers of the MaxSAT presolve,
+         * which only define fresh variables (the outputs of the cores), so the ILP solver does not need them
+         */
+        for (const ClauseRef cl : m_input_hard) {
             int rhs (1);
             std::string sign (">=");
             std::vector<int> vars;
@@ -40,8 +45,12 @@ namespace leximaxIST {
             ILPConstraint ilpc (vars, coeffs, sign, rhs);
             constraints.push_back(ilpc);
         }        
-        // next, iteratively solve single-objective by calling gurobi external executable
+        // next, iteratively solve single-objective by calling the ILP solver
         // the constraints are added in each iteration
+        // an in-process ILP solver keeps its model, so only the new constraints are given to it
+        std::unique_ptr<ILPBackend> backend (new_ilp_backend(m_ilp_solver, m_verbosity));
+        size_t nb_sent (0); // number of constraints in the model of the backend
+        std::vector<std::vector<int>> all_relax_vars; // relaxation variables of each iteration
         std::vector<int> max_vars;
         for (int i (0); i < m_num_objectives; ++i) {
             if (m_verbosity >= 1)
@@ -55,11 +64,15 @@ namespace leximaxIST {
             }
             // relaxation variables
             std::vector<int> relax_vars;
-            int bound (0);
+            std::vector<int> bounds; // coefficient of the relaxation variable of each objective
             if (i > 0) {
-                bound = ilp_bound();
+                for (int j (0); j < m_num_objectives; ++j)
+                    bounds.push_back(ilp_bound(j));
                 if (m_verbosity >= 2) {
-                    std::cout << "c Relax Bound: " << bound << '\n';
+                    std::cout << "c Relax Bounds: ";
+                    for (int b : bounds)
+                        std::cout << b << ' ';
+                    std::cout << '\n';
                     std::cout << "c Relaxation variables: ";
                 }
                 for (int j (0); j < m_num_objectives; ++j) {
@@ -70,6 +83,7 @@ namespace leximaxIST {
                 if (m_verbosity >= 2)
                     std::cout << '\n';
             }
+            all_relax_vars.push_back(relax_vars);
             // add bound constraints
             for (int j (0); j < m_num_objectives; ++j) {
                 std::vector<int> constr_vars;
@@ -79,7 +93,7 @@ namespace leximaxIST {
                 // add jth objective function variables
                 for (int v : m_objectives.at(j)) {
                     constr_vars.push_back(v);
-                    coeffs.push_back(1);
+                    coeffs.push_back(weight(v));
                 }
                 // add ith maximum integer var
                 constr_vars.push_back(max_i);
@@ -87,7 +101,7 @@ namespace leximaxIST {
                 // add relaxation term if i > 0
                 if (i > 0) {
                     constr_vars.push_back(relax_vars.at(j));
-                    coeffs.push_back(-bound);
+                    coeffs.push_back(-bounds.at(j));
                 }
                 ILPConstraint ilpc (constr_vars, coeffs, sign, rhs);
                 constraints.push_back(ilpc);
@@ -107,29 +121,54 @@ namespace leximaxIST {
                 ILPConstraint ilpc (vars, coeffs, sign, rhs);
                 constraints.push_back(ilpc);
             }
-            call_ilp_solver(constraints, max_vars, i);
+            if (backend)
+                call_ilp_backend(*backend, constraints, nb_sent, max_vars, all_relax_vars, i);
+            else
+                call_ilp_solver(constraints, max_vars, all_relax_vars, i);
             // fix ith maximum (add to constraints)
             std::vector<int> vars {max_i};
             std::vector<int> coeffs {1};
             const std::string sign ("=");
-            std::vector<int> obj_vec (get_objective_vector());
-            if (obj_vec.empty())
+            if (m_solution_sorted.empty())
                 return;
-            std::sort(obj_vec.begin(), obj_vec.end(), descending_order);
-            const int rhs (obj_vec.at(i));
+            const int rhs (m_solution_sorted.at(i));
             ILPConstraint ilpc (vars, coeffs, sign, rhs);
             constraints.push_back(ilpc);
         }
     }
     
-    /* returns the bound used in the relaxation of the constraints
-     * at the moment it simply is an upper bound on the value of the 1st maximum
-     * it may be possible to improve the bound, e.g. by using lower bounds on the sum of the objectives
+    /* returns the bound used in the relaxation of the constraint of the jth objective
+     * the relaxation variable must allow the objective to exceed the ith maximum (which is at least 0)
+     * by as much as the objective can take: at most the 1st maximum, which is fixed after the 1st iteration,
+     * and at most the sum of the weights of the objective
+     * smaller coefficients give a tighter LP relaxation
      */
-    int Solver::ilp_bound() const
+    int Solver::ilp_bound(int j) const
     {
-        const std::vector<int> obj_vec (get_objective_vector());
-        return *std::max_element(obj_vec.begin(), obj_vec.end());
+        return std::min(m_solution_sorted.front(), weight_sum(m_objectives.at(j)));
+    }
+    
+    /* values of the variables of the ilp algorithm in the incumbent solution (used as a MIP start):
+     * the input variables are as in m_solution, the kth maximum is the kth largest objective value
+     * and the relaxation variables of the kth iteration relax the k largest objectives
+     */
+    std::vector<int> Solver::ilp_start(const std::vector<int> &max_vars, const std::vector<std::vector<int>> &relax_vars) const
+    {
+        std::vector<int> values (m_id_count + 1, 0);
+        for (int v (1); v <= m_input_nb_vars; ++v)
+            values[v] = m_solution.at(v) > 0 ? 1 : 0;
+        // objectives by decreasing value
+        std::vector<int> order (m_num_objectives);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+            [this](int j1, int j2) { return m_solution_obj_vec.at(j1) > m_solution_obj_vec.at(j2); });
+        for (size_t k (0); k < max_vars.size(); ++k)
+            values.at(max_vars[k]) = m_solution_sorted.at(k);
+        for (size_t k (0); k < relax_vars.size(); ++k) {
+            for (size_t t (0); t < relax_vars[k].size() && t < k; ++t)
+                values.at(relax_vars[k].at(order[t])) = 1;
+        }
+        return values;
     }
 
 } /* namespace leximaxIST */
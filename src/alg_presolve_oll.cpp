@@ -0,0 +1,98 @@
+#include <leximaxIST_Solver.h>
+#include <leximaxIST_types.h>
+#include <leximaxIST_printing.h>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+
+namespace leximaxIST {
+
+    /* Minimises the sum of the objective functions with the core-guided OLL algorithm in m_sat_solver.
+     * The soft literals are the negations of the objective variables, with their weights.
+     * For each core of weight w (the minimum weight of its literals) the lower bound of the sum increases by w,
+     * which is subtracted from the weights of the literals of the core. If the core has more than one literal,
+     * a totalizer (pairwise sorting network with the clauses from the inputs to the outputs) counts them:
+     * the negation of the output "at least 2" is a new soft literal of weight w, and the output "at least k + 1"
+     * is added when the output "at least k" is in a core.
+     * The cores are kept in m_sum_cores and each model found updates m_solution.
+     * Returns the minimum value of the sum of the objective functions.
+     */
+    int Solver::oll_presolve()
+    {
+        m_sum_cores.clear();
+        std::vector<int> weights (m_id_count + 1, 0); // weight of the soft literal -v, indexed by v
+        for (const std::vector<int> &obj : m_objectives) {
+            for (int v : obj)
+                weights.at(v) += weight(v);
+        }
+        // for each totalizer: the outputs (outputs.at(k) is true if at least k + 1 inputs are true),
+        // its weight, the objective variables of its inputs and the next output to become soft
+        std::vector<std::vector<int>> tot_outputs;
+        std::vector<int> tot_weights;
+        std::vector<std::vector<int>> tot_vars;
+        std::vector<size_t> tot_next;
+        std::vector<std::pair<int, int>> output_pos (m_id_count + 1, {-1, -1}); // totalizer and position of each output
+        int lb (0);
+        std::vector<int> assumps;
+        while (true) {
+            assumps.clear();
+            for (size_t v (1); v < weights.size(); ++v) {
+                if (weights[v] > 0)
+                    assumps.push_back(-static_cast<int>(v));
+            }
+            if (call_sat_solver(m_sat_solver, assumps))
+                break;
+            const std::vector<int> core (m_sat_solver->conflict());
+            if (core.empty()) // the hard clauses are satisfiable, so it does not happen
+                break;
+            SumCore sum_core;
+            sum_core.weight = 0;
+            for (int l : core) {
+                if (sum_core.weight == 0 || weights.at(l) < sum_core.weight)
+                    sum_core.weight = weights.at(l);
+            }
+            lb += sum_core.weight;
+            for (int l : core) {
+                weights.at(l) -= sum_core.weight;
+                const int t (output_pos.at(l).first);
+                if (t == -1) { // objective variable
+                    sum_core.vars.push_back(l);
+                    continue;
+                }
+                const std::vector<int> &outputs (tot_outputs.at(t));
+                sum_core.vars.insert(sum_core.vars.end(), tot_vars.at(t).begin(), tot_vars.at(t).end());
+                if (output_pos.at(l).second + 1 == static_cast<int>(tot_next.at(t)) && tot_next.at(t) < outputs.size()) {
+                    weights.at(outputs.at(tot_next.at(t))) += tot_weights.at(t);
+                    ++tot_next.at(t);
+                }
+            }
+            std::sort(sum_core.vars.begin(), sum_core.vars.end());
+            sum_core.vars.erase(std::unique(sum_core.vars.begin(), sum_core.vars.end()), sum_core.vars.end());
+            if (m_verbosity >= 1) {
+                std::cout << "c Core size: " << core.size() << " (" << sum_core.vars.size() << " objective variables)";
+                std::cout << ", weight: " << sum_core.weight << ", lower bound of the sum: " << lb << '\n';
+            }
+            if (core.size() > 1) {
+                std::vector<int> outputs;
+                encode_pairwise(core, outputs, _POLARITY_UPWARD_);
+                std::reverse(outputs.begin(), outputs.end()); // outputs.at(k) is "at least k + 1"
+                weights.resize(m_id_count + 1, 0);
+                output_pos.resize(m_id_count + 1, {-1, -1});
+                const int t (tot_outputs.size());
+                for (size_t k (0); k < outputs.size(); ++k)
+                    output_pos.at(outputs.at(k)) = std::make_pair(t, static_cast<int>(k));
+                weights.at(outputs.at(1)) += sum_core.weight;
+                tot_outputs.push_back(outputs);
+                tot_weights.push_back(sum_core.weight);
+                tot_vars.push_back(sum_core.vars);
+                tot_next.push_back(2);
+            }
+            m_sum_cores.push_back(sum_core);
+        }
+        if (m_verbosity >= 1)
+            std::cout << "c Number of cores of the sum: " << m_sum_cores.size() << '\n';
+        return lb;
+    }
+
+}/* namespace leximaxIST */
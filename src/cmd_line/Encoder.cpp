@@ -30,6 +30,8 @@
 #include <stdlib.h>
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <utility>
 
 using namespace leximaxIST;
 
@@ -38,7 +40,7 @@ using namespace leximaxIST;
  // Encoding of exactly-one constraints
  //
  ************************************************************************************************/
-void Encoder::encodeAMO(leximaxIST::Solver &solver, std::vector<Lit> &lits) {
+void Encoder::encodeAMO(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &lits) {
 
   switch (amo_encoding) {
   // Currently only the ladder encoding is used for AMO constraints.
@@ -59,7 +61,7 @@ void Encoder::encodeAMO(leximaxIST::Solver &solver, std::vector<Lit> &lits) {
  ************************************************************************************************/
 //
 // Manages the encoding of cardinality encodings.
-void Encoder::encodeCardinality(leximaxIST::Solver &solver, std::vector<Lit> &lits, int64_t rhs) {
+void Encoder::encodeCardinality(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &lits, int64_t rhs) {
 
   switch (cardinality_encoding) {
   case _CARD_TOTALIZER_:
@@ -82,7 +84,7 @@ void Encoder::encodeCardinality(leximaxIST::Solver &solver, std::vector<Lit> &li
   }
 }
 
-void Encoder::addCardinality(leximaxIST::Solver &solver, Encoder &enc, int64_t rhs) {
+void Encoder::addCardinality(leximaxIST::ClauseBuffer &solver, Encoder &enc, int64_t rhs) {
   if (cardinality_encoding == _CARD_TOTALIZER_ &&
       enc.cardinality_encoding == _CARD_TOTALIZER_) {
     totalizer.add(solver, enc.totalizer, rhs);
@@ -93,7 +95,7 @@ void Encoder::addCardinality(leximaxIST::Solver &solver, Encoder &enc, int64_t r
 }
 
 // Manages the update of cardinality constraints.
-void Encoder::updateCardinality(leximaxIST::Solver &solver, int64_t rhs) {
+void Encoder::updateCardinality(leximaxIST::ClauseBuffer &solver, int64_t rhs) {
 
   switch (cardinality_encoding) {
   case _CARD_TOTALIZER_:
@@ -118,7 +120,7 @@ void Encoder::updateCardinality(leximaxIST::Solver &solver, int64_t rhs) {
 //
 // Manages the building of cardinality encodings.
 // Currently is only used for incremental solving.
-void Encoder::buildCardinality(leximaxIST::Solver &solver, const std::vector<Lit> &lits, int64_t rhs) {
+void Encoder::buildCardinality(leximaxIST::ClauseBuffer &solver, const std::vector<Lit> &lits, int64_t rhs) {
   assert(incremental_strategy != _INCREMENTAL_NONE_);
 
   switch (cardinality_encoding) {
@@ -133,7 +135,7 @@ void Encoder::buildCardinality(leximaxIST::Solver &solver, const std::vector<Lit
 }
 
 // Manages the incremental update of cardinality constraints.
-void Encoder::incUpdateCardinality(leximaxIST::Solver &solver, const std::vector<Lit> &join, const std::vector<Lit> &lits,
+void Encoder::incUpdateCardinality(leximaxIST::ClauseBuffer &solver, const std::vector<Lit> &join, const std::vector<Lit> &lits,
                                    int64_t rhs, std::vector<Lit> &assumptions) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_ ||
          incremental_strategy == _INCREMENTAL_WEAKENING_);
@@ -154,7 +156,7 @@ void Encoder::incUpdateCardinality(leximaxIST::Solver &solver, const std::vector
   }
 }
 
-void Encoder::joinEncoding(leximaxIST::Solver &solver, const std::vector<Lit> &lits, int64_t rhs) {
+void Encoder::joinEncoding(leximaxIST::ClauseBuffer &solver, const std::vector<Lit> &lits, int64_t rhs) {
 
   switch (cardinality_encoding) {
   case _CARD_TOTALIZER_:
@@ -174,7 +176,7 @@ void Encoder::joinEncoding(leximaxIST::Solver &solver, const std::vector<Lit> &l
  ************************************************************************************************/
 //
 // Manages the encoding of PB encodings.
-void Encoder::encodePB(leximaxIST::Solver &solver, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+void Encoder::encodePB(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
                        uint64_t rhs) {
     
 //   printf("c [Encoder:encodePB] encoding: %d\n", pb_encoding);
@@ -211,22 +213,106 @@ void Encoder::encodePB(leximaxIST::Solver &solver, std::vector<Lit> &lits, std::
   }
 }
 
-int Encoder::predictPB(leximaxIST::Solver &solver, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
-                       uint64_t rhs) {
+namespace {
+
+// Size of the encoding of a constraint, obtained by encoding it into a buffer
+// that only counts the clauses. Returns limit + 1 if there are more than limit.
+template <typename Encode> int countClauses(Encode encode, int *nVars, int limit) {
+  ClauseBuffer counter(ClauseBuffer::counter(limit));
+  try {
+    encode(counter);
+  } catch (const ClauseLimitReached &) {
+    *nVars = counter.nb_fresh();
+    return limit + 1;
+  }
+  *nVars = counter.nb_fresh();
+  return counter.nb_clauses();
+}
+
+// With _ENC_POLICY_BALANCED_, an encoding that does not keep arc consistency is
+// only chosen if the other ones are predicted to have this many times more
+// clauses.
+const int balancedFactor = 4;
+
+// Chooses the encoding of a constraint among the weak encodings (that do not
+// keep arc consistency) and the strong ones, in this order for ties.
+// predict(enc, limit, &nVars) is the number of clauses, or limit + 1.
+template <typename Predict>
+int chooseEncoding(const std::vector<int> &weak, const std::vector<int> &strong, int policy,
+                   int fallback, Predict predict) {
+  // (clauses, variables) of the best encodings so far
+  std::pair<int, int> weakSize(max_clauses + 1, 0);
+  std::pair<int, int> strongSize(max_clauses + 1, 0);
+  int bestWeak = -1;
+  int bestStrong = -1;
+  if (policy != _ENC_POLICY_STRONG_) {
+    for (int enc : weak) {
+      const int limit = std::min(weakSize.first, max_clauses);
+      int nVars = 0;
+      const int nClauses = predict(enc, limit, &nVars);
+      if (nClauses <= limit && std::make_pair(nClauses, nVars) < weakSize) {
+        weakSize = std::make_pair(nClauses, nVars);
+        bestWeak = enc;
+      }
+    }
+  }
+  // the strong encodings are not predicted beyond the size where they lose
+  int strongLimit = max_clauses;
+  if (bestWeak != -1 && policy == _ENC_POLICY_SIZE_)
+    strongLimit = weakSize.first;
+  else if (bestWeak != -1 && policy == _ENC_POLICY_BALANCED_)
+    strongLimit = std::min(balancedFactor * weakSize.first, max_clauses);
+  for (int enc : strong) {
+    const int limit = std::min(strongSize.first, strongLimit);
+    int nVars = 0;
+    const int nClauses = predict(enc, limit, &nVars);
+    if (nClauses <= limit && std::make_pair(nClauses, nVars) < strongSize) {
+      strongSize = std::make_pair(nClauses, nVars);
+      bestStrong = enc;
+    }
+  }
+
+  if (bestStrong != -1 &&
+      (bestWeak == -1 || policy != _ENC_POLICY_SIZE_ || strongSize <= weakSize))
+    return bestStrong;
+  if (bestWeak != -1)
+    return bestWeak;
+  return fallback;
+}
+
+} // namespace
+
+// Predicts the size of the PB encoding: with a formula for SWC, with the
+// prediction of GTE, and by counting the clauses for the Adder.
+int Encoder::predictPB(const std::vector<Lit> &lits, const std::vector<uint64_t> &coeffs,
+                       uint64_t rhs, int *nVars, int limit) {
 
+  *nVars = 0;
+  int nClauses = 0;
   switch (pb_encoding) {
   case _PB_SWC_:
-    return -1;
+    nClauses = swc.predict(lits, coeffs, rhs, nVars);
     break;
 
-  case _PB_GTE_:
-    return gte.predict(solver, lits, coeffs, rhs);
+  case _PB_GTE_: {
+    // GTE::predict simplifies lits and coeffs and takes the variables from the buffer
+    std::vector<Lit> gte_lits(lits);
+    std::vector<uint64_t> gte_coeffs(coeffs);
+    ClauseBuffer counter(ClauseBuffer::counter(0));
+    nClauses = gte.predict(counter, gte_lits, gte_coeffs, rhs);
+    *nVars = counter.nb_fresh();
     break;
+  }
 
   case _PB_ADDER_:
-    return -1;
-    break;
-    
+    return countClauses(
+        [&](ClauseBuffer &counter) {
+          std::vector<Lit> adder_lits(lits);
+          std::vector<uint64_t> adder_coeffs(coeffs);
+          adder.encode(counter, adder_lits, adder_coeffs, rhs);
+        },
+        nVars, limit);
+
 //   case _PB_IGTE_:
 //     return igte.predict(solver, lits, coeffs, rhs);
 //     break;
@@ -235,11 +321,43 @@ int Encoder::predictPB(leximaxIST::Solver &solver, std::vector<Lit> &lits, std::
     print_error_msg("Invalid PB encoding : " + std::to_string(pb_encoding));
     exit(EXIT_FAILURE);
   }
+  return nClauses > limit || nClauses >= max_clauses ? limit + 1 : nClauses;
 }
 
+// Predicts the size of the cardinality encoding by counting its clauses.
+int Encoder::predictCardinality(const std::vector<Lit> &lits, int64_t rhs, int *nVars, int limit) {
+  return countClauses(
+      [&](ClauseBuffer &counter) {
+        std::vector<Lit> card_lits(lits);
+        encodeCardinality(counter, card_lits, rhs);
+      },
+      nVars, limit);
+}
+
+// SWC and GTE keep arc consistency, the Adder does not.
+int Encoder::choosePBEncoding(const std::vector<Lit> &lits, const std::vector<uint64_t> &coeffs,
+                              uint64_t rhs, int policy) {
+  return chooseEncoding({_PB_ADDER_}, {_PB_SWC_, _PB_GTE_}, policy,
+                        policy == _ENC_POLICY_STRONG_ ? _PB_GTE_ : _PB_ADDER_,
+                        [&](int enc, int limit, int *nVars) {
+                          Encoder predictor(_INCREMENTAL_NONE_, _CARD_TOTALIZER_, _AMO_LADDER_, enc);
+                          return predictor.predictPB(lits, coeffs, rhs, nVars, limit);
+                        });
+}
+
+// The totalizer and the cardinality networks keep arc consistency, the modulo
+// totalizer does not.
+int Encoder::chooseCardEncoding(const std::vector<Lit> &lits, int64_t rhs, int policy) {
+  return chooseEncoding({_CARD_MTOTALIZER_}, {_CARD_TOTALIZER_, _CARD_CNETWORKS_}, policy,
+                        policy == _ENC_POLICY_STRONG_ ? _CARD_TOTALIZER_ : _CARD_MTOTALIZER_,
+                        [&](int enc, int limit, int *nVars) {
+                          Encoder predictor(_INCREMENTAL_NONE_, enc, _AMO_LADDER_, _PB_SWC_);
+                          return predictor.predictCardinality(lits, rhs, nVars, limit);
+                        });
+}
 
 // Manages the update of PB encodings.
-void Encoder::updatePB(leximaxIST::Solver &solver, uint64_t rhs) {
+void Encoder::updatePB(leximaxIST::ClauseBuffer &solver, uint64_t rhs) {
 
   switch (pb_encoding) {
   case _PB_SWC_:
@@ -289,7 +407,7 @@ std::vector<Lit>& Encoder::getAssumptions(){
 // Incremental methods for PB encodings:
 //
 // Manages the incremental encode of PB encodings.
-void Encoder::incEncodePB(leximaxIST::Solver &solver, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+void Encoder::incEncodePB(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
                           int64_t rhs, std::vector<Lit> &assumptions, int size) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
   
@@ -307,7 +425,7 @@ void Encoder::incEncodePB(leximaxIST::Solver &solver, std::vector<Lit> &lits, st
 }
 
 // Manages the incremental update of PB encodings.
-void Encoder::incUpdatePB(leximaxIST::Solver &solver, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+void Encoder::incUpdatePB(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
                           int64_t rhs, std::vector<Lit> &assumptions) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
 
@@ -327,7 +445,7 @@ void Encoder::incUpdatePB(leximaxIST::Solver &solver, std::vector<Lit> &lits, st
 
 // Manages the incremental update of assumptions.
 // Currently only used for the iterative encoding with SWC.
-void Encoder::incUpdatePBAssumptions(leximaxIST::Solver &solver, std::vector<Lit> &assumptions) {
+void Encoder::incUpdatePBAssumptions(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &assumptions) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
 
   switch (pb_encoding) {
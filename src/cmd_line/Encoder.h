@@ -30,7 +30,7 @@
 #define Encoder_h
 
 #include <leximaxIST_types.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 
 // Encodings
 #include <Enc_CNetworks.h>
@@ -73,15 +73,15 @@ public:
   // At-most-one encodings:
   //
   // Encode exactly-one constraint into CNF.
-  void encodeAMO(leximaxIST::Solver &solver, std::vector<int> &lits);
+  void encodeAMO(leximaxIST::ClauseBuffer &solver, std::vector<int> &lits);
 
   // Cardinality encodings:
   //
   // Encode cardinality constraint into CNF.
-  void encodeCardinality(leximaxIST::Solver &solver, std::vector<int> &lits, int64_t rhs);
+  void encodeCardinality(leximaxIST::ClauseBuffer &solver, std::vector<int> &lits, int64_t rhs);
 
   // Update the rhs of an already existent cardinality constraint
-  void updateCardinality(leximaxIST::Solver &solver, int64_t rhs);
+  void updateCardinality(leximaxIST::ClauseBuffer &solver, int64_t rhs);
 
   // Incremental cardinality encodings:
   //
@@ -89,12 +89,12 @@ public:
   // No restriction is made on the value of 'rhs'.
   // buildCardinality + updateCardinality is equivalent to encodeCardinality.
   // Useful for incremental encodings.
-  void buildCardinality(leximaxIST::Solver &solver, const std::vector<int> &lits, int64_t rhs);
+  void buildCardinality(leximaxIST::ClauseBuffer &solver, const std::vector<int> &lits, int64_t rhs);
 
   // Incremental update for cardinality constraints;
-  void incUpdateCardinality(leximaxIST::Solver &solver, const std::vector<int> &join, const std::vector<int> &lits,
+  void incUpdateCardinality(leximaxIST::ClauseBuffer &solver, const std::vector<int> &join, const std::vector<int> &lits,
                             int64_t rhs, std::vector<int> &assumptions);
-  void incUpdateCardinality(leximaxIST::Solver &solver, const std::vector<int> &lits, int64_t rhs,
+  void incUpdateCardinality(leximaxIST::ClauseBuffer &solver, const std::vector<int> &lits, int64_t rhs,
                             std::vector<int> &assumptions) {
 
     std::vector<int> empty;
@@ -102,35 +102,48 @@ public:
   }
 
   // Add two disjoint cardinality constraints
-  void addCardinality(leximaxIST::Solver &solver, Encoder &enc, int64_t rhs);
+  void addCardinality(leximaxIST::ClauseBuffer &solver, Encoder &enc, int64_t rhs);
 
   // PB encodings:
   //
   // Encode pseudo-Boolean constraint into CNF.
-  void encodePB(leximaxIST::Solver &solver, std::vector<int> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
+  void encodePB(leximaxIST::ClauseBuffer &solver, std::vector<int> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
   // Update the rhs of an already existent pseudo-Boolean constraint.
-  void updatePB(leximaxIST::Solver &solver, uint64_t rhs);
-  // Predicts the number of clauses needed for the encoding
-  int predictPB(leximaxIST::Solver &solver, std::vector<int> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
+  void updatePB(leximaxIST::ClauseBuffer &solver, uint64_t rhs);
+  // Predicts the number of clauses and fresh variables of the encoding of a
+  // constraint. Returns limit + 1 if there are more than limit clauses
+  // (limit <= max_clauses) or if the encoding cannot be built.
+  int predictPB(const std::vector<int> &lits, const std::vector<uint64_t> &coeffs, uint64_t rhs,
+                int *nVars, int limit = max_clauses);
+  int predictCardinality(const std::vector<int> &lits, int64_t rhs, int *nVars, int limit = max_clauses);
+
+  // Automatic choice of the encoding of a constraint (_PB_AUTO_, _CARD_AUTO_)
+  // from the predicted number of clauses, then variables. The policy
+  // (_ENC_POLICY_*) says when an encoding that does not keep arc consistency
+  // (Adder, modulo totalizer) can be chosen: never, only if the others are
+  // much larger, or whenever it is the smallest.
+  static int choosePBEncoding(const std::vector<int> &lits, const std::vector<uint64_t> &coeffs,
+                              uint64_t rhs, int policy);
+  static int chooseCardEncoding(const std::vector<int> &lits, int64_t rhs, int policy);
 
   // Incremental PB encodings:
   //
   // Incremental PB encoding.
-  void incEncodePB(leximaxIST::Solver &solver, std::vector<int> &lits, std::vector<uint64_t> &coeffs,
+  void incEncodePB(leximaxIST::ClauseBuffer &solver, std::vector<int> &lits, std::vector<uint64_t> &coeffs,
                    int64_t rhs, std::vector<int> &assumptions, int size);
 
   // Incremental update of PB encodings.
-  void incUpdatePB(leximaxIST::Solver &solver, std::vector<int> &lits, std::vector<uint64_t> &coeffs,
+  void incUpdatePB(leximaxIST::ClauseBuffer &solver, std::vector<int> &lits, std::vector<uint64_t> &coeffs,
                    int64_t rhs, std::vector<int> &assumptions);
 
   // Incremental update of assumptions.
-  void incUpdatePBAssumptions(leximaxIST::Solver &solver, std::vector<int> &assumptions);
+  void incUpdatePBAssumptions(leximaxIST::ClauseBuffer &solver, std::vector<int> &assumptions);
 
   // Incremental construction of the totalizer encoding.
   // Joins a set of new literals, x_1 + ... + x_i, to an existing encoding of
   // the type
   // y_1 + ... + y_j <= k. It also updates 'k' to 'rhs'.
-  void joinEncoding(leximaxIST::Solver &solver, const std::vector<int> &lits, int64_t rhs);
+  void joinEncoding(leximaxIST::ClauseBuffer &solver, const std::vector<int> &lits, int64_t rhs);
 
   // Other:
   //
@@ -149,7 +162,7 @@ public:
   void setAMOEncoding(int enc) { amo_encoding = enc; }
   int getAMOEncoding() { return amo_encoding; }
   
-  /*void setApproxRatio(leximaxIST::Solver &solver, double eps) {
+  /*void setApproxRatio(leximaxIST::ClauseBuffer &solver, double eps) {
       epsilon = eps; if(pb_encoding == _PB_KP_) kp.setApproxRatio(solver, eps);
   }*/
 
@@ -0,0 +1,163 @@
+#include <FormulaEncoder.h>
+#include <Encoder.h>
+#include <ClauseBuffer.h>
+#include <leximaxIST_printing.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace leximaxIST {
+
+namespace {
+
+// number of literals of the constraints in a batch (the last one may have fewer)
+const size_t batchLits = 1 << 16;
+
+} // namespace
+
+//! Encode the constraints with nb_threads threads.
+/*!
+  The constraints, first the PB ones and then the cardinality ones, are
+  split into batches of about batchLits literals. Each batch is encoded into
+  its own ClauseBuffer, where the fresh variables start
+  after the variables of the formula. The fresh variables of each batch are
+  then shifted by the number of fresh variables of the previous batches, which
+  gives the same variables as encoding every constraint in order into the
+  solver, and the batches are added to the solver in order.
+*/
+void FormulaEncoder::encode(leximaxIST::Solver &solver) {
+  const int nPB = maxsat_formula->nPB();
+  const int nConstraints = nPB + maxsat_formula->nCard();
+  std::vector<int> bounds(1, 0);
+  size_t lits = 0;
+  for (int i = 0; i < nConstraints; ++i) {
+    lits += i < nPB ? maxsat_formula->getPBConstraint(i)._lits.size()
+                    : maxsat_formula->getCardinalityConstraint(i - nPB)._lits.size();
+    if (lits >= batchLits || i + 1 == nConstraints) {
+      bounds.push_back(i + 1);
+      lits = 0;
+    }
+  }
+
+  const size_t nBatches = bounds.size() - 1;
+  std::vector<ClauseBuffer> buffers(nBatches, ClauseBuffer(maxsat_formula->nVars()));
+  // statistics of each batch, summed at the end so that the threads do not share them
+  std::vector<std::vector<EncodingStats>> batchPBStats(nBatches, std::vector<EncodingStats>(_PB_AUTO_));
+  std::vector<std::vector<EncodingStats>> batchCardStats(nBatches,
+                                                         std::vector<EncodingStats>(_CARD_AUTO_ + 1));
+  std::atomic<size_t> next(0);
+  auto encodeWorker = [&]() {
+    for (size_t b = next++; b < nBatches; b = next++) {
+      for (int i = bounds[b]; i < bounds[b + 1]; ++i) {
+        const size_t before = buffers[b].nb_clauses();
+        EncodingStats *stats = nullptr;
+        if (i < nPB) {
+          PB &pb = maxsat_formula->getPBConstraint(i);
+          // Make sure the PB is on the form <=
+          if (!pb._sign)
+            pb.changeSign();
+          const int pbEnc = pb_encoding == _PB_AUTO_
+                                ? Encoder::choosePBEncoding(pb._lits, pb._coeffs, pb._rhs, enc_policy)
+                                : pb_encoding;
+          // a new encoder for each constraint: the encodings keep state between calls (e.g. the
+          // modulo of the modulo totalizer), which would make a constraint depend on the ones before
+          Encoder enc(_INCREMENTAL_NONE_, _CARD_TOTALIZER_, _AMO_LADDER_, pbEnc);
+          enc.encodePB(buffers[b], pb._lits, pb._coeffs, pb._rhs);
+          if (pbEnc < _PB_AUTO_)
+            stats = &batchPBStats[b][pbEnc];
+        } else {
+          Card &card = maxsat_formula->getCardinalityConstraint(i - nPB);
+          if (card._rhs == 1) {
+            Encoder enc(_INCREMENTAL_NONE_, _CARD_TOTALIZER_, _AMO_LADDER_, _PB_SWC_);
+            enc.encodeAMO(buffers[b], card._lits);
+            stats = &batchCardStats[b][_CARD_AUTO_];
+          } else {
+            const int cardEnc = card_encoding == _CARD_AUTO_
+                                    ? Encoder::chooseCardEncoding(card._lits, card._rhs, enc_policy)
+                                    : card_encoding;
+            Encoder enc(_INCREMENTAL_NONE_, cardEnc, _AMO_LADDER_, _PB_SWC_);
+            enc.encodeCardinality(buffers[b], card._lits, card._rhs);
+            if (cardEnc < _CARD_AUTO_)
+              stats = &batchCardStats[b][cardEnc];
+          }
+        }
+        if (stats != nullptr) {
+          ++stats->nb_constraints;
+          stats->nb_clauses += buffers[b].nb_clauses() - before;
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  const int nThreads = std::min<size_t>(nb_threads, nBatches);
+  for (int t = 1; t < nThreads; ++t)
+    threads.emplace_back(encodeWorker);
+  encodeWorker();
+  for (std::thread &t : threads)
+    t.join();
+
+  // the fresh variables of batch b go after the ones of the batches before it
+  std::vector<int> offsets(nBatches, 0);
+  nb_fresh = 0;
+  nb_clauses = 0;
+  pb_stats.assign(_PB_AUTO_, EncodingStats());
+  card_stats.assign(_CARD_AUTO_ + 1, EncodingStats());
+  for (size_t b = 0; b < nBatches; ++b) {
+    for (size_t e = 0; e < pb_stats.size(); ++e) {
+      pb_stats[e].nb_constraints += batchPBStats[b][e].nb_constraints;
+      pb_stats[e].nb_clauses += batchPBStats[b][e].nb_clauses;
+    }
+    for (size_t e = 0; e < card_stats.size(); ++e) {
+      card_stats[e].nb_constraints += batchCardStats[b][e].nb_constraints;
+      card_stats[e].nb_clauses += batchCardStats[b][e].nb_clauses;
+    }
+    offsets[b] = nb_fresh;
+    nb_fresh += buffers[b].nb_fresh();
+    nb_clauses += buffers[b].clauses().size();
+    if (maxsat_formula->nVars() + nb_fresh > INT_MAX) {
+      print_error_msg("The number of variables exceeded INT_MAX");
+      exit(EXIT_FAILURE);
+    }
+  }
+  next = 0;
+  auto shiftWorker = [&]() {
+    for (size_t b = next++; b < nBatches; b = next++)
+      buffers[b].shift_fresh(offsets[b]);
+  };
+  threads.clear();
+  for (int t = 1; t < nThreads; ++t)
+    threads.emplace_back(shiftWorker);
+  shiftWorker();
+  for (std::thread &t : threads)
+    t.join();
+
+  for (ClauseBuffer &buffer : buffers) {
+    solver.add_hard_clauses(buffer.clauses());
+    buffer.clear();
+  }
+}
+
+void FormulaEncoder::printEncodingStats() const {
+  const char *pbNames[] = {"SWC", "GTE", "Adder", "IGTE", "KP", "KP-minisatp"};
+  const char *cardNames[] = {"cardinality networks", "totalizer", "modulo totalizer", "ladder (AMO)"};
+  std::cout << "c PB encodings:";
+  for (size_t e = 0; e < pb_stats.size(); ++e) {
+    if (pb_stats[e].nb_constraints != 0)
+      std::cout << " " << pbNames[e] << " " << pb_stats[e].nb_constraints << " ("
+                << pb_stats[e].nb_clauses << " clauses)";
+  }
+  std::cout << '\n';
+  std::cout << "c Cardinality encodings:";
+  for (size_t e = 0; e < card_stats.size(); ++e) {
+    if (card_stats[e].nb_constraints != 0)
+      std::cout << " " << cardNames[e] << " " << card_stats[e].nb_constraints << " ("
+                << card_stats[e].nb_clauses << " clauses)";
+  }
+  std::cout << '\n';
+}
+
+} // namespace leximaxIST
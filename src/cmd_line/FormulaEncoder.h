@@ -0,0 +1,59 @@
+#ifndef FormulaEncoder_h
+#define FormulaEncoder_h
+
+#include <leximaxIST_Solver.h>
+#include <MaxSATFormula.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace leximaxIST {
+
+//=================================================================================================
+/* Encodes the PB and cardinality constraints of a MaxSATFormula into CNF and adds the clauses
+ * to a Solver. The constraints are split into batches that are encoded in parallel, each one
+ * into its own ClauseBuffer. The batches do not depend on the number of threads and their fresh
+ * variables are renumbered in the order of the constraints, so the clauses given to the solver
+ * are always the same.
+ * With the automatic encodings, the encoding of each constraint is chosen before encoding it
+ * (Encoder::choosePBEncoding and Encoder::chooseCardEncoding).
+ */
+class FormulaEncoder {
+
+public:
+  // With _PB_AUTO_ or _CARD_AUTO_ the encoding of each constraint is chosen with the policy
+  FormulaEncoder(MaxSATFormula *m, int pbEncoding, int cardEncoding, int nThreads = 1,
+                 int policy = _ENC_POLICY_BALANCED_)
+      : maxsat_formula(m), pb_encoding(pbEncoding), card_encoding(cardEncoding),
+        nb_threads(nThreads), enc_policy(policy), nb_clauses(0), nb_fresh(0),
+        pb_stats(_PB_AUTO_), card_stats(_CARD_AUTO_ + 1) {}
+
+  // The PB constraints are changed to the form <=
+  void encode(leximaxIST::Solver &solver);
+
+  // Statistics of the last call to encode
+  size_t nClauses() const { return nb_clauses; }
+  int64_t nFreshVars() const { return nb_fresh; }
+  // Number of constraints and clauses of each encoding
+  void printEncodingStats() const;
+
+protected:
+  struct EncodingStats {
+    EncodingStats() : nb_constraints(0), nb_clauses(0) {}
+    int nb_constraints;
+    size_t nb_clauses;
+  };
+
+  MaxSATFormula *maxsat_formula;
+  int pb_encoding;
+  int card_encoding;
+  int nb_threads;
+  int enc_policy;
+  size_t nb_clauses;
+  int64_t nb_fresh;
+  std::vector<EncodingStats> pb_stats;   // indexed by _PB_*
+  std::vector<EncodingStats> card_stats; // indexed by _CARD_*, the AMOs are in _CARD_AUTO_
+};
+} // namespace leximaxIST
+
+#endif
@@ -58,7 +58,6 @@ public:
   }
 
   Card() { _rhs = 0; }
-  ~Card() {}
 
   void print() {
     printf("Card: ");
@@ -115,7 +114,6 @@ public:
     _sign = false;
     ub = 0;
   }
-  ~PB() {}
 
   void addProduct(Lit l, int64_t c) {
     if (c >= 0) {
@@ -250,7 +248,6 @@ class PBObjFunction {
     }
 
     PBObjFunction() { _const = 0; ub = 0;}
-    ~PBObjFunction() {}
 
     void addProduct(Lit l, int64_t c) {
         if (c >= 0) {
@@ -168,28 +168,66 @@ void MaxSATFormula::addPBConstraint(PB &p) {
 }
 
 int MaxSATFormula::newVarName(char *varName) {
-  int id = varID(varName);
-  if (id == var_Undef) {
-    id = nVars() + 1;
-    newVar();
-    std::string s(varName);
-    std::pair<std::string, int> nv(s, id);
-    std::pair<int, std::string> ni(id, s);
-    _nameToIndex.insert(nv);
-    _indexToName.insert(ni);
-  }
-  return id;
+  return newVarName(std::string(varName));
 }
 
 int MaxSATFormula::varID(char *varName) {
-  std::string s(varName);
+  return varID(std::string(varName));
+}
 
+int MaxSATFormula::newVarName(const std::string &s) {
+  const auto it = _nameToIndex.emplace(s, nVars() + 1);
+  if (it.second) {
+    newVar();
+    _indexToName.emplace_hint(_indexToName.end(), it.first->second, s); // the ids are increasing
+  }
+  return it.first->second;
+}
+
+int MaxSATFormula::varID(const std::string &s) {
   nameMap::const_iterator iter = _nameToIndex.find(s);
   if (iter != _nameToIndex.end()) {
     return iter->second;
   }
   return var_Undef;
 }
+
+void MaxSATFormula::renameVars(const std::vector<int> &varMap) {
+  auto rename = [&varMap](std::vector<Lit> &lits) {
+    for (Lit &l : lits)
+      l = (l < 0) ? -varMap[-l] : varMap[l];
+  };
+  for (Hard &h : hard_clauses)
+    rename(h.clause);
+  for (Card &c : cardinality_constraints)
+    rename(c._lits);
+  for (PB &p : pb_constraints)
+    rename(p._lits);
+  for (PBObjFunction &of : objective_functions)
+    rename(of._lits);
+}
+
+void MaxSATFormula::append(MaxSATFormula &f) {
+  hard_clauses.reserve(hard_clauses.size() + f.hard_clauses.size());
+  for (Hard &h : f.hard_clauses)
+    hard_clauses.push_back(std::move(h));
+  n_hard += f.n_hard;
+  cardinality_constraints.reserve(cardinality_constraints.size() + f.cardinality_constraints.size());
+  for (Card &c : f.cardinality_constraints)
+    cardinality_constraints.push_back(std::move(c));
+  pb_constraints.reserve(pb_constraints.size() + f.pb_constraints.size());
+  for (PB &p : f.pb_constraints)
+    pb_constraints.push_back(std::move(p));
+  for (PBObjFunction &of : f.objective_functions)
+    objective_functions.push_back(std::move(of));
+  n_objf += f.n_objf;
+  f.hard_clauses.clear();
+  f.cardinality_constraints.clear();
+  f.pb_constraints.clear();
+  f.objective_functions.clear();
+  f.n_hard = 0;
+  f.n_objf = 0;
+}
 /*
 void MaxSATFormula::convertPBtoMaxSAT() {
 // void MaxSATFormula::convertPBtoMaxSAT(Solver * S = NULL) { //AG
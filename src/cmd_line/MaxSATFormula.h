@@ -85,7 +85,6 @@ public:
   Hard(const std::vector<Lit> &hard) { clause = hard; }
 
   Hard() {}
-  ~Hard() { clause.clear(); }
 
   std::vector<Lit> clause; //!< Hard clause
   
@@ -180,6 +179,14 @@ public:
 
   int newVarName(char *varName);
   int varID(char *varName);
+  int newVarName(const std::string &varName);
+  int varID(const std::string &varName);
+
+  /*! Rename each variable v of the constraints and objective functions to varMap[v]. */
+  void renameVars(const std::vector<int> &varMap);
+
+  /*! Move the constraints and objective functions of f to the end of this formula. */
+  void append(MaxSATFormula &f);
 
   void addObjFunction(const PBObjFunction &of) {
     objective_functions.push_back(of);
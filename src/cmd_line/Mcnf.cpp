@@ -24,63 +24,334 @@
  */
 
 #include "Mcnf.h"
+#include "leximaxIST_printing.h"
+#include "leximaxIST_parsing_utils.h"
 
-#include <cassert>
-#include <fstream>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <lzma.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
 
 namespace leximaxIST {
 
-inline int var(Lit l) { return l < 0 ? -l : l; }
+namespace {
 
-Mcnf::Mcnf(std::string fileName) {
-  // Parse file
-  std::string line{};
-  std::vector<std::string> toks{};
-  std::fstream file;
-  file.open(fileName, std::fstream::in);
+const size_t chunk_size = 1 << 22;
 
-  while (getline(file, line)) {
-    if (line[0] == 'c')
-      continue;
-    size_t pos = 0;
-    toks.clear();
-    while ((pos = line.find(" ")) != std::string::npos) {
-      toks.push_back(line.substr(0, pos));
-      line.erase(0, pos + 1);
-    }
-    toks.push_back(line);
-    assert(toks.size() >= 1);
-    if (toks[0] == "h") {
-      // Parse clause
-      assert(toks.back() == "0");
-      Clause cl{};
-      Lit l{};
-      for (uint32_t i = 1; i < toks.size() - 1; i++) {
-        l = std::stoi(toks[i]);
-        cl.push_back(l);
+[[noreturn]] void read_error(const std::string &fileName, const std::string &msg) {
+  print_error_msg(msg + " (file " + fileName + ")");
+  exit(EXIT_FAILURE);
+}
+
+inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// Single pass over complete lines, the literals are written into the clause arenas of the Mcnf
+class McnfScanner {
+public:
+  McnfScanner(Mcnf &mcnf, const std::string &fileName)
+      : mcnf(mcnf), fileName(fileName) {}
+
+  /* parses the lines in [first, last), which must end with '\n'
+   * and be followed by at least 7 readable bytes (integers are loaded 8 bytes at a time)
+   */
+  void parseLines(const char *first, const char *last) {
+    const char *p = first;
+    while (p != last) {
+      ++line;
+      while (is_blank(*p))
+        ++p;
+      if (*p == '\n') {
+        ++p;
+        continue;
       }
-      hards.push_back(cl);
-      continue;
-    }
-    if (toks[0][0] == 'o') {
-      // Soft clause
-      assert(toks.size() >= 4);
-      assert(toks.back() == "0");
-      size_t idx = std::stoi(toks[0].substr(1)) - 1;
-      uint64_t w = std::stoi(toks[1]);
-      Clause cl{};
-      for (size_t i = 2; i < toks.size() - 1; ++i) {
-        Lit l = std::stoi(toks[i]);
-        cl.push_back(l);
+      if (*p == 'c') {
+        p = static_cast<const char *>(memchr(p, '\n', last - p)) + 1;
+        continue;
       }
-      if (softs.size() <= idx) {
-        softs.resize(idx + 1);
+      if (*p == 'h') {
+        ++p;
+        parseClause(p, mcnf.hards);
+      } else if (*p == 'o') {
+        ++p;
+        const uint64_t idx = parseUint(p);
+        if (idx == 0 || idx > INT_MAX)
+          error("invalid objective index " + std::to_string(idx));
+        const uint64_t w = parseUint(p);
+        if (mcnf.softs.size() < idx) {
+          mcnf.softs.resize(idx);
+          mcnf.soft_weights.resize(idx);
+        }
+        parseClause(p, mcnf.softs[idx - 1]);
+        mcnf.soft_weights[idx - 1].push_back(w);
+      } else
+        error("unexpected character '" + std::string(1, *p) + "'");
+      ++p; // the clause ends at the '\n'
+    }
+  }
+
+  // estimate of the size of the hard clauses from the number of bytes of the file, to avoid copying the arena as it grows
+  void reserve(size_t nbBytes) { mcnf.hards.reserve(nbBytes / 32, nbBytes / 8); }
+
+private:
+  Mcnf &mcnf;
+  const std::string &fileName;
+  size_t line{0};
+  Clause lits{};
+
+  [[noreturn]] void error(const std::string &msg) const {
+    print_error_msg("Parse error in line " + std::to_string(line) + " of file " +
+                    fileName + ": " + msg);
+    exit(EXIT_FAILURE);
+  }
+
+  void checkEndOfNumber(const char *p) const {
+    if (!is_blank(*p) && *p != '\n')
+      error("unexpected character '" + std::string(1, *p) + "' in a number");
+  }
+
+  uint64_t parseUint(const char *&p) const {
+    while (is_blank(*p))
+      ++p;
+    if (*p < '0' || *p > '9')
+      error("expected a non-negative integer");
+    uint64_t v = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t word;
+    memcpy(&word, p, 8);
+    const int n = FileBuffer::digit_count(word);
+    if (n < 8) {
+      p += n;
+      checkEndOfNumber(p);
+      return FileBuffer::digits_value(word << (8 * (8 - n)));
+    }
+#endif
+    for (; *p >= '0' && *p <= '9'; ++p) {
+      const uint64_t d = *p - '0';
+      if (v > (UINT64_MAX - d) / 10)
+        error("integer does not fit in 64 bits");
+      v = v * 10 + d;
+    }
+    checkEndOfNumber(p);
+    return v;
+  }
+
+  int parseLit(const char *&p) const {
+    while (is_blank(*p))
+      ++p;
+    const bool neg = *p == '-';
+    if (neg)
+      ++p;
+    if (*p < '0' || *p > '9')
+      error(*p == '\n' ? "clause not terminated by 0" : "expected a literal");
+    int64_t v = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t word;
+    memcpy(&word, p, 8);
+    const int n = FileBuffer::digit_count(word);
+    if (n < 8) {
+      p += n;
+      checkEndOfNumber(p);
+      v = FileBuffer::digits_value(word << (8 * (8 - n)));
+      return neg ? -static_cast<int>(v) : static_cast<int>(v);
+    }
+#endif
+    for (; *p >= '0' && *p <= '9'; ++p) {
+      v = v * 10 + (*p - '0');
+      if (v > INT_MAX)
+        error("variable does not fit in an int");
+    }
+    checkEndOfNumber(p);
+    return neg ? -static_cast<int>(v) : static_cast<int>(v);
+  }
+
+  // leaves p at the '\n' of the line
+  void parseClause(const char *&p, ClauseArena &clauses) {
+    lits.clear();
+    for (int l = parseLit(p); l != 0; l = parseLit(p))
+      lits.push_back(l);
+    while (is_blank(*p))
+      ++p;
+    if (*p != '\n')
+      error("unexpected characters after the end of the clause");
+    clauses.push_back(lits);
+  }
+};
+
+// stream of the bytes of a file that is not memory mapped
+class InputStream {
+public:
+  virtual ~InputStream() {}
+  // reads at most size bytes, returns 0 at the end of the file
+  virtual size_t read(char *buf, size_t size) = 0;
+};
+
+// gzip files (and other files that can not be memory mapped, which zlib reads transparently)
+class GzStream : public InputStream {
+public:
+  GzStream(int fd, const std::string &fileName)
+      : in(gzdopen(fd, "rb")), fileName(fileName) {
+    if (in == nullptr) {
+      close(fd);
+      read_error(fileName, "Unable to read file");
+    }
+    gzbuffer(in, chunk_size);
+  }
+  ~GzStream() override { gzclose(in); }
+
+  size_t read(char *buf, size_t size) override {
+    const int n = gzread(in, buf, size > INT_MAX ? INT_MAX : size);
+    if (n < 0) {
+      int errnum;
+      read_error(fileName, std::string("Unable to decompress: ") + gzerror(in, &errnum));
+    }
+    return n;
+  }
+
+private:
+  gzFile in;
+  const std::string &fileName;
+};
+
+class XzStream : public InputStream {
+public:
+  XzStream(int fd, const std::string &fileName)
+      : fd(fd), fileName(fileName), inBuf(chunk_size) {
+    if (lzma_stream_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+      read_error(fileName, "Unable to initialise the xz decoder");
+  }
+  ~XzStream() override {
+    lzma_end(&strm);
+    close(fd);
+  }
+
+  size_t read(char *buf, size_t size) override {
+    strm.next_out = reinterpret_cast<uint8_t *>(buf);
+    strm.avail_out = size;
+    while (strm.avail_out > 0) {
+      if (strm.avail_in == 0 && !eof) {
+        ssize_t n;
+        do
+          n = ::read(fd, inBuf.data(), inBuf.size());
+        while (n < 0 && errno == EINTR);
+        if (n < 0)
+          read_error(fileName, "Unable to read file");
+        eof = n == 0;
+        strm.next_in = inBuf.data();
+        strm.avail_in = n;
       }
-      softs[idx].emplace_back(std::make_pair(w, cl));
-      continue;
+      const lzma_ret ret = lzma_code(&strm, eof ? LZMA_FINISH : LZMA_RUN);
+      if (ret == LZMA_STREAM_END)
+        break;
+      if (ret != LZMA_OK)
+        read_error(fileName, "Unable to decompress (xz error " + std::to_string(ret) + ")");
     }
-    exit(1);
+    return size - strm.avail_out;
+  }
+
+private:
+  int fd;
+  const std::string &fileName;
+  std::vector<uint8_t> inBuf;
+  lzma_stream strm = LZMA_STREAM_INIT;
+  bool eof{false};
+};
+
+// returns the number of bytes read, the last line of the buffer is parsed when the next chunk completes it
+size_t parseStream(InputStream &in, McnfScanner &scanner) {
+  size_t capacity = chunk_size;
+  std::vector<char> buf(capacity + 8, 0); // padding for the 8 byte loads of the scanner
+  size_t filled = 0; // bytes in buf that were not parsed yet
+  size_t nb_bytes = 0;
+  while (true) {
+    if (filled == capacity) { // line longer than the buffer
+      capacity *= 2;
+      buf.resize(capacity + 8, 0);
+    }
+    const size_t n = in.read(buf.data() + filled, capacity - filled);
+    if (n == 0)
+      break;
+    nb_bytes += n;
+    filled += n;
+    const char *nl = static_cast<const char *>(memrchr(buf.data(), '\n', filled));
+    if (nl == nullptr)
+      continue;
+    const size_t len = nl + 1 - buf.data();
+    scanner.parseLines(buf.data(), buf.data() + len);
+    memmove(buf.data(), buf.data() + len, filled - len);
+    filled -= len;
+  }
+  if (filled > 0) { // no newline at the end of the file
+    buf[filled] = '\n';
+    scanner.parseLines(buf.data(), buf.data() + filled + 1);
+  }
+  return nb_bytes;
+}
+
+// returns false if the file can not be memory mapped
+bool parseMapped(int fd, size_t size, McnfScanner &scanner) {
+  if (size == 0)
+    return true;
+  void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED)
+    return false;
+  madvise(map, size, MADV_SEQUENTIAL);
+  scanner.reserve(size);
+  const char *first = static_cast<const char *>(map);
+  // the lines that end in the last 8 bytes of the file are copied, with padding
+  const char *nl = size > 8 ? static_cast<const char *>(memrchr(first, '\n', size - 8)) : nullptr;
+  const char *last = (nl == nullptr) ? first : nl + 1;
+  scanner.parseLines(first, last);
+  if (last != first + size) {
+    std::string tail(last, first + size);
+    if (tail.back() != '\n')
+      tail.push_back('\n');
+    const size_t len = tail.size();
+    tail.append(8, '\0');
+    scanner.parseLines(tail.data(), tail.data() + len);
+  }
+  munmap(map, size);
+  return true;
+}
+
+} // namespace
+
+Mcnf::Mcnf(const std::string &fileName) {
+  const auto start = std::chrono::steady_clock::now();
+  const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    read_error(fileName, "Unable to open file");
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    read_error(fileName, "Unable to get size of file");
+  }
+  McnfScanner scanner(*this, fileName);
+  unsigned char magic[6] = {0, 0, 0, 0, 0, 0};
+  const bool regular = S_ISREG(st.st_mode);
+  if (regular && pread(fd, magic, sizeof(magic), 0) < 0) {
+    close(fd);
+    read_error(fileName, "Unable to read file");
+  }
+  const bool gz = magic[0] == 0x1F && magic[1] == 0x8B;
+  const bool xz = memcmp(magic, "\xFD" "7zXZ\0", 6) == 0;
+  if (xz) {
+    XzStream in(fd, fileName);
+    nb_bytes = parseStream(in, scanner);
+  } else if (regular && !gz && parseMapped(fd, st.st_size, scanner)) {
+    nb_bytes = st.st_size;
+    close(fd);
+  } else {
+    GzStream in(fd, fileName);
+    nb_bytes = parseStream(in, scanner);
   }
+  parse_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 }
 
 } // namespace leximaxIST
@@ -29,19 +29,31 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <cstddef>
 
 #include "leximaxIST_types.h"
+#include "leximaxIST_ClauseArena.h"
 
 namespace leximaxIST
 {
+  /* Instance in the MCNF format: comment lines "c ...", hard clauses "h lits 0"
+   * and soft clauses "oI w lits 0" of objective I with weight w.
+   * Uncompressed files are memory mapped, .gz and .xz files are decompressed as a stream
+   * (the format is detected from the first bytes of the file).
+   */
   class Mcnf
   {
   public:
-    std::vector<Clause> hards{};
-    std::vector<std::vector<std::pair<uint64_t, Clause>>> softs{};
+    ClauseArena hards{};
+    // softs[i] are the soft clauses of objective i + 1 and soft_weights[i] their weights
+    std::vector<ClauseArena> softs{};
+    std::vector<std::vector<uint64_t>> soft_weights{};
+    // number of (decompressed) bytes parsed and wall-clock time of the parsing in seconds
+    size_t nb_bytes{0};
+    double parse_time{0};
 
-    Mcnf(std::string fileName);
+    Mcnf(const std::string &fileName);
   };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -12,11 +12,18 @@ namespace leximaxIST {
     int Options::get_help() {return m_help.get_data();}
     int Options::get_verbosity() {return m_verbosity.get_data();}
     int Options::get_leave_tmp_files() {return m_leave_tmp_files.get_data();}
+    int Options::get_gzip_input() {return m_gzip_input.get_data();}
     int Options::get_disjoint_cores() {return m_disjoint_cores.get_data();}
+    int Options::get_maxsat_presolve() {return m_maxsat_presolve.get_data();}
+    int Options::get_half_comparators() {return m_half_comparators.get_data();}
+    const std::string& Options::get_sorter() {return m_sorter.get_data();}
+    const std::string& Options::get_retention() {return m_retention.get_data();}
     const std::string& Options::get_optimise() {return m_optimise.get_data();}
     const std::string& Options::get_approx() {return m_approx.get_data();}
     const std::string& Options::get_input_file_name() {return m_input_file_name.get_data();}
     double Options::get_timeout() {return m_timeout.get_data();}
+    double Options::get_deadline() {return m_deadline.get_data();}
+    double Options::get_mem_limit() {return m_mem_limit.get_data();}
     int Options::get_mss_tol() {return m_mss_tol.get_data();}
     int Options::get_mss_add_cls() {return m_mss_add_cls.get_data();}
     int Options::get_mss_incr() {return m_mss_incr.get_data();}
@@ -27,8 +34,22 @@ namespace leximaxIST {
     const std::string& Options::get_ilp_solver() {return m_ilp_solver.get_data();}
 
     Options::FileType Options::get_input_file_type() {
+        if (m_input_file_type.get_data() == 2)
+            return Options::FileType::SNAPSHOT;
         return (m_input_file_type.get_data() ? Options::FileType::MCNF : Options::FileType::OPB);
     }
+    int Options::get_parse_threads() {return m_parse_threads.get_data();}
+    int Options::get_encode_threads() {return m_encode_threads.get_data();}
+
+    int Options::get_enc_policy()
+    {
+        if (m_enc_policy.get_data() == "strong")
+            return _ENC_POLICY_STRONG_;
+        if (m_enc_policy.get_data() == "size")
+            return _ENC_POLICY_SIZE_;
+        return _ENC_POLICY_BALANCED_;
+    }
+    const std::string& Options::get_write_snapshot() {return m_write_snapshot.get_data();}
     bool Options::get_preprocessing() {return m_preprocessing.get_data();}
     const std::string& Options::get_maxpre_techiques() {return m_maxpre_techniques.get_data();}
     
@@ -39,8 +60,14 @@ namespace leximaxIST {
     , m_optimise ("")
     , m_input_file_name ("")
     , m_disjoint_cores (0)
+    , m_maxsat_presolve (0)
+    , m_half_comparators (0)
+    , m_sorter ("odd_even")
+    , m_retention ("all")
     , m_approx ("")
     , m_timeout (86400)
+    , m_deadline (0)
+    , m_mem_limit (0)
     , m_mss_tol (0)
     , m_mss_add_cls (1)
     , m_mss_incr (0)
@@ -49,8 +76,13 @@ namespace leximaxIST {
     , m_pb_enc (_PB_SWC_)
     , m_card_enc (_CARD_MTOTALIZER_)
     , m_leave_tmp_files (0)
+    , m_gzip_input (0)
     , m_ilp_solver ("gurobi")
     , m_input_file_type (0)
+    , m_parse_threads (1)
+    , m_encode_threads (1)
+    , m_enc_policy ("balanced")
+    , m_write_snapshot ("")
     , m_preprocessing (0)
     , m_maxpre_techniques ("[[uvsrgc]VRTG]")
     {
@@ -93,11 +125,45 @@ namespace leximaxIST {
         description += exp_tab + "when optimising, use the disjoint cores strategy\n";
         m_disjoint_cores.set_description(description);
         
+        // maxsat presolve
+        description = name_tab + "--maxsat-presolve\n";
+        description += exp_tab + "when optimising, first minimise the sum of the objective functions (OLL core-guided search)\n";
+        description += exp_tab + "to get a lower bound and a solution; with --dcs its cores are the first disjoint cores\n";
+        m_maxsat_presolve.set_description(description);
+        
+        // half comparators
+        description = name_tab + "--half-comparators\n";
+        description += exp_tab + "when optimising, encode only the half of each comparator of the sorting networks that is needed\n";
+        description += exp_tab + "(the outputs are only bounded from above)\n";
+        m_half_comparators.set_description(description);
+        
+        // sorter
+        description = name_tab + "--sorter <string>\n";
+        description += exp_tab + "encoding of the sorted objectives (weighted objectives always use the generalized totalizer):\n";
+        description += values_tab + "odd_even (default) - odd-even merge sorting network\n";
+        description += values_tab + "totalizer - totalizer\n";
+        description += values_tab + "pairwise - pairwise sorting network\n";
+        description += values_tab + "auto - totalizer for objectives with less than 64 variables, odd-even merge otherwise\n";
+        m_sorter.set_description(description);
+        
+        // retention
+        description = name_tab + "--retention <string>\n";
+        description += exp_tab + "clauses kept in memory after being given to the SAT solver:\n";
+        description += values_tab + "all (default) - input hard clauses and encoding clauses\n";
+        description += values_tab + "inputs - input hard clauses (not with external solvers or MaxSAT presolving)\n";
+        description += values_tab + "none - no clauses (only with the incremental algorithms that use the internal SAT solver)\n";
+        m_retention.set_description(description);
+        
         // leave_tmp_files
         description = name_tab + "--ltf\n";
         description += exp_tab + "leave temporary files (when solving using an external solver)\n";
         m_leave_tmp_files.set_description(description);
         
+        // gzip_input
+        description = name_tab + "--gzip-input\n";
+        description += exp_tab + "compress the input files of the external solvers with gzip\n";
+        m_gzip_input.set_description(description);
+        
         // approx
         description = name_tab + "--approx <string>\n";
         description += exp_tab + "approximate the leximax-optimum using the approach specified in <string>:\n";
@@ -110,6 +176,17 @@ namespace leximaxIST {
         description += exp_tab + "specify a timeout (in seconds) for the approximation (default: 86400 (one day))\n";
         m_timeout.set_description(description);
         
+        // deadline
+        description = name_tab + "--deadline <double>\n";
+        description += exp_tab + "wall-clock time limit (in seconds) for the whole run, after which the best solution found is printed\n";
+        description += exp_tab + "(default: no limit)\n";
+        m_deadline.set_description(description);
+        
+        // mem-limit
+        description = name_tab + "--mem-limit <double>\n";
+        description += exp_tab + "memory limit (in megabytes), after which the best solution found is printed (default: no limit)\n";
+        m_mem_limit.set_description(description);
+        
         // mss-tol
         description = name_tab + "--mss-tol <int>\n";
         description += exp_tab + "tolerance for the choice of the next clause tested for satisfiability, in the MSS linear search\n";
@@ -141,20 +218,22 @@ namespace leximaxIST {
         m_gia_incr.set_description(description);
         
         // pb-enc
-        description = name_tab + "--pb-enc <int>\n";
+        description = name_tab + "--pb-enc <int>|auto\n";
         description += exp_tab + "Set the encoding of Pseudo-Boolean non-cardinality constraints to CNF\n";
         description += values_tab + "0 - SWC \n";
         description += values_tab + "1 (default) - GTE \n";
         description += values_tab + "2 - Adder\n";
         description += values_tab + "3 - IGTE \n";
+        description += values_tab + "auto - choose the encoding of each constraint from its predicted size (see --enc-policy)\n";
         m_pb_enc.set_description(description);
         
         // card-enc
-        description = name_tab + "--card-enc <int>\n";
+        description = name_tab + "--card-enc <int>|auto\n";
         description += exp_tab + "Set the encoding of cardinality constraints to CNF\n";
         description += values_tab + "0 - cardinality networks\n";
         description += values_tab + "1 - totalizer\n";
         description += values_tab + "2 (default) - modulo totalizer\n";
+        description += values_tab + "auto - choose the encoding of each constraint from its predicted size (see --enc-policy)\n";
         m_card_enc.set_description(description);
         
         // ilp-solver
@@ -162,6 +241,7 @@ namespace leximaxIST {
         description += exp_tab + "Specify the ILP solver to use in the ILP-based algorithm\n";
         description += values_tab + "'gurobi' (default)\n";
         description += values_tab + "'cplex'\n";
+        description += values_tab + "'cbc' (linked into leximaxIST, requires compiling with 'make CBC=1')\n";
         m_ilp_solver.set_description(description);
 
         // input file type
@@ -169,8 +249,34 @@ namespace leximaxIST {
         description += exp_tab + "The type of the input file\n";
         description += values_tab + "0 (default) - OPB\n";
         description += values_tab + "1 - MCNF\n";
+        description += values_tab + "2 - snapshot written with --write-snapshot\n";
         m_input_file_type.set_description(description);
 
+        // parse threads
+        description = name_tab + "--parse-threads <int>\n";
+        description += exp_tab + "number of threads that parse an OPB file, by chunks of lines (default: 1)\n";
+        m_parse_threads.set_description(description);
+
+        // encode threads
+        description = name_tab + "--encode-threads <int>\n";
+        description += exp_tab + "number of threads that encode the PB and cardinality constraints of an OPB file to CNF (default: 1)\n";
+        description += exp_tab + "the encoding does not depend on the number of threads\n";
+        m_encode_threads.set_description(description);
+
+        // encoding policy
+        description = name_tab + "--enc-policy <string>\n";
+        description += exp_tab + "Set which encodings '--pb-enc auto' and '--card-enc auto' can choose\n";
+        description += values_tab + "'strong' - only encodings that keep arc consistency (SWC, GTE, totalizer, cardinality networks)\n";
+        description += values_tab + "'balanced' (default) - the Adder or the modulo totalizer only if the others are predicted to be 4 times larger\n";
+        description += values_tab + "'size' - the smallest predicted encoding\n";
+        m_enc_policy.set_description(description);
+
+        // write snapshot
+        description = name_tab + "--write-snapshot <string>\n";
+        description += exp_tab + "write the instance (after parsing and encoding the PB constraints) to the binary file <string>,\n";
+        description += exp_tab + "which later runs can read with '--input-file-type 2' (not compatible with --preprocessing)\n";
+        m_write_snapshot.set_description(description);
+
         // preprocessing
         description = name_tab + "--preprocessing\n";
         description += exp_tab + "Turn on preprocessing with MaxPre\n";
@@ -244,10 +350,13 @@ namespace leximaxIST {
         static struct option long_options[] = {
             {"help", no_argument,    &(m_help.get_data()), 1},
             {"dcs",  no_argument,  &(m_disjoint_cores.get_data()), 1},
+            {"maxsat-presolve",  no_argument,  &(m_maxsat_presolve.get_data()), 1},
+            {"half-comparators",  no_argument,  &(m_half_comparators.get_data()), 1},
             {"mss-incr",  no_argument,  &(m_mss_incr.get_data()), 1},
             {"gia-incr",  no_argument,  &(m_gia_incr.get_data()), 1},
             {"gia-pareto",  no_argument,  &(m_gia_pareto.get_data()), 1},
             {"ltf",  no_argument,  &(m_leave_tmp_files.get_data()), 1},
+            {"gzip-input",  no_argument,  &(m_gzip_input.get_data()), 1},
             {"optimise",  required_argument,  0, 500},
             {"approx",  required_argument,  0, 501},
             {"mss-tol",  required_argument,  0, 502},
@@ -259,6 +368,14 @@ namespace leximaxIST {
             {"input-file-type",  required_argument,  0, 508},
             {"preprocessing",  no_argument,  &(m_preprocessing.get_data()), 1},
             {"maxpre-techniques",  required_argument,  0, 509},
+            {"sorter",  required_argument,  0, 510},
+            {"retention",  required_argument,  0, 511},
+            {"deadline",  required_argument,  0, 512},
+            {"mem-limit",  required_argument,  0, 513},
+            {"parse-threads",  required_argument,  0, 514},
+            {"write-snapshot",  required_argument,  0, 515},
+            {"encode-threads",  required_argument,  0, 516},
+            {"enc-policy",  required_argument,  0, 517},
             {0, 0, 0, 0}
                 };
         int c;
@@ -279,11 +396,48 @@ namespace leximaxIST {
                 case 502: read_integer(optarg, "--mss-tol", m_mss_tol.get_data()); break;
                 case 503: read_double(optarg, "--timeout", m_timeout.get_data()); break;
                 case 504: read_digit(optarg, "--mss-add-cls", m_mss_add_cls.get_data()); break;
-                case 505: read_digit(optarg, "--pb-enc", m_pb_enc.get_data()); break;
-                case 506: read_digit(optarg, "--card-enc", m_card_enc.get_data()); break;
+                case 505:
+                    if (std::string(optarg) == "auto")
+                        m_pb_enc.get_data() = _PB_AUTO_;
+                    else
+                        read_digit(optarg, "--pb-enc", m_pb_enc.get_data());
+                    break;
+                case 506:
+                    if (std::string(optarg) == "auto")
+                        m_card_enc.get_data() = _CARD_AUTO_;
+                    else
+                        read_digit(optarg, "--card-enc", m_card_enc.get_data());
+                    break;
                 case 507: m_ilp_solver.get_data() = optarg; break;
                 case 508: read_digit(optarg, "--input-file-type", m_input_file_type.get_data()); break;
                 case 509: m_maxpre_techniques.get_data() = optarg; break;
+                case 510: m_sorter.get_data() = optarg; break;
+                case 511: m_retention.get_data() = optarg; break;
+                case 512: read_double(optarg, "--deadline", m_deadline.get_data()); break;
+                case 513: read_double(optarg, "--mem-limit", m_mem_limit.get_data()); break;
+                case 514:
+                    read_integer(optarg, "--parse-threads", m_parse_threads.get_data());
+                    if (m_parse_threads.get_data() < 1) {
+                        print_error_msg("Option '--parse-threads' must be a positive integer");
+                        exit(EXIT_FAILURE);
+                    }
+                    break;
+                case 515: m_write_snapshot.get_data() = optarg; break;
+                case 516:
+                    read_integer(optarg, "--encode-threads", m_encode_threads.get_data());
+                    if (m_encode_threads.get_data() < 1) {
+                        print_error_msg("Option '--encode-threads' must be a positive integer");
+                        exit(EXIT_FAILURE);
+                    }
+                    break;
+                case 517:
+                    m_enc_policy.get_data() = optarg;
+                    if (optarg != std::string("strong") && optarg != std::string("balanced") &&
+                        optarg != std::string("size")) {
+                        print_error_msg("Option '--enc-policy' must be 'strong', 'balanced' or 'size'");
+                        exit(EXIT_FAILURE);
+                    }
+                    break;
                 case '?':
                     if (isprint (optopt))
                         fprintf (stderr, "Unknown option `-%c'.\n", optopt);
@@ -326,9 +480,16 @@ namespace leximaxIST {
         os << m_optimise.get_description();
         os << m_ilp_solver.get_description();
         os << m_disjoint_cores.get_description();
+        os << m_maxsat_presolve.get_description();
+        os << m_half_comparators.get_description();
+        os << m_sorter.get_description();
+        os << m_retention.get_description();
         os << m_leave_tmp_files.get_description();
+        os << m_gzip_input.get_description();
         os << m_approx.get_description();
         os << m_timeout.get_description();
+        os << m_deadline.get_description();
+        os << m_mem_limit.get_description();
         os << m_mss_incr.get_description();
         os << m_mss_add_cls.get_description();
         os << m_mss_tol.get_description();
@@ -336,7 +497,11 @@ namespace leximaxIST {
         os << m_gia_pareto.get_description();
         os << m_pb_enc.get_description();
         os << m_card_enc.get_description();
+        os << m_enc_policy.get_description();
         os << m_input_file_type.get_description();
+        os << m_parse_threads.get_description();
+        os << m_encode_threads.get_description();
+        os << m_write_snapshot.get_description();
         os << m_preprocessing.get_description();
         os << m_maxpre_techniques.get_description();
     }
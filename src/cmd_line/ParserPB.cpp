@@ -26,10 +26,13 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <unistd.h>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <ParserPB.h>
 #include <leximaxIST_printing.h>
 
@@ -39,7 +42,8 @@ using namespace leximaxIST;
 // Constructor/destructor.
 //-------------------------------------------------------------------------
 
-ParserPB::ParserPB(MaxSATFormula *m) : _highestCoeffSum(0), maxsat_formula(m) {}
+ParserPB::ParserPB(MaxSATFormula *m, int nThreads)
+    : _nThreads(nThreads), _highestCoeffSum(0), maxsat_formula(m) {}
 
 ParserPB::~ParserPB() {}
 
@@ -77,15 +81,17 @@ int ParserPB::parse(const char *fileName) {
   if (strlen(_fileStr) != (unsigned)statbuf.st_size)
     _fileStr[statbuf.st_size] = '\0';
 
-  int line = 0;
-  while (peek_char() != '\0') {
-    int error = parseLine();
-
+  // below this size the threads do not pay off
+  const off_t minParallelSize = 1 << 24;
+  if (_nThreads > 1 && statbuf.st_size >= minParallelSize)
+    parseChunks(_fileStr, _fileStr + statbuf.st_size);
+  else {
+    int line = 0;
+    const int error = parseLines(_fileStr + statbuf.st_size, &line);
     if (error != 0) {
-        print_error_msg("Parse Error " + std::to_string(error) + " in line " + std::to_string(++line));
+        print_error_msg("Parse Error " + std::to_string(error) + " in line " + std::to_string(line));
         exit(EXIT_FAILURE);
     }
-    line++;
   }
 
   // Clear memory map of input file.
@@ -101,6 +107,157 @@ int ParserPB::parse(const char *fileName) {
 // PROTECTED
 //-------------------------------------------------------------------------
 
+//! Parse the lines from the current position up to last.
+/*!
+  \param line Incremented for each line, so it is the line of the error if
+  there is one.
+  \return Returns 0 or the code of the first parse error.
+*/
+
+int ParserPB::parseLines(const char *last, int *line) {
+  while (_fileStr < last && peek_char() != '\0') {
+    ++*line;
+    const int error = parseLine();
+    if (error != 0)
+      return error;
+  }
+  return 0;
+}
+
+namespace {
+
+// Parser of a chunk of lines of the file into its own formula, used by
+// ParserPB::parseChunks. The variables are numbered by their first occurrence
+// in the chunk and names[v - 1] is the name of variable v.
+class ChunkParserPB : public ParserPB {
+public:
+  ChunkParserPB() : ParserPB(&formula) {}
+
+  int parseChunk(char *first, const char *last) {
+    _fileStr = first;
+    return parseLines(last, &line);
+  }
+
+  MaxSATFormula formula;
+  std::vector<std::string> names;
+  int line = 0;
+
+protected:
+  int getVariableID(char *varName, int) override {
+    const auto it = ids.emplace(std::string(varName), names.size() + 1);
+    if (it.second)
+      names.push_back(it.first->first);
+    return it.first->second;
+  }
+
+private:
+  std::unordered_map<std::string, int> ids;
+};
+
+// true if the line that ends at nl is a complete statement (ends with ';')
+bool endsStatement(const char *first, const char *nl) {
+  while (nl != first && (nl[-1] == ' ' || nl[-1] == '\t' || nl[-1] == '\r'))
+    --nl;
+  return nl != first && nl[-1] == ';';
+}
+
+} // namespace
+
+//! Parse the file in [first, last) with _nThreads threads.
+/*!
+  The file is split after lines that end a statement (an objective function
+  may span several lines), several chunks per thread to balance the load.
+  Each chunk is parsed into the formula of a ChunkParserPB, with its own
+  variable ids. The chunks are then merged in the order of the file: the
+  variables are registered in maxsat_formula in the order of their first
+  occurrence, so the variable ids and the order of the constraints are the
+  same as in the sequential parse, whatever the number of threads.
+*/
+
+void ParserPB::parseChunks(char *first, char *last) {
+  const size_t nChunks = 4 * _nThreads;
+  const size_t target = (last - first) / nChunks;
+  std::vector<char *> bounds(1, first);
+  for (size_t i = 1; i < nChunks; ++i) {
+    const char *p = std::max(bounds.back(), first + i * target);
+    const char *nl;
+    while ((nl = static_cast<const char *>(memchr(p, '\n', last - p))) != nullptr &&
+           !endsStatement(bounds.back(), nl))
+      p = nl + 1;
+    if (nl == nullptr)
+      break;
+    bounds.push_back(first + (nl + 1 - first));
+  }
+  bounds.push_back(last);
+
+  std::vector<ChunkParserPB> chunks(bounds.size() - 1);
+  std::vector<int> errors(chunks.size(), 0);
+  std::atomic<size_t> next(0);
+  auto parseWorker = [&]() {
+    for (size_t c = next++; c < chunks.size(); c = next++)
+      errors[c] = chunks[c].parseChunk(bounds[c], bounds[c + 1]);
+  };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < _nThreads; ++t)
+    threads.emplace_back(parseWorker);
+  for (std::thread &t : threads)
+    t.join();
+
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    if (errors[c] != 0) {
+      int line = chunks[c].line;
+      for (const char *p = first; p != bounds[c]; ++p)
+        line += *p == '\n';
+      print_error_msg("Parse Error " + std::to_string(errors[c]) + " in line " + std::to_string(line));
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // the global ids, in the order of the file
+  // the ids of the names x<n> are kept in a vector indexed by n and the other ones in a hash map
+  // (each variable occurs in many chunks, so the lookups would dominate in the map of maxsat_formula)
+  size_t nNames = 0;
+  for (const ChunkParserPB &chunk : chunks)
+    nNames += chunk.names.size();
+  std::vector<int> xIds;
+  std::unordered_map<std::string, int> otherIds;
+  auto globalId = [&](const std::string &name) {
+    int *id = nullptr;
+    if (name.size() > 1 && name.size() < 10 && name[0] == 'x' && (name[1] != '0' || name.size() == 2) &&
+        std::all_of(name.begin() + 1, name.end(), [](char ch) { return ch >= '0' && ch <= '9'; })) {
+      const size_t n = std::stoul(name.substr(1));
+      if (n <= 4 * nNames) {
+        if (n >= xIds.size())
+          xIds.resize(std::max(n + 1, 2 * xIds.size()), 0);
+        id = &xIds[n];
+      }
+    }
+    if (id == nullptr)
+      id = &otherIds[name];
+    if (*id == 0)
+      *id = maxsat_formula->newVarName(name);
+    return *id;
+  };
+  std::vector<std::vector<int>> varMaps(chunks.size());
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    varMaps[c].resize(chunks[c].names.size() + 1, 0);
+    for (size_t v = 1; v < varMaps[c].size(); ++v)
+      varMaps[c][v] = globalId(chunks[c].names[v - 1]);
+  }
+  next = 0;
+  auto renameWorker = [&]() {
+    for (size_t c = next++; c < chunks.size(); c = next++)
+      chunks[c].formula.renameVars(varMaps[c]);
+  };
+  threads.clear();
+  for (int t = 0; t < _nThreads; ++t)
+    threads.emplace_back(renameWorker);
+  for (std::thread &t : threads)
+    t.join();
+  for (ChunkParserPB &chunk : chunks)
+    maxsat_formula->append(chunk.formula);
+}
+
 //! Parse an input file line
 
 int ParserPB::parseLine() {
@@ -135,7 +292,7 @@ int ParserPB::parseCostFunction() {
 //     printf("ParserPB::parseCostFunction\n");
 
   // int objective = _PB_MIN_;
-  static char word[MAX_WORD_LENGTH];
+  char word[MAX_WORD_LENGTH];
   int i;
 
   // printf("c Parsing objective function...\n");
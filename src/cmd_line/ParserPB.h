@@ -66,7 +66,8 @@ public:
   // Constructor/destructor.
   //-------------------------------------------------------------------------
 
-  ParserPB(MaxSATFormula *m);
+  // with nThreads > 1, large files are split into chunks of lines that are parsed in parallel
+  ParserPB(MaxSATFormula *m, int nThreads = 1);
   virtual ~ParserPB();
 
   //-------------------------------------------------------------------------
@@ -84,6 +85,8 @@ public:
 
 protected:
   // OPB instance parsing.
+  int parseLines(const char *last, int *line);
+  void parseChunks(char *first, char *last);
   virtual int parseLine();
   virtual int parseCostFunction();
   virtual int parseConstraint();
@@ -101,15 +104,14 @@ protected:
   }
 
   inline void readUntilEndOfLine() {
-    static char c;
+    char c;
     while ((c = get_char()) != '\n' && c != '\0')
       ;
   }
 
   inline void parseNumber(int64_t *coeff) {
-    static char word[MAX_WORD_LENGTH];
+    char word[MAX_WORD_LENGTH];
     int i = 0, c = peek_char();
-    int64_t conv;
 
     *coeff = 1;
     while ((c == '-') || (c == '+')) {
@@ -127,11 +129,8 @@ protected:
 //     printf("char: %c\n", *(_fileStr)); 
     assert(i > 0);
 
-    std::istringstream ss(word);
-    ss >> conv;
-
-    // sscanf(word, "%d", &i);
-    *coeff = (*coeff) * conv;
+    // strtoll instead of a std::istringstream, which copies the global locale (contended by the parsing threads)
+    *coeff = (*coeff) * strtoll(word, nullptr, 10);
   }
 
   inline void parseWord(char *varName, int *varNameSize) {
@@ -153,6 +152,7 @@ protected:
 
   char *_fileStr;
   int _fd;
+  int _nThreads;
 
   std::vector<int64_t> _coefficients;
   std::vector<int> _constraintVariables;
@@ -0,0 +1,77 @@
+#ifndef ClauseBuffer_h
+#define ClauseBuffer_h
+
+#include <leximaxIST_types.h>
+#include <leximaxIST_ClauseArena.h>
+#include <leximaxIST_printing.h>
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+
+namespace leximaxIST {
+
+// thrown by a counting ClauseBuffer when the encoding has more clauses than its limit
+struct ClauseLimitReached {};
+
+//=================================================================================================
+/* Destination of the clauses of the PB and cardinality encodings.
+ * The variables up to nb_input_vars are the variables of the formula and the fresh variables
+ * are numbered from nb_input_vars + 1 in each buffer, so that several buffers can be filled
+ * independently and their fresh variables moved to disjoint ranges afterwards (shift_fresh).
+ * A counting buffer (counter) does not keep the clauses, it is used to predict the size of an encoding.
+ */
+class ClauseBuffer {
+
+public:
+  ClauseBuffer(int nb_input_vars = 0)
+      : m_nb_input_vars(nb_input_vars), m_id_count(nb_input_vars), m_count_only(false),
+        m_limit(0), m_nb_counted(0) {}
+
+  // The encoding is interrupted with ClauseLimitReached when it has more than limit clauses
+  static ClauseBuffer counter(size_t limit) {
+    ClauseBuffer buffer;
+    buffer.m_count_only = true;
+    buffer.m_limit = limit;
+    return buffer;
+  }
+
+  // Same interface as leximaxIST::Solver, used by the encodings
+  int fresh() {
+    if (m_id_count == INT_MAX) {
+      print_error_msg("The number of variables exceeded INT_MAX");
+      exit(EXIT_FAILURE);
+    }
+    return ++m_id_count;
+  }
+  void add_hard_clause(const Clause &cl) {
+    if (!m_count_only)
+      m_clauses.push_back(cl);
+    else if (++m_nb_counted > m_limit)
+      throw ClauseLimitReached();
+  }
+
+  int nb_input_vars() const { return m_nb_input_vars; }
+  int nb_fresh() const { return m_id_count - m_nb_input_vars; }
+  size_t nb_clauses() const { return m_count_only ? m_nb_counted : m_clauses.size(); }
+  const ClauseArena &clauses() const { return m_clauses; }
+
+  // Add offset to the fresh variables
+  void shift_fresh(int offset) { m_clauses.shift_vars(m_nb_input_vars, offset); }
+
+  void clear() {
+    m_clauses = ClauseArena();
+    m_id_count = m_nb_input_vars;
+    m_nb_counted = 0;
+  }
+
+protected:
+  int m_nb_input_vars;
+  int m_id_count; // last fresh variable
+  ClauseArena m_clauses;
+  bool m_count_only;
+  size_t m_limit;
+  size_t m_nb_counted;
+};
+} // namespace leximaxIST
+
+#endif
@@ -33,7 +33,7 @@
 
 using namespace leximaxIST;
 
-void Adder::FA_extra ( leximaxIST::Solver &S, Lit xc, Lit xs, Lit a, Lit b, Lit c )
+void Adder::FA_extra ( leximaxIST::ClauseBuffer &S, Lit xc, Lit xs, Lit a, Lit b, Lit c )
 {
   clause.clear();
   addTernaryClause(S, -xc, -xs, a);
@@ -46,7 +46,7 @@ void Adder::FA_extra ( leximaxIST::Solver &S, Lit xc, Lit xs, Lit a, Lit b, Lit
 }
 
 
-Lit Adder::FA_carry ( leximaxIST::Solver &S, Lit a, Lit b, Lit c ) {
+Lit Adder::FA_carry ( leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c ) {
   
   //Lit x = mkLit(S.newVar(), false);
     Lit x = S.fresh();
@@ -62,7 +62,7 @@ Lit Adder::FA_carry ( leximaxIST::Solver &S, Lit a, Lit b, Lit c ) {
   return x;
 }
 
-Lit Adder::FA_sum ( leximaxIST::Solver &S, Lit a, Lit b, Lit c )
+Lit Adder::FA_sum ( leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c )
 {
     //Lit x = mkLit(S.newVar(), false);
     Lit x (S.fresh());
@@ -80,7 +80,7 @@ Lit Adder::FA_sum ( leximaxIST::Solver &S, Lit a, Lit b, Lit c )
     return x;
 }
 
-Lit Adder::HA_carry ( leximaxIST::Solver &S, Lit a, Lit b) // a AND b
+Lit Adder::HA_carry ( leximaxIST::ClauseBuffer &S, Lit a, Lit b) // a AND b
 {  
   //Lit x = mkLit(S.newVar(), false);
     Lit x (S.fresh());
@@ -92,7 +92,7 @@ Lit Adder::HA_carry ( leximaxIST::Solver &S, Lit a, Lit b) // a AND b
   return x;
 }
 
-Lit Adder::HA_sum ( leximaxIST::Solver &S, Lit a, Lit b ) // a XOR b
+Lit Adder::HA_sum ( leximaxIST::ClauseBuffer &S, Lit a, Lit b ) // a XOR b
 {
   //Lit x = mkLit(S.newVar(), false);
     Lit x (S.fresh());
@@ -107,7 +107,7 @@ Lit Adder::HA_sum ( leximaxIST::Solver &S, Lit a, Lit b ) // a XOR b
 }
 
 
-void Adder::adderTree (leximaxIST::Solver &S, std::vector< std::queue< Lit > > & buckets, std::vector< Lit >& result ) {
+void Adder::adderTree (leximaxIST::ClauseBuffer &S, std::vector< std::queue< Lit > > & buckets, std::vector< Lit >& result ) {
   Lit x,y,z;
   Lit u = lit_Undef;
 
@@ -153,7 +153,7 @@ void Adder::adderTree (leximaxIST::Solver &S, std::vector< std::queue< Lit > > &
   // Generates clauses for “xs <= ys”, assuming ys has only constant signals (0 or 1).
 // xs and ys must have the same size
 
-void Adder::lessThanOrEqual (leximaxIST::Solver &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys) {
+void Adder::lessThanOrEqual (leximaxIST::ClauseBuffer &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys) {
   assert ( (size_t)xs.size() == ys.size() );
   std::vector<Lit> clause;
   bool skip;
@@ -199,7 +199,7 @@ void Adder::lessThanOrEqual (leximaxIST::Solver &S, std::vector< Lit > & xs, std
 
 }
 
-void Adder::lessThanOrEqualInc (leximaxIST::Solver &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys, std::vector<Lit>& assumptions) {
+void Adder::lessThanOrEqualInc (leximaxIST::ClauseBuffer &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys, std::vector<Lit>& assumptions) {
   assert ( (size_t)xs.size() == ys.size() );
   std::vector<Lit> clause;
   bool skip;
@@ -267,9 +267,27 @@ void Adder::numToBits ( std::vector<uint64_t> & bits, uint64_t n, uint64_t numbe
   std::reverse ( bits.begin(), bits.end() );
 }
 
-void Adder::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs){
+void Adder::encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs){
 
     _output.clear();
+    _buckets.clear();
+
+    // Fix literals that have a coeff larger than rhs, the adder tree only
+    // has the bits of rhs.
+    std::vector<Lit> simp_lits;
+    std::vector<uint64_t> simp_coeffs;
+    for (int i = 0; i < lits.size(); i++) {
+      if (coeffs[i] > rhs)
+        addUnitClause(S, -lits[i]);
+      else if (coeffs[i] != 0) {
+        simp_lits.push_back(lits[i]);
+        simp_coeffs.push_back(coeffs[i]);
+      }
+    }
+    if (simp_lits.empty())
+      return;
+    lits.swap(simp_lits);
+    coeffs.swap(simp_coeffs);
 
     uint64_t nb = ld64(rhs); // number of bits
     Lit u = lit_Undef;
@@ -293,7 +311,7 @@ void Adder::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<ui
     hasEncoding = true;
 }
 
-void Adder::encodeInc(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs, std::vector<Lit> &assumptions){
+void Adder::encodeInc(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs, std::vector<Lit> &assumptions){
     _output.clear();
 
     uint64_t nb = ld64(rhs); // number of bits
@@ -318,14 +336,14 @@ void Adder::encodeInc(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector
 
 }
 
-void Adder::updateInc(leximaxIST::Solver &S, uint64_t rhs, std::vector<Lit>& assumptions){
+void Adder::updateInc(leximaxIST::ClauseBuffer &S, uint64_t rhs, std::vector<Lit>& assumptions){
       
       std::vector<uint64_t> kBits;
       numToBits (kBits, _buckets.size(), rhs );
       lessThanOrEqualInc (S, _output, kBits, assumptions);
 }
 
-void Adder::update(leximaxIST::Solver &S, uint64_t rhs){
+void Adder::update(leximaxIST::ClauseBuffer &S, uint64_t rhs){
       
       std::vector<uint64_t> kBits;
       numToBits (kBits, _buckets.size(), rhs );
@@ -31,7 +31,7 @@
 
 #include <Encodings.h>
 #include <leximaxIST_types.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 #include <map>
 #include <utility>
 #include <vector>
@@ -47,16 +47,16 @@ public:
   ~Adder() {}
 
   // Encode constraint.
-  void encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
+  void encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
 
   // Update constraint.
-  void update(leximaxIST::Solver &S, uint64_t rhs);
+  void update(leximaxIST::ClauseBuffer &S, uint64_t rhs);
 
   // Returns true if the encoding was built, otherwise returns false;
   bool hasCreatedEncoding() { return hasEncoding; }
 
-  void encodeInc(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs, std::vector<Lit> &assumptions);
-  void updateInc(leximaxIST::Solver &S, uint64_t rhs, std::vector<Lit>& assumptions);
+  void encodeInc(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs, std::vector<Lit> &assumptions);
+  void updateInc(leximaxIST::ClauseBuffer &S, uint64_t rhs, std::vector<Lit>& assumptions);
 
 
 protected:
@@ -65,17 +65,17 @@ protected:
   std::vector<Lit> clause;
   std::vector<std::queue<Lit> > _buckets;
 
-  void FA_extra ( leximaxIST::Solver &S, Lit xc, Lit xs, Lit a, Lit b, Lit c );
-  Lit FA_carry ( leximaxIST::Solver &S, Lit a, Lit b, Lit c );
-  Lit FA_sum ( leximaxIST::Solver &S, Lit a, Lit b, Lit c );
-  Lit HA_carry ( leximaxIST::Solver &S, Lit a, Lit b);
-  Lit HA_sum ( leximaxIST::Solver &S, Lit a, Lit b );
-  void adderTree (leximaxIST::Solver &S, std::vector< std::queue< Lit > > & buckets, std::vector< Lit >& result );
-  void lessThanOrEqual (leximaxIST::Solver &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys);
+  void FA_extra ( leximaxIST::ClauseBuffer &S, Lit xc, Lit xs, Lit a, Lit b, Lit c );
+  Lit FA_carry ( leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c );
+  Lit FA_sum ( leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c );
+  Lit HA_carry ( leximaxIST::ClauseBuffer &S, Lit a, Lit b);
+  Lit HA_sum ( leximaxIST::ClauseBuffer &S, Lit a, Lit b );
+  void adderTree (leximaxIST::ClauseBuffer &S, std::vector< std::queue< Lit > > & buckets, std::vector< Lit >& result );
+  void lessThanOrEqual (leximaxIST::ClauseBuffer &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys);
   void numToBits ( std::vector<uint64_t> & bits, uint64_t n, uint64_t number );
   uint64_t ld64(const uint64_t x);
 
-  void lessThanOrEqualInc (leximaxIST::Solver &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys, std::vector<Lit>& assumptions);
+  void lessThanOrEqualInc (leximaxIST::ClauseBuffer &S, std::vector< Lit > & xs, std::vector< uint64_t > & ys, std::vector<Lit>& assumptions);
 
 
 	#define wbsplit(half,wL,wR, ws,bs, wsL,bsL, wsR,bsR) \
@@ -94,21 +94,21 @@ protected:
   }
 
 	void genWarnersFull(Lit& a, Lit& b, Lit& c, Lit& carry, Lit& sum, int comp,
-		       leximaxIST::Solver &S, std::vector<Lit>& lits);
+		       leximaxIST::ClauseBuffer &S, std::vector<Lit>& lits);
 
 	void genWarnersHalf(Lit& a, Lit& b, Lit& carry, Lit& sum, int comp,
-		       leximaxIST::Solver &S, std::vector<Lit>& lits);
+		       leximaxIST::ClauseBuffer &S, std::vector<Lit>& lits);
 
 	void genWarners(std::vector<uint64_t>& weights, std::vector<Lit>& blockings,
 		uint64_t max, int k,
-		int comp, leximaxIST::Solver &S, const Lit zero,
+		int comp, leximaxIST::ClauseBuffer &S, const Lit zero,
 		std::vector<Lit>& lits, std::vector<Lit>& linkingVar);
 
 	void genWarners0(std::vector<uint64_t>& weights, std::vector<Lit>& blockings,
-		 uint64_t max,uint64_t k, int comp, leximaxIST::Solver &S,
+		 uint64_t max,uint64_t k, int comp, leximaxIST::ClauseBuffer &S,
 		  std::vector<Lit>& lits, std::vector<Lit>& linkingVar);
 
-	void lessthan(std::vector<Lit>& linking, uint64_t k, std::vector<uint64_t>& cc, leximaxIST::Solver &S, std::vector<Lit>& lits);
+	void lessthan(std::vector<Lit>& linking, uint64_t k, std::vector<uint64_t>& cc, leximaxIST::ClauseBuffer &S, std::vector<Lit>& lits);
 
 	std::vector<uint64_t> cc;
 	std::vector<Lit> linkingVar;
@@ -123,7 +123,7 @@ protected:
 }
 
 // koshi 20140121
-void wbFilter(uint64_t UB, leximaxIST::Solver &S,std::vector<Lit>& lits,
+void wbFilter(uint64_t UB, leximaxIST::ClauseBuffer &S,std::vector<Lit>& lits,
 	      std::vector<uint64_t>& weights, std::vector<Lit>& blockings,
 	      std::vector<uint64_t>& sweights, std::vector<Lit>& sblockings) {
   sweights.clear(); sblockings.clear();
@@ -57,7 +57,7 @@ using namespace leximaxIST;
   |    * 'S' is updated with the clauses that encode the cardinality constraint.
   |
   |________________________________________________________________________________________________@*/
-void CNetworks::encode(leximaxIST::Solver &S, const std::vector<Lit> &lits, int64_t rhs) {
+void CNetworks::encode(leximaxIST::ClauseBuffer &S, const std::vector<Lit> &lits, int64_t rhs) {
 
   assert(rhs >= 0);
   assert(lits.size() > 0);
@@ -135,7 +135,7 @@ void CNetworks::encode(leximaxIST::Solver &S, const std::vector<Lit> &lits, int6
   |    * 'current_cardinality_rhs' is updated.
   |
   |________________________________________________________________________________________________@*/
-void CNetworks::update(leximaxIST::Solver &S, int64_t rhs) {
+void CNetworks::update(leximaxIST::ClauseBuffer &S, int64_t rhs) {
 
   assert(current_cardinality_rhs != -1);
   assert(cardinality_outlits.size() != 0 && rhs < cardinality_outlits.size());
@@ -152,7 +152,7 @@ void CNetworks::update(leximaxIST::Solver &S, int64_t rhs) {
 //
 ************************************************************************************************/
 
-void CNetworks::CN_hmerge(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s,
+void CNetworks::CN_hmerge(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s,
                           std::vector<Lit> &c_s) {
 
   assert(a_s.size() == b_s.size());
@@ -217,7 +217,7 @@ void CNetworks::CN_hmerge(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vec
   }
 }
 
-void CNetworks::CN_hsort(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s) {
+void CNetworks::CN_hsort(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s) {
   assert(a_s.size() == c_s.size());
 
   if (a_s.size() == 2) {
@@ -253,7 +253,7 @@ void CNetworks::CN_hsort(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vect
   }
 }
 
-void CNetworks::CN_smerge(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s,
+void CNetworks::CN_smerge(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s,
                           std::vector<Lit> &c_s) {
 
   assert(a_s.size() == b_s.size());
@@ -316,7 +316,7 @@ void CNetworks::CN_smerge(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vec
   }
 }
 
-void CNetworks::CN_encode(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s,
+void CNetworks::CN_encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s,
                           int64_t rhs) {
   assert(a_s.size() % rhs == 0);
   assert(c_s.size() == rhs);
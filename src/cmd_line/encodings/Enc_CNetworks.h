@@ -24,7 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <Encodings.h>
 #include <leximaxIST_types.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 
 namespace leximaxIST {
 
@@ -36,18 +36,18 @@ public:
   }
   ~CNetworks() {}
 
-  void encode(leximaxIST::Solver &S, const std::vector<Lit> &lits, int64_t rhs);
-  void update(leximaxIST::Solver &S, int64_t rhs);
+  void encode(leximaxIST::ClauseBuffer &S, const std::vector<Lit> &lits, int64_t rhs);
+  void update(leximaxIST::ClauseBuffer &S, int64_t rhs);
 
   bool hasCreatedEncoding() { return hasEncoding; }
 
 protected:
   // Auxiliary methods for the cardinality network encoding:
   //
-  void CN_hmerge(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s, std::vector<Lit> &c_s);
-  void CN_hsort(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s);
-  void CN_smerge(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s, std::vector<Lit> &c_s);
-  void CN_encode(leximaxIST::Solver &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s, int64_t rhs);
+  void CN_hmerge(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s, std::vector<Lit> &c_s);
+  void CN_hsort(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s);
+  void CN_smerge(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &b_s, std::vector<Lit> &c_s);
+  void CN_encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &a_s, std::vector<Lit> &c_s, int64_t rhs);
 
   // Stores the current value of the rhs of the cardinality constraint.
   int64_t current_cardinality_rhs;
@@ -40,14 +40,14 @@ struct less_than_wlitt {
   }
 };
 
-Lit GTE::getNewLit(leximaxIST::Solver &S) {
+Lit GTE::getNewLit(leximaxIST::ClauseBuffer &S) {
   //Lit p = mkLit(S.nVars(), false);
   //newSATVariable(S);
   nb_variables++;
   return S.fresh();
 }
 
-Lit GTE::get_var(leximaxIST::Solver &S, wlit_mapt &oliterals, uint64_t weight) {
+Lit GTE::get_var(leximaxIST::ClauseBuffer &S, wlit_mapt &oliterals, uint64_t weight) {
   wlit_mapt::iterator it = oliterals.find(weight);
   if (it == oliterals.end()) {
     Lit v = getNewLit(S);
@@ -56,7 +56,7 @@ Lit GTE::get_var(leximaxIST::Solver &S, wlit_mapt &oliterals, uint64_t weight) {
   return oliterals[weight];
 }
 
-bool GTE::encodeLeq(uint64_t k, leximaxIST::Solver &S, const weightedlitst &iliterals,
+bool GTE::encodeLeq(uint64_t k, leximaxIST::ClauseBuffer &S, const weightedlitst &iliterals,
                     wlit_mapt &oliterals) {
 
   if (iliterals.size() == 0 || k == 0){
@@ -190,7 +190,7 @@ bool GTE::encodeLeq(uint64_t k, leximaxIST::Solver &S, const weightedlitst &ilit
 
 
 
-void GTE::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+void GTE::encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
                  uint64_t rhs) {
   // FIXME: do not change coeffs in this method. Make coeffs const.
     /*
@@ -294,15 +294,10 @@ void GTE::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint
 
   current_pb_rhs = rhs;
   hasEncoding = true;
-  printf("c lgte nvars nclauses nvars_root\n"); 
-  printf("c gte\t%d\t%d\t%lu\n", nb_variables, nb_clauses, pb_oliterals.size());
-
-  
   //DPRINTF("\tc ncs, nvs:\t%d\t%d\n", nb_clauses, nb_variables);
-  fflush(stdout);
 }
 
-void GTE::update(leximaxIST::Solver &S, uint64_t rhs) {
+void GTE::update(leximaxIST::ClauseBuffer &S, uint64_t rhs) {
 
   assert(hasEncoding);
   for (wlit_mapt::reverse_iterator rit = pb_oliterals.rbegin();
@@ -324,7 +319,7 @@ void GTE::update(leximaxIST::Solver &S, uint64_t rhs) {
 // TODO: refactor the code to reduce duplication for the predict methods
 
 // predict number of variables and clauses that this encode will generate
-Lit GTE::get_var_predict(leximaxIST::Solver &S, wlit_mapt &oliterals, uint64_t weight) {
+Lit GTE::get_var_predict(leximaxIST::ClauseBuffer &S, wlit_mapt &oliterals, uint64_t weight) {
   wlit_mapt::iterator it = oliterals.find(weight);
   if (it == oliterals.end()) {
     //Lit v = mkLit(nb_current_variables, false);
@@ -335,7 +330,7 @@ Lit GTE::get_var_predict(leximaxIST::Solver &S, wlit_mapt &oliterals, uint64_t w
   return oliterals[weight];
 }
 
-bool GTE::predictEncodeLeq(uint64_t k, leximaxIST::Solver &S, const weightedlitst &iliterals,
+bool GTE::predictEncodeLeq(uint64_t k, leximaxIST::ClauseBuffer &S, const weightedlitst &iliterals,
                     wlit_mapt &oliterals) {
 
 
@@ -442,7 +437,7 @@ bool GTE::predictEncodeLeq(uint64_t k, leximaxIST::Solver &S, const weightedlits
   return true;
 }
 
-int GTE::predict(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+int GTE::predict(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
                  uint64_t rhs) {
 
   std::vector<Lit> simp_lits (lits); // copy constructor
@@ -480,7 +475,8 @@ int GTE::predict(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint
   less_than_wlitt lt_wlit;
   std::sort(iliterals.begin(), iliterals.end(), lt_wlit);
   wlit_mapt oliterals;
-  predictEncodeLeq(rhs + 1, S, iliterals, oliterals);
+  if (predictEncodeLeq(rhs + 1, S, iliterals, oliterals) && oliterals.rbegin()->first > rhs)
+    nb_clauses_expected++; // encode makes the output of weight rhs + 1 false with a unit clause
   return nb_clauses_expected;
 
 }
@@ -29,7 +29,7 @@
 #define Enc_GTE_h
 
 #include <leximaxIST_types.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 #include <Encodings.h>
 #include <map>
 #include <utility>
@@ -69,19 +69,19 @@ public:
   ~GTE() {}
 
   // Encode constraint.
-  void encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
+  void encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
   
   // Encode constraint.
   void encode(std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
 
   // Update constraint.
-  void update(leximaxIST::Solver &S, uint64_t rhs);
+  void update(leximaxIST::ClauseBuffer &S, uint64_t rhs);
 
   // Returns true if the encoding was built, otherwise returns false;
   bool hasCreatedEncoding() { return hasEncoding; }
 
   // Predicts the number of auxiliary clauses for the GTE encoding
-  int predict(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
+  int predict(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
   
   wlit_mapt getRootLits() { return pb_oliterals; } 
   
@@ -95,13 +95,13 @@ public:
 protected:
   void printLit(Lit l) { std::cout << l << '\n'; }
 
-  bool encodeLeq(uint64_t k, leximaxIST::Solver &S, const weightedlitst &iliterals,
+  bool encodeLeq(uint64_t k, leximaxIST::ClauseBuffer &S, const weightedlitst &iliterals,
                  wlit_mapt &oliterals);
-  Lit getNewLit(leximaxIST::Solver &S);
-  Lit get_var(leximaxIST::Solver &S, wlit_mapt &oliterals, uint64_t weight);
-  bool predictEncodeLeq(uint64_t k, leximaxIST::Solver &S, const weightedlitst &iliterals,
+  Lit getNewLit(leximaxIST::ClauseBuffer &S);
+  Lit get_var(leximaxIST::ClauseBuffer &S, wlit_mapt &oliterals, uint64_t weight);
+  bool predictEncodeLeq(uint64_t k, leximaxIST::ClauseBuffer &S, const weightedlitst &iliterals,
                         wlit_mapt &oliterals);
-  Lit get_var_predict(leximaxIST::Solver &S, wlit_mapt &oliterals, uint64_t weight);
+  Lit get_var_predict(leximaxIST::ClauseBuffer &S, wlit_mapt &oliterals, uint64_t weight);
 
   std::vector<Lit> pb_outlits; // Stores the outputs of the pseudo-Boolean constraint
                        // encoding for incremental solving.
@@ -53,7 +53,7 @@ using namespace leximaxIST;
   |    * 'S' is updated with the clauses that encode the AMO constraint.
   |
   |________________________________________________________________________________________________@*/
-void Ladder::encode(leximaxIST::Solver &S, const std::vector<Lit> &lits) {
+void Ladder::encode(leximaxIST::ClauseBuffer &S, const std::vector<Lit> &lits) {
 
   assert(lits.size() != 0);
 
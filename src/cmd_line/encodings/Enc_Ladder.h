@@ -30,7 +30,7 @@
 
 #include <Encodings.h>
 #include <leximaxIST_types.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 #include <vector>
 
 namespace leximaxIST {
@@ -41,7 +41,7 @@ public:
   Ladder() {}
   ~Ladder() {}
 
-  void encode(leximaxIST::Solver &S, const std::vector<Lit> &lits);
+  void encode(leximaxIST::ClauseBuffer &S, const std::vector<Lit> &lits);
 };
 } // namespace leximaxIST
 
@@ -55,7 +55,7 @@ using namespace leximaxIST;
   |    * 'S' is updated with the clauses that encode the cardinality constraint.
   |
   |________________________________________________________________________________________________@*/
-void MTotalizer::encode(leximaxIST::Solver &S, const std::vector<Lit> &lits, int64_t rhs) {
+void MTotalizer::encode(leximaxIST::ClauseBuffer &S, const std::vector<Lit> &lits, int64_t rhs) {
   assert(lits.size() > 0);
   hasEncoding = false;
 
@@ -140,7 +140,7 @@ void MTotalizer::encode(leximaxIST::Solver &S, const std::vector<Lit> &lits, int
   |    * 'current_cardinality_rhs' is updated.
   |
   |________________________________________________________________________________________________@*/
-void MTotalizer::update(leximaxIST::Solver &S, int64_t rhs) {
+void MTotalizer::update(leximaxIST::ClauseBuffer &S, int64_t rhs) {
   assert(current_cardinality_rhs != -1);
   assert(hasEncoding);
   encode_output(S, rhs);
@@ -153,7 +153,7 @@ void MTotalizer::update(leximaxIST::Solver &S, int64_t rhs) {
 //
 ************************************************************************************************/
 
-void MTotalizer::encode_output(leximaxIST::Solver &S, int64_t rhs) {
+void MTotalizer::encode_output(leximaxIST::ClauseBuffer &S, int64_t rhs) {
 
   assert(hasEncoding);
   assert(cardinality_upoutlits.size() != 0 ||
@@ -185,7 +185,7 @@ void MTotalizer::encode_output(leximaxIST::Solver &S, int64_t rhs) {
   }
 }
 
-void MTotalizer::toCNF(leximaxIST::Solver &S, int mod, std::vector<Lit> &ublits, std::vector<Lit> &lwlits,
+void MTotalizer::toCNF(leximaxIST::ClauseBuffer &S, int mod, std::vector<Lit> &ublits, std::vector<Lit> &lwlits,
                        int64_t rhs) {
 
   std::vector<Lit> lupper;
@@ -264,7 +264,7 @@ void MTotalizer::toCNF(leximaxIST::Solver &S, int mod, std::vector<Lit> &ublits,
     toCNF(S, mod, rupper, rlower, right * mod + (rhs - split) - right * mod);
 }
 
-void MTotalizer::adder(leximaxIST::Solver &S, int mod, std::vector<Lit> &upper, std::vector<Lit> &lower,
+void MTotalizer::adder(leximaxIST::ClauseBuffer &S, int mod, std::vector<Lit> &upper, std::vector<Lit> &lower,
                        std::vector<Lit> &lupper, std::vector<Lit> &llower, std::vector<Lit> &rupper,
                        std::vector<Lit> &rlower) {
 
@@ -29,7 +29,7 @@
 #define Enc_MTotalizer_h
 
 #include <Encodings.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 #include <leximaxIST_types.h>
 
 
@@ -45,8 +45,8 @@ public:
   }
   ~MTotalizer() {}
 
-  void encode(leximaxIST::Solver &S, const std::vector<Lit> &lits, int64_t rhs);
-  void update(leximaxIST::Solver &S, int64_t rhs);
+  void encode(leximaxIST::ClauseBuffer &S, const std::vector<Lit> &lits, int64_t rhs);
+  void update(leximaxIST::ClauseBuffer &S, int64_t rhs);
   void setModulo(int m) { modulo = m; }
 
   int getModulo() { return modulo; }
@@ -55,12 +55,12 @@ public:
 protected:
   // Auxiliary methods for the cardinality encoding:
   //
-  void toCNF(leximaxIST::Solver &S, int mod, std::vector<Lit> &ublits, std::vector<Lit> &lwlits,
+  void toCNF(leximaxIST::ClauseBuffer &S, int mod, std::vector<Lit> &ublits, std::vector<Lit> &lwlits,
              int64_t rhs);
-  void adder(leximaxIST::Solver &S, int mod, std::vector<Lit> &upper, std::vector<Lit> &lower,
+  void adder(leximaxIST::ClauseBuffer &S, int mod, std::vector<Lit> &upper, std::vector<Lit> &lower,
              std::vector<Lit> &lupper, std::vector<Lit> &llower, std::vector<Lit> &rupper,
              std::vector<Lit> &rlower);
-  void encode_output(leximaxIST::Solver &S, int64_t rhs);
+  void encode_output(leximaxIST::ClauseBuffer &S, int64_t rhs);
 
   Lit h0;     // Temporary literal for the construction of the encoding.
   int modulo; // Stores the modulo value for the encoding.
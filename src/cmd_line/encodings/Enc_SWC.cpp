@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <leximaxIST_printing.h>
 #include <cassert>
+#include <climits>
 
 using namespace leximaxIST;
 
@@ -55,7 +56,7 @@ using namespace leximaxIST;
   |      constraint.
   |
   |________________________________________________________________________________________________@*/
-void SWC::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+void SWC::encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
                  uint64_t rhs) {
   // FIXME: do not change coeffs in this method. Make coeffs const.
 
@@ -157,6 +158,51 @@ void SWC::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint
   hasEncoding = true;
 }
 
+/*_________________________________________________________________________________________________
+  |
+  |  predict : (lits : std::vector<Lit>&) (coeffs : std::vector<uint64_t>&) (rhs : uint64_t)
+  |            (nVars : int *) ->  [int]
+  |
+  |  Description:
+  |
+  |     Number of clauses and of auxiliary variables of the encode method above,
+  |     without building the encoding: the first literal has coeffs[0] clauses
+  |     and each one of the others 2 * rhs + 1.
+  |
+  |  Post-conditions:
+  |    * Returns max_clauses if the encoding has at least max_clauses clauses or
+  |      if it cannot be built (coefficients or rhs larger than INT32_MAX).
+  |
+  |________________________________________________________________________________________________@*/
+int SWC::predict(const std::vector<Lit> &lits, const std::vector<uint64_t> &coeffs, uint64_t rhs,
+                 int *nVars) {
+  *nVars = 0;
+  if (rhs >= INT32_MAX)
+    return max_clauses;
+
+  uint64_t units = 0;
+  uint64_t n = 0;
+  uint64_t clauses = 0;
+  for (int i = 0; i < lits.size(); i++) {
+    if (coeffs[i] == 0)
+      continue;
+    if (coeffs[i] >= INT32_MAX)
+      return max_clauses;
+    if (coeffs[i] > rhs) {
+      units++;
+      continue;
+    }
+    clauses += n == 0 ? coeffs[i] : 2 * rhs + 1;
+    n++;
+  }
+  if (n <= 1)
+    return units;
+
+  clauses += units;
+  *nVars = n * rhs < INT_MAX ? n * rhs : INT_MAX;
+  return clauses < max_clauses ? clauses : max_clauses;
+}
+
 /*_________________________________________________________________________________________________
   |
   |  encode : (S : Solver *) (lits : std::vector<Lit>&) (rhs : int64_t)
@@ -179,7 +225,7 @@ void SWC::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint
   |    * 'assumptions' is updated with a new set of assumptions.
   |
   |________________________________________________________________________________________________@*/
-void SWC::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs,
+void SWC::encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs,
                  std::vector<Lit> &assumptions, int size) {
 
   // If the rhs is larger than INT32_MAX is not feasible to encode this
@@ -328,7 +374,7 @@ void SWC::encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint
   |      pseudo-Boolean encoding.
   |
   |________________________________________________________________________________________________@*/
-void SWC::update(leximaxIST::Solver &S, uint64_t rhs) {
+void SWC::update(leximaxIST::ClauseBuffer &S, uint64_t rhs) {
   if (rhs >= INT32_MAX) {
       print_error_msg("Overflow in the encoding of PB constraints to CNF using SWC");
       exit(EXIT_FAILURE);
@@ -362,7 +408,7 @@ void SWC::update(leximaxIST::Solver &S, uint64_t rhs) {
   |    * 'assumptions' is updated with a new set of assumptions.
   |
   |________________________________________________________________________________________________@*/
-void SWC::update(leximaxIST::Solver &S, uint64_t rhs, std::vector<Lit> &assumptions) {
+void SWC::update(leximaxIST::ClauseBuffer &S, uint64_t rhs, std::vector<Lit> &assumptions) {
   if (rhs >= INT32_MAX) {
       print_error_msg("Overflow in the encoding of PB constraints to CNF using SWC");
       exit(EXIT_FAILURE);
@@ -460,7 +506,7 @@ void SWC::update(leximaxIST::Solver &S, uint64_t rhs, std::vector<Lit> &assumpti
   |    * 'assumptions' is updated.
   |
   |________________________________________________________________________________________________@*/
-void SWC::join(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+void SWC::join(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
                std::vector<Lit> &assumptions) {
 
   assert(current_lit_blocking != lit_Undef);
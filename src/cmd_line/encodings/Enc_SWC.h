@@ -29,7 +29,7 @@
 #define Enc_SWC_h
 
 #include <Encodings.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 
 namespace leximaxIST {
 
@@ -46,15 +46,17 @@ public:
   ~SWC() {}
 
   // Encode constraint.
-  void encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
-  void encode(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs,
+  void encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs);
+  void encode(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs, uint64_t rhs,
               std::vector<Lit> &assumptions, int size);
+  // Predicts the number of clauses and auxiliary variables of encode
+  int predict(const std::vector<Lit> &lits, const std::vector<uint64_t> &coeffs, uint64_t rhs, int *nVars);
   // Update constraint.
-  void update(leximaxIST::Solver &S, uint64_t rhs);
-  void update(leximaxIST::Solver &S, uint64_t rhs, std::vector<Lit> &assumptions);
+  void update(leximaxIST::ClauseBuffer &S, uint64_t rhs);
+  void update(leximaxIST::ClauseBuffer &S, uint64_t rhs, std::vector<Lit> &assumptions);
 
   // Update assumptions.
-  void updateAssumptions(leximaxIST::Solver &S, std::vector<Lit> &assumptions) {
+  void updateAssumptions(leximaxIST::ClauseBuffer &S, std::vector<Lit> &assumptions) {
     assumptions.push_back(-current_lit_blocking);
 
     for (int i = 0; i < unit_lits.size(); i++)
@@ -62,7 +64,7 @@ public:
   }
 
   // Join encodings.
-  void join(leximaxIST::Solver &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
+  void join(leximaxIST::ClauseBuffer &S, std::vector<Lit> &lits, std::vector<uint64_t> &coeffs,
             std::vector<Lit> &assumptions);
 
   // Returns true if the encoding was built, otherwise returns false;
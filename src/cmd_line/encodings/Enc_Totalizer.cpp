@@ -32,7 +32,7 @@
 
 using namespace leximaxIST;
 
-void Totalizer::incremental(leximaxIST::Solver &solver, int64_t rhs) {
+void Totalizer::incremental(leximaxIST::ClauseBuffer &solver, int64_t rhs) {
 
   for (int z = 0; z < totalizerIterative_rhs.size(); z++) {
 
@@ -68,7 +68,7 @@ void Totalizer::incremental(leximaxIST::Solver &solver, int64_t rhs) {
   }
 }
 
-void Totalizer::join(leximaxIST::Solver &solver, const std::vector<Lit> &lits, int64_t rhs) {
+void Totalizer::join(leximaxIST::ClauseBuffer &solver, const std::vector<Lit> &lits, int64_t rhs) {
 
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
 
@@ -106,7 +106,7 @@ void Totalizer::join(leximaxIST::Solver &solver, const std::vector<Lit> &lits, i
     ilits.push_back(lits[i]);
 }
 
-void Totalizer::adder(leximaxIST::Solver &solver, std::vector<Lit> &left, std::vector<Lit> &right,
+void Totalizer::adder(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &left, std::vector<Lit> &right,
                       std::vector<Lit> &output) {
   assert(output.size() == left.size() + right.size());
   if (incremental_strategy == _INCREMENTAL_ITERATIVE_) {
@@ -140,7 +140,7 @@ void Totalizer::adder(leximaxIST::Solver &solver, std::vector<Lit> &left, std::v
   }
 }
 
-void Totalizer::toCNF(leximaxIST::Solver &solver, std::vector<Lit> &lits) {
+void Totalizer::toCNF(leximaxIST::ClauseBuffer &solver, std::vector<Lit> &lits) {
 
   std::vector<Lit> left;
   std::vector<Lit> right;
@@ -185,7 +185,7 @@ void Totalizer::toCNF(leximaxIST::Solver &solver, std::vector<Lit> &lits) {
   adder(solver, left, right, lits);
 }
 
-void Totalizer::update(leximaxIST::Solver &solver, int64_t rhs, const std::vector<Lit> &lits,
+void Totalizer::update(leximaxIST::ClauseBuffer &solver, int64_t rhs, const std::vector<Lit> &lits,
                        std::vector<Lit> &assumptions) {
 
   assert(hasEncoding);
@@ -231,7 +231,7 @@ void Totalizer::update(leximaxIST::Solver &solver, int64_t rhs, const std::vecto
   }
 }
 
-void Totalizer::add(leximaxIST::Solver &solver, Totalizer &tot, int64_t rhs) {
+void Totalizer::add(leximaxIST::ClauseBuffer &solver, Totalizer &tot, int64_t rhs) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_ &&
          tot.incremental_strategy == _INCREMENTAL_ITERATIVE_);
   int left_idx = totalizerIterative_rhs.size() - 1;
@@ -280,7 +280,7 @@ void Totalizer::add(leximaxIST::Solver &solver, Totalizer &tot, int64_t rhs) {
   |    * hasEncoding is set to 'true'.
   |
   |________________________________________________________________________________________________@*/
-void Totalizer::build(leximaxIST::Solver &S, const std::vector<Lit> &lits, int64_t rhs) {
+void Totalizer::build(leximaxIST::ClauseBuffer &S, const std::vector<Lit> &lits, int64_t rhs) {
 
   cardinality_outlits.clear();
   hasEncoding = false;
@@ -330,7 +330,4 @@ void Totalizer::build(leximaxIST::Solver &S, const std::vector<Lit> &lits, int64
   hasEncoding = true;
 
   ilits = lits;
-  
-  printf("c ltotalizer nvars nclauses nvars_root\n");
-  printf("c totalizer %d %d %d\n", n_variables, n_clauses, cardinality_outlits.size());
 }
@@ -29,7 +29,7 @@
 #define Enc_Totalizer_h
 
 #include <Encodings.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 #include <vector>
 
 namespace leximaxIST {
@@ -49,15 +49,15 @@ public:
   }
   ~Totalizer() {}
 
-  void build(leximaxIST::Solver &solver, const std::vector<int> &lits, int64_t rhs);
-  void join(leximaxIST::Solver &solver, const std::vector<int> &lits, int64_t rhs);
-  void update(leximaxIST::Solver &solver, int64_t rhs, const std::vector<int> &lits, std::vector<int> &assumptions);
-  void update(leximaxIST::Solver &solver, int64_t rhs) {
+  void build(leximaxIST::ClauseBuffer &solver, const std::vector<int> &lits, int64_t rhs);
+  void join(leximaxIST::ClauseBuffer &solver, const std::vector<int> &lits, int64_t rhs);
+  void update(leximaxIST::ClauseBuffer &solver, int64_t rhs, const std::vector<int> &lits, std::vector<int> &assumptions);
+  void update(leximaxIST::ClauseBuffer &solver, int64_t rhs) {
     std::vector<int> lits;
     std::vector<int> assumptions;
     update(solver, rhs, lits, assumptions);
   }
-  void add(leximaxIST::Solver &solver, Totalizer &tot, int64_t rhs);
+  void add(leximaxIST::ClauseBuffer &solver, Totalizer &tot, int64_t rhs);
 
   bool hasCreatedEncoding() { return hasEncoding; }
   void setIncremental(int incremental) { incremental_strategy = incremental; }
@@ -94,10 +94,10 @@ public:
   std::vector<int> &outputs() { return cardinality_outlits; }
 
 protected:
-  void encode(leximaxIST::Solver &solver, std::vector<int> &lits);
-  void adder(leximaxIST::Solver &solver, std::vector<int> &left, std::vector<int> &right, std::vector<int> &output);
-  void incremental(leximaxIST::Solver &solver, int64_t rhs);
-  void toCNF(leximaxIST::Solver &solver, std::vector<int> &lits);
+  void encode(leximaxIST::ClauseBuffer &solver, std::vector<int> &lits);
+  void adder(leximaxIST::ClauseBuffer &solver, std::vector<int> &left, std::vector<int> &right, std::vector<int> &output);
+  void incremental(leximaxIST::ClauseBuffer &solver, int64_t rhs);
+  void toCNF(leximaxIST::ClauseBuffer &solver, std::vector<int> &lits);
 
   std::vector<std::vector<int>> totalizerIterative_left;
   std::vector<std::vector<int>> totalizerIterative_right;
@@ -49,7 +49,7 @@ Lit Encodings::mkLit(int var_id, bool sign = false)
 */
 
 // Creates an unit clause in the SAT solver
-void Encodings::addUnitClause(leximaxIST::Solver &S, Lit a, Lit blocking) {
+void Encodings::addUnitClause(leximaxIST::ClauseBuffer &S, Lit a, Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef);
   //assert(std::abs(a) < S.nVars());
@@ -61,7 +61,7 @@ void Encodings::addUnitClause(leximaxIST::Solver &S, Lit a, Lit blocking) {
 }
 
 // Creates a binary clause in the SAT solver
-void Encodings::addBinaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit blocking) {
+void Encodings::addBinaryClause(leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef && b != lit_Undef);
   //assert(std::abs(a) < S.nVars() && std::abs(b) < S.nVars());
@@ -74,7 +74,7 @@ void Encodings::addBinaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit blockin
 }
 
 // Creates a ternary clause in the SAT solver
-void Encodings::addTernaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit c, Lit blocking) {
+void Encodings::addTernaryClause(leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c, Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef && b != lit_Undef && c != lit_Undef);
   //assert(std::abs(a) < S.nVars() && std::abs(b) < S.nVars() && std::abs(c) < S.nVars());
@@ -88,7 +88,7 @@ void Encodings::addTernaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit c, Lit
 }
 
 // Creates a quaternary clause in the SAT solver
-void Encodings::addQuaternaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit c, Lit d,
+void Encodings::addQuaternaryClause(leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c, Lit d,
                                     Lit blocking) {
   assert(clause.size() == 0);
   assert(a != lit_Undef && b != lit_Undef && c != lit_Undef && d != lit_Undef);
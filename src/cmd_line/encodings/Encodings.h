@@ -29,7 +29,7 @@
 #define Encodings_h
 
 #include <leximaxIST_types.h>
-#include <leximaxIST_Solver.h>
+#include <ClauseBuffer.h>
 #include <vector>
 
 namespace leximaxIST {
@@ -44,14 +44,14 @@ public:
   // Auxiliary methods for creating clauses
   //
   // Add a unit clause to a SAT solver
-  void addUnitClause(leximaxIST::Solver &S, Lit a, Lit blocking = lit_Undef);
+  void addUnitClause(leximaxIST::ClauseBuffer &S, Lit a, Lit blocking = lit_Undef);
   // Add a binary clause to a SAT solver
-  void addBinaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit blocking = lit_Undef);
+  void addBinaryClause(leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit blocking = lit_Undef);
   // Add a ternary clause to a SAT solver
-  void addTernaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit c,
+  void addTernaryClause(leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c,
                         Lit blocking = lit_Undef);
   // Add a quaternary clause to a SAT solver
-  void addQuaternaryClause(leximaxIST::Solver &S, Lit a, Lit b, Lit c, Lit d,
+  void addQuaternaryClause(leximaxIST::ClauseBuffer &S, Lit a, Lit b, Lit c, Lit d,
                            Lit blocking = lit_Undef);
 
 protected:
@@ -5,10 +5,11 @@
 #include <FormulaPB.h>
 #include <MaxSATFormula.h>
 #include <ParserPB.h>
-#include <Encoder.h>
+#include <FormulaEncoder.h>
 #include <Mcnf.h>
 #include <string>
 #include <iostream>
+#include <chrono>
 #include <cstdlib>
 #include <signal.h>
 #include <preprocessorinterface.hpp>
@@ -55,18 +56,31 @@ int main(int argc, char *argv[])
 
     solver.set_verbosity(options.get_verbosity());
     solver.set_leave_tmp_files(options.get_leave_tmp_files());
+    solver.set_gzip_input(options.get_gzip_input());
+    solver.set_retention(options.get_retention()); // before adding clauses
+    if (options.get_deadline() > 0)
+        solver.set_deadline(options.get_deadline());
+    if (options.get_mem_limit() > 0)
+        solver.set_memory_budget(options.get_mem_limit());
     
     if (options.get_verbosity() > 0 && options.get_verbosity() <= 2) {
         print_header();
         std::cout << "c Parsing instance file " << options.get_input_file_name() << "...\n";
     }
 
+    // the snapshot does not contain the state of MaxPre that reconstructs the solution
+    if (!options.get_write_snapshot().empty() && options.get_preprocessing()
+        && options.get_input_file_type() == leximaxIST::Options::FileType::MCNF) {
+        leximaxIST::print_error_msg("The options --write-snapshot and --preprocessing are not compatible");
+        exit(EXIT_FAILURE);
+    }
+
     maxPreprocessor::PreprocessorInterface * prepro = nullptr;
     
     if (options.get_input_file_type() == leximaxIST::Options::FileType::OPB) {
         // read pbmo file
         leximaxIST::MaxSATFormula maxsat_formula;
-        leximaxIST::ParserPB parser_pb (&maxsat_formula);
+        leximaxIST::ParserPB parser_pb (&maxsat_formula, options.get_parse_threads());
         parser_pb.parse(options.get_input_file_name().c_str());
         
         // add hard clauses
@@ -74,30 +88,22 @@ int main(int argc, char *argv[])
             std::vector<int> hc (maxsat_formula.getHardClause(pos).clause);
             solver.add_hard_clause(hc);
         }
+        // the variables that only occur in later constraints or in the objectives are not fresh
+        solver.reserve_vars(maxsat_formula.nVars());
         
-        // use an encoder to encode the pseudo-boolean constraints to cnf and add the clauses to solver
-        leximaxIST::Encoder enc (leximaxIST::_INCREMENTAL_NONE_,
-                                options.get_card_enc(),
-                                leximaxIST::_AMO_LADDER_,
-                                options.get_pb_enc());
-        // pb constraints
-        for (int i = 0; i < maxsat_formula.nPB(); i++) {
-            // Make sure the PB is on the form <=
-            if (!maxsat_formula.getPBConstraint(i)._sign)
-                maxsat_formula.getPBConstraint(i).changeSign();
-            enc.encodePB(solver, maxsat_formula.getPBConstraint(i)._lits,
-                            maxsat_formula.getPBConstraint(i)._coeffs,
-                            maxsat_formula.getPBConstraint(i)._rhs);
-        }
-        // cardinality and at most one
-        for (int i = 0; i < maxsat_formula.nCard(); i++) {
-            if (maxsat_formula.getCardinalityConstraint(i)._rhs == 1) {
-                enc.encodeAMO(solver, maxsat_formula.getCardinalityConstraint(i)._lits);
-            } else {
-                enc.encodeCardinality(solver,
-                                        maxsat_formula.getCardinalityConstraint(i)._lits,
-                                        maxsat_formula.getCardinalityConstraint(i)._rhs);
-            }
+        // encode the pseudo-boolean and cardinality constraints to cnf and add the clauses to solver
+        leximaxIST::FormulaEncoder formula_encoder (&maxsat_formula, options.get_pb_enc(),
+                                                    options.get_card_enc(), options.get_encode_threads(),
+                                                    options.get_enc_policy());
+        const auto encode_start (std::chrono::steady_clock::now());
+        formula_encoder.encode(solver);
+        if (options.get_verbosity() > 0 && options.get_verbosity() <= 2) {
+            const double t (std::chrono::duration<double>(std::chrono::steady_clock::now() - encode_start).count());
+            std::cout << "c Encoded " << maxsat_formula.nPB() << " PB and " << maxsat_formula.nCard();
+            std::cout << " cardinality constraints into " << formula_encoder.nClauses() << " clauses and ";
+            std::cout << formula_encoder.nFreshVars() << " fresh variables in " << t << " s\n";
+            if (options.get_pb_enc() == leximaxIST::_PB_AUTO_ || options.get_card_enc() == leximaxIST::_CARD_AUTO_)
+                formula_encoder.printEncodingStats();
         }
         
         // add objective functions
@@ -111,9 +117,18 @@ int main(int argc, char *argv[])
             }
             solver.add_soft_clauses(soft_clauses);
         }
+    } else if (options.get_input_file_type() == leximaxIST::Options::FileType::SNAPSHOT) {
+        solver.read_snapshot(options.get_input_file_name());
     } else {
         // read dimacs mcnf file
         leximaxIST::Mcnf mcnf(options.get_input_file_name());
+        if (options.get_verbosity() > 0 && options.get_verbosity() <= 2) {
+            const double mb (mcnf.nb_bytes / 1e6);
+            std::cout << "c Parsed " << mb << " MB in " << mcnf.parse_time << " s";
+            if (mcnf.parse_time > 0)
+                std::cout << " (" << mb / mcnf.parse_time << " MB/s)";
+            std::cout << '\n';
+        }
 
         if (options.get_preprocessing()) {
             std::vector<std::vector<int>> clauses{};
@@ -122,19 +137,21 @@ int main(int argc, char *argv[])
 
             clauses.reserve(mcnf.hards.size());
             weights.reserve(mcnf.hards.size());
-            for (leximaxIST::Clause cl : mcnf.hards) {
-                clauses.push_back(cl);
+            for (leximaxIST::ClauseRef cl : mcnf.hards) {
+                clauses.emplace_back(cl.begin(), cl.end());
                 weights.push_back({});
             }
             for (size_t idx = 0; idx < mcnf.softs.size(); ++idx) {
-                auto obj = mcnf.softs[idx];
+                const leximaxIST::ClauseArena &obj = mcnf.softs[idx];
                 clauses.reserve(clauses.size() + obj.size());
                 weights.reserve(weights.size() + obj.size());
-                for (auto cl : obj) {
-                    top_weight += cl.first;
-                    clauses.push_back(cl.second);
+                size_t j = 0;
+                for (leximaxIST::ClauseRef cl : obj) {
+                    const uint64_t w_cl = mcnf.soft_weights[idx][j++];
+                    top_weight += w_cl;
+                    clauses.emplace_back(cl.begin(), cl.end());
                     std::vector<uint64_t> w(idx+1, 0);
-                    w.back() = cl.first;
+                    w.back() = w_cl;
                     weights.push_back(w);
                 }
             }
@@ -168,11 +185,11 @@ int main(int argc, char *argv[])
                 solver.add_soft_clauses(empty);
             }
         } else {
-            for (leximaxIST::Clause cl : mcnf.hards) {
+            for (leximaxIST::ClauseRef cl : mcnf.hards) {
                 solver.add_hard_clause(cl);
             }
-            for (auto obj : mcnf.softs) {
-                solver.add_soft_clauses(obj);
+            for (size_t idx = 0; idx < mcnf.softs.size(); ++idx) {
+                solver.add_soft_clauses(mcnf.soft_weights[idx], mcnf.softs[idx]);
             }
             // fix to force solving single-objective problems
             if (mcnf.softs.size() == 1) {
@@ -182,7 +199,11 @@ int main(int argc, char *argv[])
         }
 
     }
+
+    if (!options.get_write_snapshot().empty())
+        solver.write_snapshot(options.get_write_snapshot());
     
+    solver.set_sorter(options.get_sorter());
     // approximation
     if (!options.get_approx().empty()) {
         solver.set_approx(options.get_approx());
@@ -195,8 +216,10 @@ int main(int argc, char *argv[])
         solver.approximate();
     }
     // optimisation
-    if (!options.get_optimise().empty() && solver.get_status() != 'u') {
+    if (!options.get_optimise().empty() && solver.get_status() != 'u' && solver.get_interrupt() == 0) {
         solver.set_disjoint_cores(options.get_disjoint_cores());
+        solver.set_maxsat_presolve(options.get_maxsat_presolve());
+        solver.set_half_comparators(options.get_half_comparators());
         solver.set_ilp_solver(options.get_ilp_solver());
         solver.set_opt_mode(options.get_optimise());
         solver.optimise();
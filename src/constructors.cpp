@@ -8,15 +8,23 @@ namespace leximaxIST {
         m_verbosity(0),
         m_id_count(0),
         m_input_nb_vars(0),
+        m_weights_gcd(1),
         m_num_objectives(0),
         m_formalism("wcnf"),
         m_ilp_solver("gurobi"),
+        m_opt_mode("core-merge"),
+        m_approx("mss"), // default - mss enumeration
+        m_disjoint_cores(true),
+        m_half_comparators(false),
+        m_sorted_polarity(_POLARITY_FULL_),
+        m_sorter("odd_even"),
+        m_retention("all"),
         m_child_pid(0),
         m_timeout(3000.0), // 3 seconds
         m_leave_tmp_files(false),
+        m_gzip_input(false),
         m_simplify_last(false),
         m_status('?'),
-        m_approx("mss"), // default - mss enumeration
         m_approx_tout(86400), // 1 day I think
         m_gia_incr(false),
         m_gia_pareto(false),
@@ -27,11 +35,11 @@ namespace leximaxIST {
         m_maxsat_presolve(false), // do not maxsat presolve
         //m_num_opts(0),
         m_multiplication_string(" "),
-        m_opt_mode("core-merge"),
-        m_disjoint_cores(true),
+        m_eval_ranges(true),
         m_sat_solver(nullptr)
     {
         m_sat_solver = new IpasirWrap();
+        reset_file_name();
     }
 
 }/* namespace leximaxIST */
@@ -8,20 +8,35 @@ namespace leximaxIST {
     void Solver::clear()
     {
         m_objectives.clear();
+        m_obj_weights.clear();
+        m_weights_gcd = 1;
         m_sorted_vecs.clear();
+        m_sorted_values.clear();
+        m_sorted_runs.clear();
+        m_sorted_prefixes.clear();
         // clear relaxation variables
         m_all_relax_vars.clear();
         m_sorted_relax_collection.clear();
         m_input_hard.clear();
         m_encoding.clear();
         m_soft_clauses.clear();
+        m_soft_weights.clear();
+        m_max_values.clear();
         m_solution.clear();
+        m_solution_obj_vec.clear();
+        m_solution_sorted.clear();
+        m_eval_weights.clear();
+        m_eval_ranges = true;
         m_id_count = 0;
         m_input_nb_vars = 0;
         m_num_objectives = 0;
         m_child_pid = 0;
+        close_instance_file();
         m_status = '?';
         m_snet_info.clear();
+        m_sorted_polarity = _POLARITY_FULL_;
+        m_core_vars.clear();
+        m_sum_cores.clear();
         //m_times.clear();
         // clear sat solver
         delete m_sat_solver;
@@ -5,19 +5,99 @@
 #include <vector>
 #include <string>
 #include <iostream>
-#include <unordered_map>
 #include <utility>
 #include <algorithm>
 #include <list>
 #include <cmath>
+#include <functional> // std::greater
+#include <new> // std::bad_alloc
 
 namespace leximaxIST {
 
     bool descending_order (int i, int j);
     
-    void Solver::encode_sorted(const std::vector<int> &obj_vars, int i)
+    void gte_to_sorted(const GTE_OUT &outputs, std::vector<int> &sorted_vec, std::vector<int> &values);
+    
+    void unit_values(size_t size, std::vector<int> &values);
+    
+    // position in values (in decreasing order) of the smallest value that is at least value, -1 if there is none
+    int value_pos(const std::vector<int> &values, int value)
+    {
+        return std::upper_bound(values.begin(), values.end(), value, std::greater<int>()) - values.begin() - 1;
+    }
+    
+    /* polarity of the comparators for a use of the sorted vectors:
+     * use is _POLARITY_UPWARD_ if the outputs are only bounded from above (lower bounds that are implied anyway do not count),
+     * _POLARITY_DOWNWARD_ if they are only bounded from below and _POLARITY_FULL_ if both
+     */
+    int Solver::comparator_polarity(int use) const
+    {
+        return m_half_comparators ? use : _POLARITY_FULL_;
+    }
+    
+    // in the auto mode, objectives with fewer variables are sorted with a totalizer (better propagation)
+    constexpr size_t auto_totalizer_size (64);
+    
+    // encoding of the sorted vector of the i-th objective
+    int Solver::objective_sorter(int i) const
+    {
+        if (is_weighted(i) || m_sorter == "totalizer")
+            return _SORTER_TOTALIZER_;
+        if (m_sorter == "pairwise")
+            return _SORTER_PAIRWISE_;
+        if (m_sorter == "auto" && m_objectives.at(i).size() < auto_totalizer_size)
+            return _SORTER_TOTALIZER_;
+        return _SORTER_ODD_EVEN_;
+    }
+    
+    // check that the comparators of the sorted vectors have the clauses needed for this use of the outputs
+    void Solver::check_polarity(int use) const
+    {
+        if (m_sorted_polarity != _POLARITY_FULL_ && m_sorted_polarity != use) {
+            std::string errmsg ("The sorting networks only have ");
+            errmsg += (m_sorted_polarity == _POLARITY_UPWARD_) ? "upward" : "downward";
+            errmsg += " comparators but their outputs are bounded from ";
+            errmsg += (m_sorted_polarity == _POLARITY_UPWARD_) ? "below" : "above";
+            print_error_msg(errmsg);
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    /* the objective is at most ub, so the outputs for the values larger than ub + 1 may not be encoded
+     * (then sorted_vec has size ub + 1, the values larger than ub + 1 are not distinguished)
+     */
+    void Solver::encode_sorted(const std::vector<int> &obj_vars, int i, int polarity, int ub)
     {
-        if (!obj_vars.empty()) {
+        // the sorted vector is rebuilt from scratch (in core_rebuild, obj_vars may be empty)
+        m_sorted_vecs.at(i).clear();
+        m_sorted_values.at(i).clear();
+        m_sorted_runs.at(i).clear();
+        m_sorted_prefixes.at(i).clear();
+        m_sorted_polarity = polarity;
+        const int sorter (objective_sorter(i));
+        if (!obj_vars.empty() && sorter == _SORTER_TOTALIZER_) {
+            // sorted_vec has one entry per value of the weighted sum
+            if (m_verbosity == 2)
+                std::cout << "c -------- Generalized Totalizer Encoding --------\n";
+            GTE_OUT outputs;
+            m_snet_info.at(i).first = obj_vars.size();
+            m_snet_info.at(i).second = encode_gte(std::make_pair(0, obj_vars.size()), obj_vars, outputs, polarity, ub + 1);
+            gte_to_sorted(outputs, m_sorted_vecs.at(i), m_sorted_values.at(i));
+        }
+        else if (!obj_vars.empty() && 2 * (ub + 1) < static_cast<int>(obj_vars.size())) {
+            // selection network of the ub + 1 largest outputs (with at most two blocks it is not smaller than the sorting network)
+            if (m_verbosity == 2)
+                std::cout << "c -------- Selection Network Encoding --------\n";
+            m_snet_info.at(i).first = obj_vars.size();
+            m_snet_info.at(i).second = encode_selection(obj_vars, ub + 1, m_sorted_vecs.at(i), polarity, sorter);
+        }
+        else if (!obj_vars.empty() && sorter == _SORTER_PAIRWISE_) {
+            if (m_verbosity == 2)
+                std::cout << "c -------- Pairwise Network Encoding --------\n";
+            m_snet_info.at(i).first = obj_vars.size();
+            m_snet_info.at(i).second = encode_pairwise(obj_vars, m_sorted_vecs.at(i), polarity);
+        }
+        else if (!obj_vars.empty()) {
             const size_t nb_wires = obj_vars.size();
             m_sorted_vecs.at(i).resize(nb_wires, 0);
             // sorting_network is initialized to a vector of pairs (-1,-1)
@@ -27,7 +107,7 @@ namespace leximaxIST {
             if (m_verbosity == 2)
                 std::cout << "c -------- Sorting Network Encoding --------\n";
             m_snet_info.at(i).first = nb_wires;
-            m_snet_info.at(i).second = encode_network(elems_to_sort, &obj_vars, sorting_network);
+            m_snet_info.at(i).second = encode_network(elems_to_sort, &obj_vars, sorting_network, polarity);
             // sorted_vec variables are the outputs of sorting_network
             if (nb_wires == 1) { // in this case the sorting network is empty
                 std::vector<int> &sorted_vec = m_sorted_vecs.at(i);
@@ -40,13 +120,23 @@ namespace leximaxIST {
                     sorted_vec.at(j) = output_j;
                 }
             }
-            if (m_verbosity == 2)
-                print_sorted_vec(i);
         }
+        // the outputs of the sorting networks have one entry per unit of the sum
+        if (obj_vars.empty() || sorter != _SORTER_TOTALIZER_)
+            unit_values(m_sorted_vecs.at(i).size(), m_sorted_values.at(i));
+        if (m_verbosity == 2 && !obj_vars.empty())
+            print_sorted_vec(i);
         // add order encoding to each sorted vector
         /*for (int i (0); i < m_num_objectives; ++i)
             order_encoding(*(m_sorted_vecs.at(i)));*/
     }
+    
+    // literal of the sorted vector of the jth objective that is true iff the objective is at least value > 0 (0 if there is none)
+    int Solver::sorted_geq(int j, int value) const
+    {
+        const int pos (value_pos(m_sorted_values.at(j), value));
+        return (pos == -1) ? 0 : m_sorted_vecs.at(j).at(pos);
+    }
 
     void Solver::all_subsets(std::list<int> set, int i, Clause &clause)
     {
@@ -79,12 +169,74 @@ namespace leximaxIST {
         }
     }
 
+    /* sequential counter encoding (Sinz 2005) of at most k of vars
+     * s[j][c] is true if at least c + 1 of vars[0..j] are true (only the implication from left to right is encoded)
+     * returns the number of clauses
+     */
+    int Solver::sequential_counter(const std::vector<int> &vars, int k)
+    {
+        const int n (vars.size());
+        int nb_clauses (0);
+        std::vector<int> prev_s; // s[j - 1]
+        for (int j (0); j < n - 1; ++j) {
+            std::vector<int> s (k, 0);
+            for (int c (0); c < k; ++c)
+                s.at(c) = fresh();
+            // vars[j] implies s[j][0]
+            add_clause(-vars.at(j), s.at(0));
+            ++nb_clauses;
+            if (j == 0) {
+                for (int c (1); c < k; ++c) {
+                    add_clause(-s.at(c));
+                    ++nb_clauses;
+                }
+            }
+            else {
+                for (int c (0); c < k; ++c) {
+                    // s[j - 1][c] implies s[j][c]
+                    add_clause(-prev_s.at(c), s.at(c));
+                    ++nb_clauses;
+                    // vars[j] and s[j - 1][c - 1] implies s[j][c]
+                    if (c > 0) {
+                        add_clause(-vars.at(j), -prev_s.at(c - 1), s.at(c));
+                        ++nb_clauses;
+                    }
+                }
+                // vars[j] and s[j - 1][k - 1] is more than k
+                add_clause(-vars.at(j), -prev_s.at(k - 1));
+                ++nb_clauses;
+            }
+            prev_s = std::move(s);
+        }
+        add_clause(-vars.back(), -prev_s.at(k - 1));
+        ++nb_clauses;
+        return nb_clauses;
+    }
+
     void Solver::at_most(const std::list<int> &set, int i)
     {
-        // implementation with naive encoding
-        // for every combination of i + 1 vars, one of them must be false
-        Clause clause(i + 1, -1); // fill constructor i+1 elements with value -1
-        all_subsets(set, i + 1, clause);
+        const int n (std::distance(set.begin(), set.end()));
+        if (i >= n)
+            return; // trivially satisfied
+        // the naive encoding has a clause for every combination of i + 1 vars: C(n, i + 1) clauses
+        double naive_size (1);
+        for (int j (0); j <= i; ++j)
+            naive_size = naive_size * (n - j) / (j + 1);
+        // the sequential counter has 2nk + n - 3k - 1 clauses
+        const double seq_size (i == 0 ? n : 2.0 * n * i + n - 3.0 * i - 1);
+        if (naive_size <= seq_size) {
+            // for every combination of i + 1 vars, one of them must be false
+            Clause clause(i + 1, -1); // fill constructor i+1 elements with value -1
+            all_subsets(set, i + 1, clause);
+        }
+        else {
+            const std::vector<int> vars (set.begin(), set.end());
+            sequential_counter(vars, i);
+        }
+        if (m_verbosity >= 1 && m_verbosity <= 2) {
+            std::cout << "c At most " << i << " constraint: " << std::min(naive_size, seq_size) << " clauses";
+            std::cout << " (naive encoding: " << naive_size << ", sequential counter: " << seq_size << ")\n";
+        }
     }
 
     // create new relaxation variables and sorted vectors after the relaxation
@@ -147,27 +299,27 @@ namespace leximaxIST {
             // choose exactly one obj function to minimise
             int k = 0;
             for (int relax_var : relax_vars) {
-                const std::vector<int> &objective = m_objectives.at(k);
-                size_t j = 0;
-                for (const int lit : m_soft_clauses) {
-                    int soft_var = -lit;
-                    if (j >= objective.size()) {
+                // the soft variable of value m_max_values[j] is the output of the sorted vector of the
+                // chosen objective that is true iff the objective is at least m_max_values[j]
+                for (size_t j (0); j < m_soft_clauses.size(); ++j) {
+                    const int soft_var (-m_soft_clauses.at(j));
+                    const int sorted_var (sorted_geq(k, m_max_values.at(j)));
+                    if (sorted_var == 0) {
                         // relax_vars[k] implies neg soft_var[j]
                         if (m_verbosity == 2)
                             std::cout << "c relax_var implies neg soft_var: ";
                         add_clause(-relax_var, -soft_var);
                     }
                     else {
-                        // relax_vars[k] implies objective[j] implies soft_var[j]
+                        // relax_vars[k] implies sorted_var implies soft_var[j]
                         if (m_verbosity == 2)
-                            std::cout << "c relax_var implies obj_var implies soft_var: ";
-                        add_clause(-relax_var, -(objective.at(j)), soft_var);
-                        // let's check: relax_vars[k] implies soft_var[j] implies objective[j]
+                            std::cout << "c relax_var implies sorted_var implies soft_var: ";
+                        add_clause(-relax_var, -sorted_var, soft_var);
+                        // relax_vars[k] implies soft_var[j] implies sorted_var
                         if (m_verbosity == 2)
-                            std::cout << "c relax_var implies soft_var implies obj: ";
-                        add_clause(-relax_var, objective.at(j), -soft_var);
+                            std::cout << "c relax_var implies soft_var implies sorted_var: ";
+                        add_clause(-relax_var, sorted_var, -soft_var);
                     }
-                    ++j;
                 }
                 ++k;
             }
@@ -183,12 +335,19 @@ namespace leximaxIST {
         }
     }
 
+    // first maximum of the incumbent solution: an upper bound on all objectives
+    int Solver::incumbent_max() const
+    {
+        return m_solution_sorted.empty() ? 0 : m_solution_sorted.front();
+    }
+
     size_t Solver::largest_obj() const
     {
         size_t largest = 0;
         for (const std::vector<int> &objective : m_objectives) {
-            if (objective.size() > largest)
-                largest = objective.size();        
+            const size_t obj_weight (weight_sum(objective));
+            if (obj_weight > largest)
+                largest = obj_weight;
         }
         return largest;
     }
@@ -206,24 +365,17 @@ namespace leximaxIST {
             // the OR is between sorted vecs after relaxation
             sorted_vecs = &m_sorted_relax_collection.at(i-1);
         }
-        size_t k = 0;
-        for (int max_var : max_vars) {
+        for (size_t k (0); k < max_vars.size(); ++k) {
             std::vector<int> disjunction;
             for (int j = 0; j < m_num_objectives; ++j) {
-                const std::vector<int> &sorted_vec = sorted_vecs->at(j);
-                // padding with zeros to the left
-                size_t max_nb_wires = max_vars.size();
-                if (k >= max_nb_wires - sorted_vec.size()) { // no undefined behaviour because max_nb_wires >= sorted_vec size
-                    // add component of sorted_vec to the disjunction
-                    size_t position = k - (max_nb_wires - sorted_vec.size());
-                    int component = sorted_vec.at(position);
-                    disjunction.push_back(component);
-                }
+                // the component of sorted_vec of the smallest value that is at least the value of the max variable
+                const int pos (value_pos(m_sorted_values.at(j), m_max_values.at(k)));
+                if (pos != -1)
+                    disjunction.push_back(sorted_vecs->at(j).at(pos));
             }
             // disjunction implies max variable
             for (int component : disjunction)
-                add_clause(max_var, -component);
-            ++k;        
+                add_clause(max_vars.at(k), -component);
             // max variable implies disjunction -> It is not necessary
             /*disjunction.push_back(-max_var);
             add_clause_enc(disjunction);*/
@@ -237,21 +389,38 @@ namespace leximaxIST {
         int size (vars.size());
         for (int i (0); i < size - 1; ++i) {
             // vars[i] implies vars[i+1]
-            add_clause(-vars.at(i), vars.at(i + 1));
+            if (vars.at(i) != vars.at(i + 1))
+                add_clause(-vars.at(i), vars.at(i + 1));
         }
     }
     
+    // the values of the max variables are the values of the sorted vectors
+    void Solver::set_max_values()
+    {
+        m_max_values.clear();
+        for (const std::vector<int> &values : m_sorted_values)
+            m_max_values.insert(m_max_values.end(), values.begin(), values.end());
+        std::sort(m_max_values.begin(), m_max_values.end(), descending_order);
+        m_max_values.erase(std::unique(m_max_values.begin(), m_max_values.end()), m_max_values.end());
+    }
+    
+    /* the soft variable k is true if the maximum is at least m_max_values[k],
+     * its weight is the difference to the next value, so the cost is the value of the maximum
+     * in the last iteration, if m_simplify_last, the soft variables are not sorted (see encode_relaxation)
+     */
     void Solver::generate_soft_clauses(int i)
     {
-        // find size of largest objective function
-        size_t largest = largest_obj();
+        set_max_values();
         // create new soft vars and soft clauses
-        m_soft_clauses.resize(largest);
-        std::vector<int> soft_vars(largest, 0);
-        for (size_t j (0); j < largest; ++j) {
+        const size_t nb_soft (m_max_values.size());
+        m_soft_clauses.resize(nb_soft);
+        m_soft_weights.resize(nb_soft);
+        std::vector<int> soft_vars(nb_soft, 0);
+        for (size_t j (0); j < nb_soft; ++j) {
             int f (fresh());
             soft_vars.at(j) = f;
             m_soft_clauses.at(j) = -f;
+            m_soft_weights.at(j) = m_max_values.at(j) - (j + 1 < nb_soft ? m_max_values.at(j + 1) : 0);
         }
         if ((!m_simplify_last || i != m_num_objectives - 1))
             order_encoding(soft_vars);
@@ -283,8 +452,7 @@ namespace leximaxIST {
      */
     int Solver::encode_lower_bound(int i, int sum)
     {
-        std::vector<int> obj_vec (get_objective_vector());
-        std::sort (obj_vec.begin(), obj_vec.end(), descending_order);
+        const std::vector<int> &obj_vec (m_solution_sorted);
         // components 0 to i-1 have been minimised and are fixed
         int sum_fixed (0);
         for (int j (0); j <= i - 1; ++j)
@@ -326,9 +494,9 @@ namespace leximaxIST {
     {
         if (m_verbosity == 2 && lb > 0)
             std::cout << "c ------------ Lower bound on soft clauses ------------\n";
-        if (lb > 0) {
-            int size (m_soft_clauses.size());
-            int sc (m_soft_clauses.at(size - lb));
+        const int pos (value_pos(m_max_values, lb));
+        if (lb > 0 && pos != -1) {
+            int sc (m_soft_clauses.at(pos));
             add_clause(-sc); // positive literal
         }
     }
@@ -337,15 +505,15 @@ namespace leximaxIST {
     {
         if (m_verbosity == 2 && lb > 0)
             std::cout << "c ------------ Lower bound on Sorted Vecs ------------\n";
-        for (const std::vector<int> &sorted_vec : m_sorted_vecs) {
-            int size (sorted_vec.size());
-            if (lb > 0) {
+        for (int j (0); j < m_num_objectives; ++j) {
+            const int lit (sorted_geq(j, lb));
+            if (lb > 0 && lit != 0) {
                 if (m_verbosity == 2) {
                     std::cout << "c ----- Sorted Vec -----\n";
-                    std::cout << "c size: " << size << '\n';
+                    std::cout << "c size: " << m_sorted_vecs.at(j).size() << '\n';
                     std::cout << "c lower bound: " << lb << '\n';
                 }
-                add_clause(sorted_vec.at(size - lb)); // positive literal
+                add_clause(lit); // positive literal
             }
         }
     }
@@ -353,8 +521,7 @@ namespace leximaxIST {
     // returns the upper bound of the optimal i-th max
     int Solver::encode_upper_bound(int i)
     {
-        std::vector<int> obj_vec (get_objective_vector());
-        std::sort (obj_vec.begin(), obj_vec.end(), descending_order);
+        const std::vector<int> &obj_vec (m_solution_sorted);
         if (m_verbosity == 2) {
             std::cout << "c ------------ Upper bound encoding ------------\n";
             std::cout << "c Sorted objective vector: ";
@@ -365,7 +532,7 @@ namespace leximaxIST {
         if (m_verbosity >= 1 && m_verbosity <= 2) {
             if (i == 0) {
                 std::cout << "c Trivial upper bound (size of largest objective): ";
-                std::cout << m_soft_clauses.size() << '\n';
+                std::cout << largest_obj() << '\n';
             }
             std::cout << "c Upper bound of optimum: ";
             std::cout << obj_vec.at(i) << '\n';
@@ -381,13 +548,14 @@ namespace leximaxIST {
     // upper bound on current maximum
     void Solver::encode_ub_soft(int max_i)
     {
-        int pos (m_soft_clauses.size() - 1 - max_i);
+        // the soft variable of the smallest value larger than max_i is false
+        const int pos (value_pos(m_max_values, max_i + 1));
         if (m_verbosity == 2) {
             std::cout << "c ------------ Upper bound on soft clauses ------------\n";
             std::cout << "c size: " << m_soft_clauses.size() << '\n';
             std::cout << "c upper bound: " << max_i << '\n';
         }
-        if (pos >= 0) // pos may be -1 if ub is trivial
+        if (pos != -1) // pos may be -1 if ub is trivial
             add_clause(m_soft_clauses.at(pos));
     }
     
@@ -395,18 +563,18 @@ namespace leximaxIST {
     void Solver::encode_ub_sorted(int first_max)
     {
         // refine upper bound on all obj functions (sorted vecs)
+        check_polarity(_POLARITY_UPWARD_);
         if (m_verbosity == 2)
             std::cout << "c ------------ Upper bound on Sorted Vecs ------------\n";
-        for (const std::vector<int> &sorted_vec : m_sorted_vecs) {
-            int size (sorted_vec.size());
-            int pos (size - 1 - first_max); // pos might be < 0
+        for (int j (0); j < m_num_objectives; ++j) {
+            const int lit (sorted_geq(j, first_max + 1)); // lit might be 0 if ub is trivial
             if (m_verbosity == 2) {
                 std::cout << "c ----- Sorted Vec -----\n";
-                std::cout << "c size: " << size << '\n';
+                std::cout << "c size: " << m_sorted_vecs.at(j).size() << '\n';
                 std::cout << "c upper bound: " << first_max << '\n';
             }
-            if (pos >= 0)
-                add_clause(-sorted_vec.at(pos)); // neg sorted vec
+            if (lit != 0)
+                add_clause(-lit); // neg sorted vec
         }
     }
     
@@ -433,14 +601,11 @@ namespace leximaxIST {
     void Solver::fix_all(int i)
     {
         // Use objective vector because m_solution might not have the correct values
-        std::vector<int> obj_vec (get_objective_vector());
-        std::sort (obj_vec.begin(), obj_vec.end(), descending_order);
-        int obj_val (obj_vec.at(i));
-        int size (m_soft_clauses.size());
-        // soft variables: size - obj_val zeros followed by obj_val ones
-        for (int j (0); j < size; ++j) {
+        int obj_val (m_solution_sorted.at(i));
+        // soft variables: zeros for the values larger than obj_val followed by ones
+        for (size_t j (0); j < m_soft_clauses.size(); ++j) {
             int sc (m_soft_clauses.at(j));
-            if (j >= size - obj_val)
+            if (m_max_values.at(j) <= obj_val)
                 add_clause(-sc); // one
             else
                 add_clause(sc); // zero
@@ -488,18 +653,33 @@ namespace leximaxIST {
             print_error_msg("The problem is single-objective");
             exit(EXIT_FAILURE);
         }
-        // check if problem is satisfiable
-        if (!call_sat_solver(m_sat_solver, {})) {
-            m_status = 'u';
+        check_retention(false);
+        configure_sat_solver(m_sat_solver);
+        reduce_weights();
+        try {
+            // check if problem is satisfiable
+            if (!call_sat_solver(m_sat_solver, {})) {
+                m_status = 'u';
+                return;
+            }
+            m_status = 's'; // update status to SATISFIABLE
+            const int sum (presolve());
+            if (m_opt_mode.substr(0, 4) == "core")
+                optimise_core_guided();
+            else if (m_opt_mode == "ilp")
+                optimise_ilp();
+            else
+                optimise_non_core(sum);
+        }
+        catch (const DeadlineReached&) {
+            interrupted();
+            return;
+        }
+        catch (const std::bad_alloc&) {
+            m_deadline.interrupt(_MEMOUT_);
+            interrupted();
             return;
         }
-        m_status = 's'; // update status to SATISFIABLE
-        if (m_opt_mode.substr(0, 4) == "core")
-            optimise_core_guided();
-        else if (m_opt_mode == "ilp")
-            optimise_ilp();
-        else
-            optimise_non_core(0);            
         if (m_verbosity >= 1) // print total solving time
             print_time(read_cpu_time() - initial_time, "c Optimisation CPU time: ");
         m_status = 'o'; // update status to OPTIMUM FOUND
@@ -510,8 +690,12 @@ namespace leximaxIST {
     void Solver::optimise_non_core(int sum)
     {
         // encode sorted vectors with sorting network
+        // the upper bound of the first iteration is the first maximum of the incumbent, larger values are not encoded
+        const int ub (incumbent_max());
+        if (m_verbosity >= 1)
+            std::cout << "c Encoding the outputs of the sorting networks up to " << ub + 1 << '\n';
         for (int j (0); j < m_num_objectives; ++j)
-            encode_sorted(m_objectives.at(j), j);
+            encode_sorted(m_objectives.at(j), j, comparator_polarity(_POLARITY_UPWARD_), ub);
         if (m_verbosity >= 1)
             print_snet_info();
         // iteratively call (SAT/MaxSAT/PBO/ILP) solver
@@ -519,7 +703,7 @@ namespace leximaxIST {
             m_soft_clauses.clear();
             generate_soft_clauses(i);
             // encode bounds obtained from presolving or previous iteration
-            const int lb (encode_bounds(i, 0));
+            const int lb (encode_bounds(i, sum));
             if (i != 0) // in the first iteration i == 0 there is no relaxation
                 encode_relaxation(i);
             // encode the componentwise OR between sorted vectors (except maybe in the last iteration)
@@ -556,6 +740,7 @@ namespace leximaxIST {
     void Solver::gen_assumps(const std::vector<int> &lower_bounds, const std::vector<std::vector<int>> &max_vars_vec,
                      const std::vector<std::vector<int>> &inputs_not_sorted, std::vector<int> &assumps) const
     {
+        check_polarity(_POLARITY_UPWARD_); // the max variables are assumed to be false
         if (m_verbosity == 2)
             std::cout << "c ----------- Assumptions -----------\n";
         // determine which maximum we are minimising
@@ -581,7 +766,7 @@ namespace leximaxIST {
                 std::cout << "c " << ordinal(n+1) << " max = " << lower_bounds.at(n) << ": ";
             // add constraint that the nth max is equal to the nth lower bound
             for (size_t p (0); p < max_vars_vec.at(n).size(); ++p) {
-                if (p < max_vars_vec.at(n).size() - lower_bounds.at(n)) {
+                if (m_max_values.at(p) > lower_bounds.at(n)) {
                     // negation of max var
                     assumps.at(pos) = -(max_vars_vec.at(n).at(p));
                 }
@@ -619,27 +804,53 @@ namespace leximaxIST {
     {
         if (m_verbosity == 2)
             std::cout << "c " << ordinal(i + 1) << " maximum variables\n";
-        // the number of max_vars is equal to the maximum size of the sorted vectors
-        size_t max_size (0);
-        for (const std::vector<int> & sorted_vec : m_sorted_vecs) {
-            if (sorted_vec.size() > max_size)
-                max_size = sorted_vec.size();
-        }
-        max_vars_vec.at(i).resize(max_size);
-        for (int j (0); j < max_size; ++j) {
-            max_vars_vec.at(i).at(j) = fresh();
+        // there is a max variable for each value of the sorted vectors
+        set_max_values();
+        const size_t nb_max_vars (m_max_values.size());
+        max_vars_vec.at(i).resize(nb_max_vars);
+        for (size_t j (0); j < nb_max_vars; ++j) {
+            const int max_var (fresh());
+            max_vars_vec.at(i).at(j) = max_var;
+            // index the max variable for the processing of the cores
+            if (m_core_vars.size() <= static_cast<size_t>(max_var))
+                m_core_vars.resize(m_id_count + 1, CoreVar {-1, -1, false, false});
+            m_core_vars.at(max_var) = CoreVar {i, static_cast<int>(j), false, true};
             if (m_verbosity == 2 && j == 0)
-                std::cout << "c " << max_vars_vec.at(i).at(j) << " ... ";
-            if (m_verbosity == 2 && j == max_size - 1)
-                std::cout << max_vars_vec.at(i).at(j) << '\n';
+                std::cout << "c " << max_var << " ... ";
+            if (m_verbosity == 2 && j == nb_max_vars - 1)
+                std::cout << max_var << '\n';
         }
     }
     
+    /* index the objective variables: objective and position in inputs_not_sorted
+     * (the max variables are indexed when they are generated)
+     */
+    void Solver::index_core_vars(const std::vector<std::vector<int>> &inputs_not_sorted)
+    {
+        m_core_vars.assign(m_id_count + 1, CoreVar {-1, -1, false, false});
+        for (int j (0); j < m_num_objectives; ++j) {
+            for (int v : m_objectives.at(j))
+                m_core_vars.at(v) = CoreVar {j, -1, true, false};
+            for (size_t k (0); k < inputs_not_sorted.at(j).size(); ++k) {
+                CoreVar &cv (m_core_vars.at(inputs_not_sorted.at(j).at(k)));
+                cv.pos = k;
+                cv.in_network = false;
+            }
+        }
+    }
+    
+    const CoreVar& Solver::core_var(int var) const
+    {
+        static const CoreVar none {-1, -1, false, false};
+        const size_t v (std::abs(var));
+        return (v < m_core_vars.size()) ? m_core_vars[v] : none;
+    }
+    
     /* Remove the obj vars in inputs_not_sorted that are in core and put them in new_inputs
      * Return true if the core intersects the obj vars and false otherwise
      */
     bool Solver::find_vars_in_core(std::vector<std::vector<int>> &inputs_not_sorted, const std::vector<int> &core,
-                                    std::vector<std::vector<int>> &new_inputs) const
+                                    std::vector<std::vector<int>> &new_inputs)
     {
         for (std::vector<int> &v : new_inputs)
             v.clear();
@@ -647,23 +858,21 @@ namespace leximaxIST {
         // the core is {l1, l2, ..., ln} and -li is what appears in the assumptions
         for (int l : core) {
             // find l in inputs_not_sorted
-            bool found (false);
-            size_t i (0);
-            while (!found && i < inputs_not_sorted.size()) {
-                size_t j (0);
-                while (j < inputs_not_sorted.at(i).size() && inputs_not_sorted.at(i).at(j) != l)
-                    ++j;
-                if (j < inputs_not_sorted.at(i).size()) { // found
-                    found = true;
-                    intersects = true;
-                    // remove from inputs_not_sorted and put in new_inputs
-                    new_inputs.at(i).push_back(l);
-                    // remove by puting the last element in the position j and erasing the last entry
-                    inputs_not_sorted.at(i).at(j) = inputs_not_sorted.at(i).back();
-                    inputs_not_sorted.at(i).pop_back();
-                }
-                ++i;
-            }
+            if (l <= 0 || core_var(l).obj == -1 || core_var(l).is_max || core_var(l).in_network)
+                continue;
+            CoreVar &cv (m_core_vars.at(l));
+            const int i (cv.obj);
+            const int j (cv.pos);
+            intersects = true;
+            // remove from inputs_not_sorted and put in new_inputs
+            new_inputs.at(i).push_back(l);
+            // remove by puting the last element in the position j and erasing the last entry
+            const int last (inputs_not_sorted.at(i).back());
+            inputs_not_sorted.at(i).at(j) = last;
+            m_core_vars.at(last).pos = j;
+            inputs_not_sorted.at(i).pop_back();
+            cv.pos = -1;
+            cv.in_network = true;
         }
         if (m_verbosity >= 1) {
             std::cout << "c The core intersects the following objectives: ";
@@ -685,72 +894,80 @@ namespace leximaxIST {
         std::cout << '\n';
     }
     
-    /* generates all subsets of size n of the main set, stored in set_of_combs
-     */
-    template <typename T>
-    void combinations(std::vector<std::vector<T>> &set_of_combs, std::vector<T> main_set, std::vector<T> comb, int n)
+    // whether every objective of the set a is also in the set b
+    bool is_subset(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b)
     {
-        if (n == 1) {
-            for (const T &e : main_set) {
-                comb.push_back(e);
-                set_of_combs.push_back(comb);
-                comb.pop_back();
-            }
-        }
-        else if (main_set.size() == n) {
-            for (const T &e : main_set)
-                comb.push_back(e);
-            set_of_combs.push_back(comb);
-        }
-        else {
-            T first_el = main_set.at(0);
-            // remove first_el from main_set
-            main_set.erase(main_set.begin());
-            combinations(set_of_combs, main_set, comb, n); // combinations that don't include first_el
-            comb.push_back(first_el);
-            combinations(set_of_combs, main_set, comb, n - 1); // combinations that include first_el
+        for (size_t w (0); w < a.size(); ++w) {
+            if ((a.at(w) & ~b.at(w)) != 0)
+                return false;
         }
+        return true;
+    }
+    
+    int nb_objs_in(const std::vector<uint64_t> &objs)
+    {
+        int n (0);
+        for (uint64_t word : objs)
+            n += __builtin_popcountll(word);
+        return n;
     }
     
     /* check if no variables of max_vars_vec appear in the core
      * in this case, we can increase some lower bound of lb_map, depending on which obj funcs it intersects
      * and this may allow an increase in the lower bound of the ith maximum
+     * lb_map only has the sets of objectives intersected by some core, so the cost of a core
+     * depends on the number of those sets and not on the 2^m subsets of objectives
      * min_index : the maximum we are minimising
      */
     void Solver::change_lb_map(int min_index, std::vector<int> &lower_bounds, const std::vector<int> &core,
-                      const std::vector<std::vector<int>> &max_vars_vec, std::unordered_map<int, int> &lb_map) const
+                      std::vector<CoreLB> &lb_map) const
     {
-        std::vector<bool> intersect (m_num_objectives, false); // does the core intersect each obj
+        std::vector<uint64_t> intersect ((m_num_objectives + 63) / 64, 0); // does the core intersect each obj
+        int min_weight (0); // at least one variable of the core is true, so the sum increases by the minimum weight
         for (int lit : core) {
             // check if it is in max_vars_vec
-            for (const std::vector<int> &max_vars : max_vars_vec) {
-                for (int m : max_vars) {
-                    if (m == std::abs(lit))
-                        return; // if a max variable appears in the core we cannot increase the lower bounds
-                }
-            }
+            if (core_var(lit).is_max)
+                return; // if a max variable appears in the core we cannot increase the lower bounds
             // check which obj c belongs to
-            bool found (false);
-            int i (-1);
-            while (!found) {
-                ++i;
-                const std::vector<int> &obj (m_objectives.at(i));
-                for (int v : obj) {
-                    if (v == lit) {
-                        found = true;
-                        break;
-                    }
-                }
+            const int i (core_var(lit).obj);
+            intersect.at(i / 64) |= uint64_t(1) << (i % 64);
+            if (min_weight == 0 || weight(lit) < min_weight)
+                min_weight = weight(lit);
+        }
+        update_lb_map(min_index, lower_bounds, intersect, min_weight, lb_map);
+    }
+    
+    /* adds a core of weight core_weight that intersects the objectives of intersect to lb_map
+     * and increases lower_bounds if possible (the core is disjoint from the previous ones)
+     */
+    void Solver::update_lb_map(int min_index, std::vector<int> &lower_bounds, const std::vector<uint64_t> &intersect,
+                               int core_weight, std::vector<CoreLB> &lb_map) const
+    {
+        // update lb_map: the cores are disjoint, so the core adds to the bound of every set containing its objectives
+        bool is_new (true);
+        for (const CoreLB &entry : lb_map) {
+            if (entry.objs == intersect)
+                is_new = false;
+        }
+        if (is_new) {
+            CoreLB entry;
+            entry.objs = intersect;
+            entry.weight = 0;
+            entry.lb = 0;
+            for (const CoreLB &other : lb_map) {
+                if (is_subset(other.objs, intersect))
+                    entry.lb += other.weight;
             }
-            intersect.at(i) = true;
+            lb_map.push_back(entry);
         }
-        // update lb_map
-        int key (0);
-        for (int j (0); j < m_num_objectives; ++j) {
-            if (intersect.at(j))
-                key = key * 10 + j + 1;
+        int total (0); // bound of the sum of all objectives
+        for (CoreLB &entry : lb_map) {
+            if (entry.objs == intersect)
+                entry.weight += core_weight;
+            if (is_subset(intersect, entry.objs))
+                entry.lb += core_weight;
+            total += entry.weight;
         }
-        ++lb_map.at(key);
         if (m_verbosity == 2)
             print_lb_map(lb_map);
         // update lower_bounds if possible
@@ -758,87 +975,114 @@ namespace leximaxIST {
         // For the remaining maxima I only use the individual bounds and the bound for the sum of all objs
         // individual bounds
         std::vector<int> indiv_lbs (m_num_objectives, 0);
-        for (int j (1); j <= m_num_objectives; ++j)
-            indiv_lbs.at(j - 1) = lb_map.at(j);
+        for (const CoreLB &entry : lb_map) {
+            if (nb_objs_in(entry.objs) == 1) {
+                int j (0);
+                while (((entry.objs.at(j / 64) >> (j % 64)) & 1) == 0)
+                    ++j;
+                indiv_lbs.at(j) = entry.lb;
+            }
+        }
         std::sort (indiv_lbs.begin(), indiv_lbs.end(), descending_order);
         for (int j (0); j < m_num_objectives; ++j) {
             if (lower_bounds.at(j) < indiv_lbs.at(j))
                 lower_bounds.at(j) = indiv_lbs.at(j);
         }
         if (m_verbosity == 2) {
-            std::cout << "c LB given by keys ";
-            for (int j (1); j <= m_num_objectives; ++j)
-                std::cout << j << ' ';
-            std::cout << ": ";
+            std::cout << "c LB given by single objectives: ";
             std::cout << indiv_lbs.at(0);
             for (int j (1); j < m_num_objectives; ++j)
                 std::cout << ", " << indiv_lbs.at(j);
             std::cout << '\n';
         }
         // sum of all objs bound
-        key = 0;
-        for (int j (1); j <= m_num_objectives; ++j)
-            key = key * 10 + j;
-        int sum (lb_map.at(key)); // key = 123...m_num_objectives
+        int sum (total);
         for (int j (0); j < min_index; ++j)
             sum -= lower_bounds.at(j);
         int k (sum / (m_num_objectives - min_index));
-        if (sum % m_num_objectives != 0) // ceiling
+        if (sum % (m_num_objectives - min_index) > 0) // ceiling
             ++k;
         if (m_verbosity == 2)
-            std::cout << "c LB given by key " << key << " : " << k << '\n';
+            std::cout << "c LB given by the sum of all objectives : " << k << '\n';
         if (lower_bounds.at(min_index) < k)
             lower_bounds.at(min_index) = k;
         if (min_index == 0 || min_index == 1) {
-            // remaining combinations
-            std::vector<int> objs;
-            for (int j (1); j <= m_num_objectives; ++j)
-                objs.push_back(j);
-            for (int j (2); j < m_num_objectives; ++j) {
-                std::vector<std::vector<int>> set_of_combs;
-                std::vector<int> c;
-                combinations(set_of_combs, objs, c, j);
-                for (const std::vector<int> &comb : set_of_combs) {
-                    key = 0;
-                    for (int p (0); p < comb.size(); ++p)
-                        key = key * 10 + comb.at(p);
-                    sum = lb_map.at(key);
-                    if (min_index == 0) {
-                        k = sum / comb.size();
-                        if (sum % comb.size() != 0) // ceiling
-                            ++k;
-                    }
-                    else {
-                        int k_out (sum / comb.size()); // the 1st max is not one of the objs in comb
-                        if (sum % comb.size() != 0) // ceiling
-                            ++k_out;
-                        int k_in (sum); // the 1st max is one of the objs in comb
-                        k_in -= lower_bounds.at(0);
-                        if (k_in > 0) {
-                            k_in = k_in / (comb.size() - 1);
-                            if (k_in % (comb.size() - 1) != 0) // ceiling
-                                ++k_in;
-                        }
-                        k = std::min(k_in, k_out);
+            // remaining combinations (only the ones intersected by some core have a positive bound)
+            for (const CoreLB &entry : lb_map) {
+                const int comb_size (nb_objs_in(entry.objs));
+                if (comb_size < 2 || comb_size == m_num_objectives)
+                    continue;
+                sum = entry.lb;
+                if (min_index == 0) {
+                    k = sum / comb_size;
+                    if (sum % comb_size != 0) // ceiling
+                        ++k;
+                }
+                else {
+                    int k_out (sum / comb_size); // the 1st max is not one of the objs in comb
+                    if (sum % comb_size != 0) // ceiling
+                        ++k_out;
+                    int k_in (sum); // the 1st max is one of the objs in comb
+                    k_in -= lower_bounds.at(0);
+                    if (k_in > 0) {
+                        const int rest (k_in % (comb_size - 1));
+                        k_in = k_in / (comb_size - 1);
+                        if (rest != 0) // ceiling
+                            ++k_in;
                     }
-                    if (m_verbosity == 2)
-                        std::cout << "c LB given by key " << key << " : " << k << '\n';
-                    if (lower_bounds.at(min_index) < k)
-                        lower_bounds.at(min_index) = k;
+                    k = std::min(k_in, k_out);
                 }
+                if (lower_bounds.at(min_index) < k)
+                    lower_bounds.at(min_index) = k;
             }
+            if (m_verbosity == 2)
+                std::cout << "c LB given by the sets of objectives intersected by cores : " << lower_bounds.at(min_index) << '\n';
         }
     }
     
     void Solver::add_unit_core_vars(const std::vector<std::vector<int>> &unit_core_vars, int j)
     {
-        // add unit_core_vars to the sorted vector
-        for (int v : unit_core_vars.at(j))
+        // add unit_core_vars to the sorted vector: they are true, so their weight is added to the values of the sorted vector
+        for (int v : unit_core_vars.at(j)) {
+            for (int &value : m_sorted_values.at(j))
+                value += weight(v);
             m_sorted_vecs.at(j).push_back(v);
+            m_sorted_values.at(j).push_back(weight(v));
+        }
         if (m_verbosity == 2)
             print_sorted_vec(j);
     }
     
+    /* the cores of the MaxSAT presolve are the first disjoint cores: their variables are removed
+     * from inputs_not_sorted and their weights are added to lb_map
+     * the bound of a set of objectives is still the total weight of the cores with variables in the set
+     * because the variables of a totalizer only count in the cores of its inputs,
+     * and the cores found afterwards do not have the variables of these cores
+     */
+    void Solver::seed_sum_cores(std::vector<std::vector<int>> &inputs_not_sorted, std::vector<std::vector<int>> &inputs_to_sort,
+                                std::vector<std::vector<int>> &unit_core_vars, std::vector<int> &lower_bounds,
+                                std::vector<CoreLB> &lb_map)
+    {
+        if (m_verbosity >= 1)
+            std::cout << "c Using the " << m_sum_cores.size() << " cores of the MaxSAT presolve\n";
+        std::vector<std::vector<int>> new_inputs (m_num_objectives, std::vector<int>());
+        for (const SumCore &core : m_sum_cores) {
+            std::vector<uint64_t> intersect ((m_num_objectives + 63) / 64, 0);
+            for (int v : core.vars) {
+                const int j (core_var(v).obj);
+                intersect.at(j / 64) |= uint64_t(1) << (j % 64);
+            }
+            update_lb_map(0, lower_bounds, intersect, core.weight, lb_map);
+            find_vars_in_core(inputs_not_sorted, core.vars, new_inputs);
+            for (int j (0); j < m_num_objectives; ++j) {
+                std::vector<int> &inputs (core.vars.size() == 1 ? unit_core_vars.at(j) : inputs_to_sort.at(j));
+                inputs.insert(inputs.end(), new_inputs.at(j).begin(), new_inputs.at(j).end());
+            }
+        }
+        if (m_verbosity == 2)
+            print_lower_bounds(lower_bounds);
+    }
+    
     /* returns true if it is possible to satisfy all soft clauses, and false otherwise
      * gets disjoint cores and removes the variables from inputs_not_sorted in the cores
      * the sorting networks are generated with the variables from the cores
@@ -846,7 +1090,7 @@ namespace leximaxIST {
      */
     bool Solver::disjoint_cores(std::vector<std::vector<int>> &inputs_not_sorted,
                                  std::vector<std::vector<int>> &unit_core_vars,
-                                 std::vector<int> &lower_bounds, std::unordered_map<int, int> &lb_map)
+                                 std::vector<int> &lower_bounds, std::vector<CoreLB> &lb_map)
     {
         bool rv (true);
         if (m_verbosity >= 1)
@@ -856,6 +1100,10 @@ namespace leximaxIST {
          * the last iteration is for finding the remaining cores intersecting 
          */
         std::vector<std::vector<int>> inputs_to_sort(m_num_objectives, std::vector<int>());
+        if (!m_sum_cores.empty()) {
+            rv = false;
+            seed_sum_cores(inputs_not_sorted, inputs_to_sort, unit_core_vars, lower_bounds, lb_map);
+        }
         for (int i (0); i <= m_num_objectives; ++i) {
             std::vector<int> assumps;
             if (i == m_num_objectives) {
@@ -865,7 +1113,7 @@ namespace leximaxIST {
                 }
             }
             else {
-                for (int v : m_objectives.at(i))
+                for (int v : inputs_not_sorted.at(i))
                     assumps.push_back(-v);
             }
             if (m_verbosity == 2)
@@ -877,8 +1125,7 @@ namespace leximaxIST {
                     std::cout << "c Core size: " << core.size() << '\n';
                     print_core(core);
                 }
-                const std::vector<std::vector<int>> max_vars_vec; // this is empty
-                change_lb_map(0, lower_bounds, core, max_vars_vec, lb_map); // change lb_map and possibly lower_bounds
+                change_lb_map(0, lower_bounds, core, lb_map); // change lb_map and possibly lower_bounds
                 // get the variables in the core
                 std::vector<std::vector<int>> new_inputs(m_num_objectives, std::vector<int>());
                 find_vars_in_core(inputs_not_sorted, core, new_inputs);
@@ -921,7 +1168,7 @@ namespace leximaxIST {
         }
         // construct the sorting networks
         for (int j (0); j < m_num_objectives; ++j) {
-            encode_sorted(inputs_to_sort.at(j), j);
+            encode_sorted(inputs_to_sort.at(j), j, comparator_polarity(_POLARITY_UPWARD_), weight_sum(inputs_to_sort.at(j)));
             add_unit_core_vars(unit_core_vars, j);
         }
         if (m_verbosity >= 1)
@@ -940,35 +1187,34 @@ namespace leximaxIST {
             ++i;
         }
         --i;
+        const int max_index (i);
         const std::vector<int> &max_vars_ith (max_vars_vec.at(i));
         int max_pos (-1);
         // find the max position in max_vars_ith of the variables in the core
+        // (the max variables are sorted, so the one with the max position (smallest value) gives the weakest and valid bound)
         for (int v : core) {
-            // find v in max_vars_ith
-            for (int k (0); k < max_vars_ith.size(); ++k) {
-                if (v == max_vars_ith.at(k)) {
-                    max_pos = k;
-                    break;
-                }
-            }
+            const CoreVar &cv (core_var(v));
+            if (cv.is_max && cv.obj == max_index && cv.pos > max_pos && max_vars_ith.at(cv.pos) == v)
+                max_pos = cv.pos;
         }
         if (max_pos == -1) {
             print_error_msg("In function increase_lb: max_pos == -1");
             exit(EXIT_FAILURE);
         }
         // set lower bound
-        lower_bounds.at(i) = max_vars_ith.size() - max_pos;
+        lower_bounds.at(i) = m_max_values.at(max_pos);
     }
     
     // fix the value of the jth max in the hard clauses, not in assumps
     void Solver::fix_max(int j, const std::vector<std::vector<int>> &max_vars_vec, const std::vector<int> &lower_bounds)
     {
+        check_polarity(_POLARITY_UPWARD_); // the lower bound of the maximum is implied anyway
         if (m_verbosity == 2)
             std::cout << "c Fixing the value of the " + ordinal(j + 1) + " maximum\n";
         int obj_val (lower_bounds.at(j));
-        for (int k (0); k < max_vars_vec.at(j).size(); ++k) {
+        for (size_t k (0); k < max_vars_vec.at(j).size(); ++k) {
             int var (max_vars_vec.at(j).at(k));
-            if (k >= max_vars_vec.at(j).size() - obj_val)
+            if (m_max_values.at(k) <= obj_val)
                 add_clause(var); // one
             else
                 add_clause(-var); // zero
@@ -1010,67 +1256,28 @@ namespace leximaxIST {
         }
     }
     
-    /* set lb_map with all the keys and set the lower bounds to 0
-     * for example, the lower bound of f1 + f2 corresponds to the key 12
-     * the lower bound of f1 corresponds to the key 1
-     * the lower bound of f2 + f3 corresponds to the key 23
-     */
-    void Solver::initialise_lb_map(std::unordered_map<int, int> &lb_map, int nb_objs) const
-    {
-        std::vector<int> main_set;
-        for (int j (1); j <= nb_objs; ++j)
-            main_set.push_back(j);
-        if (m_verbosity == 2)
-            std::cout << "c Initialise lb_map - Combinations:\n";
-        for (int j (1); j <= nb_objs; ++j) { // combinations of 1, 2, ..., nb_objs objectives
-            std::vector<std::vector<int>> set_of_combs;
-            std::vector<int> comb;
-            combinations(set_of_combs, main_set, comb, j);
-            for (const std::vector<int> &c : set_of_combs) {
-                if (m_verbosity == 2)
-                    std::cout << "c ";
-                int key (0);
-                for (int k : c) {
-                    key = key * 10 + k;
-                    if (m_verbosity == 2)
-                        std::cout << k << ' ';
-                }
-                if (m_verbosity == 2)
-                    std::cout << '\n';
-                lb_map.insert(std::make_pair(key, 0));
-            }
-        }
-    }
-    
     void Solver::optimise_core_guided()
     {
-        IpasirWrap *solver (m_sat_solver);
-        if (m_opt_mode == "core_rebuild") {
-            solver = new IpasirWrap();
-            solver->addClauses(m_input_hard);
-        }
         std::vector<int> lower_bounds (m_num_objectives, 0);
-        std::unordered_map<int, int> lb_map; // map for the lower bounds of the obj funcs
-        initialise_lb_map(lb_map, m_num_objectives);
+        std::vector<CoreLB> lb_map; // lower bounds of the sums of the sets of obj funcs intersected by cores
         std::vector<std::vector<int>> unit_core_vars (m_num_objectives, std::vector<int>());
         std::vector<std::vector<int>> max_vars_vec (m_num_objectives, std::vector<int>());
         std::vector<std::vector<int>> inputs_not_sorted (m_num_objectives, std::vector<int>());
         std::vector<int> assumps;
         for (int j (0); j < m_num_objectives; ++j)
             inputs_not_sorted.at(j) = m_objectives.at(j);
+        index_core_vars(inputs_not_sorted);
         if (m_disjoint_cores && (m_opt_mode != "core_static")) {
             if (disjoint_cores(inputs_not_sorted, unit_core_vars, lower_bounds, lb_map))
                 return;
         }
         if (m_opt_mode == "core_static") {
             for (int j (0); j < m_num_objectives; ++j)
-                encode_sorted(m_objectives.at(j), j);
+                encode_sorted(m_objectives.at(j), j, comparator_polarity(_POLARITY_UPWARD_), weight_sum(m_objectives.at(j)));
         }
         if ((m_opt_mode == "core_static") || m_disjoint_cores) {
             generate_max_vars(0, max_vars_vec);
             componentwise_OR(0, max_vars_vec.at(0));
-            if (m_opt_mode == "core_rebuild")
-                solver->addClauses(m_encoding); // add the encoding to the solver
         }
         if (m_verbosity >= 1)
             print_snet_info();
@@ -1084,17 +1291,13 @@ namespace leximaxIST {
                 if (m_opt_mode == "core_static")
                     fix_max(i - 1, max_vars_vec, lower_bounds);
                 // encode relaxation and componentwise disjunction
-                if (m_opt_mode == "core_rebuild")
-                    m_encoding.clear();
                 encode_relaxation(i);
                 generate_max_vars(i, max_vars_vec);
                 componentwise_OR(i, max_vars_vec.at(i));
-                if (m_opt_mode == "core_rebuild")
-                    solver->addClauses(m_encoding);
                 gen_assumps(lower_bounds, max_vars_vec, inputs_not_sorted, assumps);
             }
-            while (!call_sat_solver(solver, assumps)) {
-                std::vector<int> core (solver->conflict());
+            while (!call_sat_solver(m_sat_solver, assumps)) {
+                std::vector<int> core (m_sat_solver->conflict());
                 if (m_verbosity >= 1)
                     std::cout << "c Core size: " << core.size() << '\n';
                 if (m_verbosity == 2)
@@ -1103,13 +1306,13 @@ namespace leximaxIST {
                 if (!find_vars_in_core(inputs_not_sorted, core, new_inputs)) // increase the ith lower bound
                     increase_lb(lower_bounds, core, max_vars_vec);
                 else {
-                    change_lb_map(i, lower_bounds, core, max_vars_vec, lb_map); // possibly increase lower bounds
+                    change_lb_map(i, lower_bounds, core, lb_map); // possibly increase lower bounds
                     // add to inputs_to_sort
                     std::vector<std::vector<int>> inputs_to_sort (new_inputs);
                     if (m_disjoint_cores) {
                         gen_assumps(lower_bounds, max_vars_vec, inputs_not_sorted, assumps);
-                        while (!call_sat_solver(solver, assumps)) {
-                            std::vector<int> core (solver->conflict());
+                        while (!call_sat_solver(m_sat_solver, assumps)) {
+                            std::vector<int> core (m_sat_solver->conflict());
                             if (m_verbosity >= 1)
                                 std::cout << "c Core size: " << core.size() << '\n';
                             if (m_verbosity == 2)
@@ -1120,7 +1323,7 @@ namespace leximaxIST {
                                     print_lower_bounds(lower_bounds);
                             }
                             else {
-                                change_lb_map(i, lower_bounds, core, max_vars_vec, lb_map); // possibly increase lower bounds
+                                change_lb_map(i, lower_bounds, core, lb_map); // possibly increase lower bounds
                                 // add new_inputs to inputs_to_sort
                                 for (int j (0); j < m_num_objectives; ++j) {
                                     size_t old_size (inputs_to_sort.at(j).size());
@@ -1139,8 +1342,13 @@ namespace leximaxIST {
                         if (m_opt_mode == "core_merge")
                             merge_core_guided(inputs_to_sort, unit_core_vars);
                         if (m_opt_mode == "core_rebuild") {
+                            // the encoding is regenerated in a new SAT solver with the input hard clauses
                             m_encoding.clear();
                             reset_id_count(); // since some variables have been deleted
+                            delete m_sat_solver;
+                            m_sat_solver = new IpasirWrap();
+                            configure_sat_solver(m_sat_solver);
+                            m_sat_solver->addClauses(m_input_hard);
                         }
                         if (m_opt_mode == "core_rebuild" || m_opt_mode == "core_rebuild_incr") {
                             // rebuild the sorting networks
@@ -1149,7 +1357,7 @@ namespace leximaxIST {
                             for (int j (0); j < m_num_objectives; ++j) {
                                 if (m_opt_mode == "core_rebuild" || !inputs_to_sort.at(j).empty()) {
                                     // do not rebuild only if incremental and there are no new variables to add
-                                    encode_sorted(inputs_sorted.at(j), j);
+                                    encode_sorted(inputs_sorted.at(j), j, comparator_polarity(_POLARITY_UPWARD_), weight_sum(inputs_sorted.at(j)));
                                     add_unit_core_vars(unit_core_vars, j);
                                 }
                             }
@@ -1160,12 +1368,6 @@ namespace leximaxIST {
                             generate_max_vars(j, max_vars_vec);
                             componentwise_OR(j, max_vars_vec.at(j));
                         }
-                        if (m_opt_mode == "core_rebuild") { // create a new sat solver and add clauses
-                            delete solver;
-                            solver = new IpasirWrap();
-                            solver->addClauses(m_input_hard);
-                            solver->addClauses(m_encoding);
-                        }
                         if (m_verbosity >= 1)
                             print_snet_info();
                     }
@@ -1175,8 +1377,6 @@ namespace leximaxIST {
                 gen_assumps(lower_bounds, max_vars_vec, inputs_not_sorted, assumps);
             }
         }
-        if (m_opt_mode == "core_rebuild")
-            delete solver;
     }
 
 }/* namespace leximaxIST */
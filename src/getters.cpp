@@ -1,9 +1,13 @@
 #include <leximaxIST_Solver.h>
 #include <vector>
 #include <iostream>
+#include <algorithm> // std::sort
+#include <cstdlib>
 
 namespace leximaxIST {
 
+    bool descending_order (int i, int j);
+
     /* int Solver::get_num_opts() const
     {
         return m_num_opts;
@@ -17,6 +21,8 @@ namespace leximaxIST {
     {
         return m_status; 
     }
+    
+    int Solver::get_interrupt() const { return m_deadline.reason(); }
 
     std::vector<int> Solver::get_solution() const 
     {
@@ -31,6 +37,7 @@ namespace leximaxIST {
     }
 
     // if unsat return empty vector
+    // the values are divided by m_weights_gcd (this is the scale used in the encodings)
     std::vector<int> Solver::get_objective_vector(const std::vector<int> &assignment) const
     {
         std::vector<int> objective_vector;
@@ -39,7 +46,7 @@ namespace leximaxIST {
                 int obj_value (0);
                 for (int var : obj_func) {
                     if (assignment.at(var) > 0)
-                        ++obj_value;
+                        obj_value += weight(var);
                 }
                 objective_vector.push_back(obj_value);
             }
@@ -47,20 +54,82 @@ namespace leximaxIST {
         return objective_vector;
     }
 
-    std::vector<int> Solver::get_objective_vector() const
+    /* The objective variables of each objective are usually consecutive (see add_soft_clauses),
+     * so each objective value is a branch-free sum over a contiguous range of the model and of m_eval_weights.
+     * Otherwise (m_eval_ranges is false, e.g. after read_snapshot) the sum goes through the objective variables.
+     * The weights are only known after reduce_weights(), before that get_objective_vector() is used.
+     */
+    void Solver::evaluate(const std::vector<int> &model, std::vector<int> &obj_vec, std::vector<int> &sorted) const
     {
-        std::vector<int> objective_vector;
-        if (!m_solution.empty()) {
-            for (const std::vector<int> &obj_func : m_objectives) {
+        obj_vec.clear();
+        sorted.clear();
+        if (model.empty())
+            return;
+        if (m_eval_weights.size() != m_obj_weights.size()) {
+            obj_vec = get_objective_vector(model);
+        }
+        else {
+            obj_vec.resize(m_num_objectives);
+            for (int i (0); i < m_num_objectives; ++i) {
+                const std::vector<int> &objective (m_objectives[i]);
                 int obj_value (0);
-                for (int var : obj_func) {
-                    if (m_solution[var] > 0)
-                        ++obj_value;
+                if (!m_eval_ranges) {
+                    for (int var : objective)
+                        obj_value += (model[var] > 0) * m_eval_weights[var];
                 }
-                objective_vector.push_back(obj_value);
+                else if (!objective.empty()) {
+                    const int *values (model.data() + objective.front());
+                    const int *weights (m_eval_weights.data() + objective.front());
+                    for (size_t k (0); k < objective.size(); ++k)
+                        obj_value += (values[k] > 0) * weights[k];
+                }
+                obj_vec[i] = obj_value;
             }
         }
+        sorted.assign(obj_vec.begin(), obj_vec.end());
+        std::sort(sorted.begin(), sorted.end(), descending_order);
+    }
+
+    // the values are in the scale of the input weights
+    std::vector<int> Solver::get_objective_vector() const
+    {
+        std::vector<int> objective_vector (get_objective_vector(m_solution));
+        for (int &obj_value : objective_vector)
+            obj_value *= m_weights_gcd;
         return objective_vector;
     }
+    
+    int Solver::weight(int var) const
+    {
+        if (static_cast<size_t>(var) >= m_obj_weights.size())
+            return 0; // not an objective variable
+        return m_obj_weights[var] / m_weights_gcd;
+    }
+    
+    // sum of the weights of the variables of lits (the sign of the literals is ignored)
+    int Solver::weight_sum(const std::vector<int> &lits) const
+    {
+        int sum (0);
+        for (int lit : lits)
+            sum += weight(std::abs(lit));
+        return sum;
+    }
+    
+    bool Solver::is_weighted(int i) const
+    {
+        for (int var : m_objectives.at(i)) {
+            if (weight(var) != 1)
+                return true;
+        }
+        return false;
+    }
+    
+    uint64_t Solver::hard_weight() const
+    {
+        uint64_t sum (1);
+        for (int w : m_soft_weights)
+            sum += w;
+        return sum;
+    }
 
 }/* namespace leximaxIST */
@@ -26,11 +26,17 @@ namespace leximaxIST {
         return i_str;
     }
     
-    void print_lb_map(const std::unordered_map<int, int> &lb_map)
+    void print_lb_map(const std::vector<CoreLB> &lb_map)
     {
         std::cout << "c -------------- lb_map --------------\n";
-        for (const std::pair<int, int> &p : lb_map)
-            std::cout << "c " << p.first << " : " << p.second << '\n';
+        for (const CoreLB &entry : lb_map) {
+            std::cout << "c {";
+            for (size_t j (0); j < 64 * entry.objs.size(); ++j) {
+                if ((entry.objs.at(j / 64) >> (j % 64)) & 1)
+                    std::cout << ' ' << j + 1;
+            }
+            std::cout << " } : " << entry.lb << '\n';
+        }
         std::cout << "c ------------------------------------\n";
     }
     
@@ -121,13 +127,13 @@ namespace leximaxIST {
         std::cout << "c \tNext clause choice policy: " << m_mss_tolerance << "% \n";
     }
     
-    // in this case we already have computed obj_vec
+    // in this case we already have computed obj_vec (values divided by the gcd of the weights)
     void Solver::print_obj_vector(const std::vector<int> &obj_vec) const
     {
         if (!obj_vec.empty()) {
             std::cout << "o ";
             for (int v : obj_vec)
-                std::cout << v << ' ';
+                std::cout << v * m_weights_gcd << ' ';
             std::cout << '\n';
         }
     }
@@ -147,15 +153,15 @@ namespace leximaxIST {
     void Solver::print_soft_clauses() const
     {
         std::cout << "c -------- Soft Clauses of current iteration --------\n";
-        for (int lit : m_soft_clauses)
-            std::cout << "c " << lit << " 0\n";
+        for (size_t j (0); j < m_soft_clauses.size(); ++j)
+            std::cout << "c " << m_soft_clauses[j] << " 0 (weight " << m_soft_weights.at(j) << ")\n";
     }
     
     void Solver::print_sorted_vec (int i) const
     {
         std::cout << "c ---------------- m_sorted_vecs[" << i << "] -----------------\n";
         for(size_t j{0}; j < m_sorted_vecs.at(i).size(); j++)
-            std::cout << "c sorted_vec[" << j << "]: " << m_sorted_vecs.at(i).at(j) << '\n';
+            std::cout << "c sorted_vec[" << j << "]: " << m_sorted_vecs.at(i).at(j) << " (>= " << m_sorted_values.at(i).at(j) << ")\n";
     }
     
     // print separately the variables of the jth objective that are in the sorting network and those that are not
@@ -190,15 +196,30 @@ namespace leximaxIST {
         size_t num_terms (objective.size());
         std::cout << "c --------------- Objective Function " << i << " (size = ";
         std::cout << num_terms << ") --------------\n";
-        for (size_t j = 0; j < num_terms; ++j)
-            std::cout << "c " << objective.at(j) << '\n';
+        for (size_t j = 0; j < num_terms; ++j) {
+            std::cout << "c " << objective.at(j);
+            if (is_weighted(i))
+                std::cout << " (weight " << weight(objective.at(j)) << ")";
+            std::cout << '\n';
+        }
     }
     
     void Solver::print_snet_info() const
     {
         for (int i (0); i < m_num_objectives; ++i) {
-            std::cout << "c " << ordinal(i + 1) << " Sorting Network: ";
-            std::cout << m_snet_info.at(i).first << " wires and " << m_snet_info.at(i).second << " comparators\n";
+            const int sorter (objective_sorter(i));
+            if (sorter == _SORTER_TOTALIZER_) {
+                std::cout << "c " << ordinal(i + 1) << (is_weighted(i) ? " Generalized Totalizer: " : " Totalizer: ");
+                std::cout << m_snet_info.at(i).first << " inputs and " << m_snet_info.at(i).second << " clauses\n";
+            }
+            else if (sorter == _SORTER_PAIRWISE_) {
+                std::cout << "c " << ordinal(i + 1) << " Pairwise Network: ";
+                std::cout << m_snet_info.at(i).first << " wires and " << m_snet_info.at(i).second << " comparators\n";
+            }
+            else {
+                std::cout << "c " << ordinal(i + 1) << " Sorting Network: ";
+                std::cout << m_snet_info.at(i).first << " wires and " << m_snet_info.at(i).second << " comparators\n";
+            }
         }
     }
     
@@ -213,10 +234,8 @@ namespace leximaxIST {
             std::cout << mss.at(i).size() << ' ';
         std::cout << '\n';
         std::cout << "c Upper Bounds: ";
-        for (int i(0); i < m_num_objectives; ++i) {
-            const int obj_size (m_objectives.at(i).size());
-            std::cout << obj_size - mss.at(i).size() << ' ';
-        }
+        for (int i(0); i < m_num_objectives; ++i)
+            std::cout << weight_sum(m_objectives.at(i)) - weight_sum(mss.at(i)) << ' ';
         std::cout << '\n';
     }
     
@@ -229,7 +248,7 @@ namespace leximaxIST {
     }
 
     // leadingStr can be "c ", to print comments, or e.g. "100 " to print weights
-    void Solver::print_clause(std::ostream &output, const Clause &clause, const std::string &leadingStr) const
+    void Solver::print_clause(std::ostream &output, ClauseRef clause, const std::string &leadingStr) const
     {
         output << leadingStr;
         for (int lit : clause)
@@ -237,43 +256,43 @@ namespace leximaxIST {
         output << "0\n";
     }
 
-    void Solver::print_soft_clauses(std::ostream &output) const
+    void Solver::print_soft_clauses(Writer &output) const
     {
-        for (int lit : m_soft_clauses)
-            output << "1 " << lit << " 0\n";
+        for (size_t j (0); j < m_soft_clauses.size(); ++j)
+            output << m_soft_weights.at(j) << ' ' << m_soft_clauses[j] << " 0\n";
     }
     
-    void Solver::print_hard_clauses(std::ostream &output) const
+    void Solver::print_hard_clauses(Writer &output) const
     {
-        size_t weight (m_soft_clauses.size() + 1);
-        for (const Clause &cl : m_input_hard) {
-            output << weight << " ";
-            print_clause(output, cl);
-        }
-        for (const Clause &cl : m_encoding) {
-            output << weight << " ";
-            print_clause(output, cl);
+        const std::string weight (std::to_string(hard_weight()) + " ");
+        for (const ClauseArena *clauses : {&m_input_hard, &m_encoding}) {
+            for (const ClauseRef cl : *clauses) {
+                output << weight;
+                for (int lit : cl)
+                    output << lit << ' ';
+                output << "0\n";
+            }
         }
     }
 
-    void Solver::print_pb_constraint(const Clause &cl, std::ostream &output) const
+    void Solver::print_pb_constraint(ClauseRef cl, Writer &output) const
     {
         int num_negatives(0);
         for (int literal : cl) {
             bool sign = literal > 0;
             if (!sign)
                 ++num_negatives;
-            output << (sign ? "+1" : "-1") << m_multiplication_string << "x" << (sign ? literal : -literal) << " ";
+            output << (sign ? "+1" : "-1") << m_multiplication_string << 'x' << (sign ? literal : -literal) << ' ';
         }
         output << " >= " << 1 - num_negatives << ";\n";
     }
 
-    void Solver::print_lp_constraint(const Clause &cl, std::ostream &output) const
+    void Solver::print_lp_constraint(ClauseRef cl, Writer &output) const
     {
         int num_negatives(0);
         size_t nb_vars_in_line (0);
         for (size_t j (0); j < cl.size(); ++j) {
-            int literal (cl.at(j));
+            int literal (cl[j]);
             bool sign = literal > 0;
             if (!sign)
                 ++num_negatives;
@@ -348,7 +367,7 @@ namespace leximaxIST {
             for (const std::vector<int> &sorted_vec : m_sorted_vecs) {
                 std::cout << "c Sorted vec " << j << ": ";
                 for (int var : sorted_vec) {
-                    if (m_solution.at(var) > 0)
+                    if (static_cast<size_t>(var) < m_solution.size() && m_solution.at(var) > 0) // the solution may be older than var
                         std::cout << var << ' ';
                 }
                 std::cout << '\n';
@@ -361,7 +380,7 @@ namespace leximaxIST {
                 for (const std::vector<int> &sorted_relax : sorted_relax_vecs) {
                     std::cout << "c Sorted Relax vec " << k << ": ";
                     for (int var : sorted_relax) {
-                        if (m_solution[var] > 0)
+                        if (static_cast<size_t>(var) < m_solution.size() && m_solution[var] > 0)
                             std::cout << var << ' ';
                     }
                     std::cout << '\n';
@@ -4,6 +4,7 @@
 #include <string>
 #include <iostream>
 #include <algorithm> // std::sort
+#include <numeric> // std::gcd
 #include <climits>
 #include <cstdlib>
 #include <sys/types.h>
@@ -14,7 +15,7 @@ namespace leximaxIST {
     bool descending_order (int i, int j);
     
     // set_of_clauses can be m_input_hard for input hard clauses or m_encoding for encoding hard clauses
-    void Solver::add_clause(const Clause &cl, std::vector<Clause> &set_of_clauses)
+    void Solver::add_clause(ClauseRef cl, ClauseArena &set_of_clauses)
     {
         if (cl.empty()) {
             print_error_msg("Empty hard clause");
@@ -27,7 +28,7 @@ namespace leximaxIST {
     }
     
     // this is public, one can use it to add input hard clauses
-    void Solver::add_hard_clause(const Clause &cl)
+    void Solver::add_hard_clause(ClauseRef cl)
     {
         if (m_sat_solver == nullptr)
             m_sat_solver = new IpasirWrap();
@@ -38,31 +39,61 @@ namespace leximaxIST {
             m_status = '?';
     }
     
+    // bulk version of add_hard_clause
+    void Solver::add_hard_clauses(const ClauseArena &clauses)
+    {
+        for (ClauseRef cl : clauses)
+            add_hard_clause(cl);
+    }
+    
+    // fresh() numbers the encoding variables after the reserved ones
+    void Solver::reserve_vars(int nb_vars)
+    {
+        if (nb_vars > m_id_count)
+            m_id_count = nb_vars;
+    }
+    
     void Solver::add_clause_enc(const Clause &cl)
     {
-        add_clause(cl, m_encoding);
-        // In 'core-rebuild' we create a new ipasir solver everytime the sorting networks grow
-        // is this really necessary ?  maybe I can remove the if
-        if (m_opt_mode != "core-rebuild")
-            m_sat_solver->addClause(cl);
+        if (cl.empty()) {
+            print_error_msg("Empty hard clause");
+            exit(EXIT_FAILURE);
+        }
+        m_encoding.push_back(cl);
+        encoding_clause_added();
     }
 
+    // the fixed-arity clauses are added directly to m_encoding (no temporary Clause)
     void Solver::add_clause(int l)
     {
-        const Clause cl {l};
-        add_clause_enc(cl);
+        m_encoding.push_back(l);
+        encoding_clause_added();
     }
     
     void Solver::add_clause(int l1, int l2)
     {
-        const Clause cl {l1, l2};
-        add_clause_enc(cl);
+        m_encoding.push_back(l1, l2);
+        encoding_clause_added();
     }
     
     void Solver::add_clause(int l1, int l2, int l3)
     {
-        const Clause cl {l1, l2, l3};
-        add_clause_enc(cl);
+        m_encoding.push_back(l1, l2, l3);
+        encoding_clause_added();
+    }
+    
+    // the last clause of m_encoding was just added
+    void Solver::encoding_clause_added()
+    {
+        const ClauseRef cl (m_encoding.back());
+        update_id_count(cl);
+        if (m_verbosity == 2)
+            print_clause(std::cout, cl, "c ");
+        // in core_rebuild, m_sat_solver is replaced by a new SAT solver everytime the sorting networks grow
+        m_sat_solver->addClause(cl);
+        // the encodings are the longest loops without SAT calls
+        if (m_deadline.poll())
+            throw DeadlineReached();
     }
     
     int Solver::fresh()
@@ -123,7 +154,7 @@ namespace leximaxIST {
     void Solver::set_ilp_solver(const std::string &ilp_solver)
     {
         //const std::vector<std::string> valid_ilp_solvers {"cplex", "gurobi", "glpk", "scip", "cbc", "lpsolve"};
-        const std::string valid_ilp_solvers[2] {"cplex", "gurobi"};
+        const std::string valid_ilp_solvers[3] {"cplex", "gurobi", "cbc"};
         bool found (false);
         for (const std::string &valid_ilp_solver : valid_ilp_solvers)
             if (ilp_solver == valid_ilp_solver)
@@ -154,6 +185,8 @@ namespace leximaxIST {
     
     void Solver::set_leave_tmp_files(bool val) { m_leave_tmp_files = val; }
 
+    void Solver::set_gzip_input(bool val) { m_gzip_input = val; }
+
     void Solver::set_multiplication_string(const std::string &str) { m_multiplication_string = str; }
     
     void Solver::set_maxsat_presolve(bool v)
@@ -170,41 +203,66 @@ namespace leximaxIST {
         m_maxsat_psol_cmd = cmd;
     }
     
-    std::vector<int> Solver::set_solution(std::vector<int> &model)
+    const std::vector<int>& Solver::set_solution(std::vector<int> &model)
     {
-        const std::vector<int> &new_obj_vec (get_objective_vector(model));
-        const std::vector<int> &old_obj_vec (get_objective_vector(m_solution));
         if (model.empty())
-            return old_obj_vec;
-        if (m_solution.empty()) {
+            return m_solution_obj_vec;
+        // only the new model is evaluated, the objective vector of m_solution is cached
+        evaluate(model, m_eval_obj_vec, m_eval_sorted);
+        // the sorted vectors are compared lexicographically (if they are leximax-equal m_solution is kept)
+        if (m_solution.empty() || m_eval_sorted < m_solution_sorted) {
             m_solution.swap(model);
-            model.clear();
+            m_solution_obj_vec.swap(m_eval_obj_vec);
+            m_solution_sorted.swap(m_eval_sorted);
             if (m_verbosity >= 1) {
                 print_time(read_cpu_time(), "c Leximax-better solution found: ");
-                print_obj_vector(new_obj_vec);
+                print_obj_vector(m_solution_obj_vec);
             }
-            return new_obj_vec;
         }
-        std::vector<int> s_new_obj_vec (new_obj_vec);
-        std::vector<int> s_old_obj_vec (old_obj_vec);
-        std::sort(s_new_obj_vec.begin(), s_new_obj_vec.end(), descending_order);
-        std::sort(s_old_obj_vec.begin(), s_old_obj_vec.end(), descending_order);
-        for (size_t j (0); j < s_new_obj_vec.size(); ++j) {
-            if (s_new_obj_vec.at(j) < s_old_obj_vec.at(j)) { // model is better
-                m_solution.swap(model);
-                model.clear();
-                if (m_verbosity >= 1) {
-                    print_time(read_cpu_time(), "c Leximax-better solution found: ");
-                    print_obj_vector(new_obj_vec);
+        model.clear();
+        return m_solution_obj_vec;
+    }
+    
+    void Solver::update_solution_cache()
+    {
+        evaluate(m_solution, m_solution_obj_vec, m_solution_sorted);
+    }
+    
+    /* Objective values are internally divided by the gcd of the weights of all objectives,
+     * so that the sorted vectors are as short as possible.
+     * The gcd must be the same for all objectives, otherwise the leximax order would change.
+     */
+    void Solver::reduce_weights()
+    {
+        uint64_t gcd (0);
+        for (const std::vector<int> &objective : m_objectives) {
+            uint64_t sum (0);
+            for (int var : objective) {
+                gcd = std::gcd(gcd, m_obj_weights.at(var));
+                sum += m_obj_weights.at(var);
+                if (sum > INT_MAX) {
+                    print_error_msg("The sum of the weights of an objective function exceeds INT_MAX");
+                    exit(EXIT_FAILURE);
                 }
-                return new_obj_vec;
             }
-            else if (s_new_obj_vec.at(j) > s_old_obj_vec.at(j)) { // m_solution is better
-                model.clear();
-                return old_obj_vec;
+        }
+        m_weights_gcd = (gcd == 0) ? 1 : gcd;
+        if (m_verbosity >= 1 && m_weights_gcd > 1)
+            std::cout << "c Objective weights are divided by their gcd: " << m_weights_gcd << '\n';
+        // weights used in the evaluation of models (the objective values are in the new scale)
+        m_eval_weights.assign(m_obj_weights.size(), 0);
+        m_eval_ranges = true;
+        for (const std::vector<int> &objective : m_objectives) {
+            // add_soft_clauses gives consecutive variables, the objectives of a snapshot may not have them
+            for (size_t k (1); k < objective.size(); ++k) {
+                if (objective[k] != objective[k - 1] + 1)
+                    m_eval_ranges = false;
             }
+            for (int var : objective)
+                m_eval_weights.at(var) = weight(var);
         }
-        return old_obj_vec; // the obj vecs are leximax-equal
+        if (!m_solution.empty())
+            update_solution_cache();
     }
     
     // set m_id_count to the maximum id without the encoding - m_input_nb_vars + obj vars
@@ -218,7 +276,7 @@ namespace leximaxIST {
             std::cout << "c Resetting m_id_count... m_id_count = " << m_id_count << '\n';
     }
     
-    void Solver::update_id_count(const Clause &clause)
+    void Solver::update_id_count(ClauseRef clause)
     {
         for (int lit : clause) {
             int var( lit < 0 ? -lit : lit );
@@ -228,7 +286,8 @@ namespace leximaxIST {
     }
     
     // add an objective function in the form of a set of soft clauses (so the goal is to minimise clause falsification)
-    void Solver::add_soft_clauses(const std::vector<Clause> &soft_clauses)
+    // the data structures of a new objective function, which is the last one in m_objectives
+    void Solver::new_objective()
     {
         // if (soft_clauses.empty()) {
         //     print_error_msg("In function leximaxIST::Solver::add_soft_clauses, empty objective function");
@@ -239,10 +298,19 @@ namespace leximaxIST {
         m_snet_info.resize(m_num_objectives, std::pair(0,0));
         m_objectives.resize(m_num_objectives);
         m_sorted_vecs.resize(m_num_objectives);
+        m_sorted_values.resize(m_num_objectives);
+        m_sorted_runs.resize(m_num_objectives);
+        m_sorted_prefixes.resize(m_num_objectives);
         // set m_all_relax_vars to a vector of empty lists
         m_all_relax_vars.resize(m_num_objectives);
         // set m_sorted_relax_collection to a vector of empty vectors
         m_sorted_relax_collection.resize(m_num_objectives);
+    }
+
+    // add an objective function in the form of a set of soft clauses (so the goal is to minimise clause falsification)
+    void Solver::add_soft_clauses(const std::vector<Clause> &soft_clauses)
+    {
+        new_objective();
         for (const Clause &soft_clause : soft_clauses)
             update_id_count(soft_clause);
         // convert clause satisfiaction maximisation to minimisation of sum of variables
@@ -254,6 +322,8 @@ namespace leximaxIST {
             int fresh_var (fresh());
             Clause hard_clause (soft_clause); // copy constructor
             m_objectives.at(i).push_back(fresh_var);
+            m_obj_weights.resize(fresh_var + 1, 0);
+            m_obj_weights.at(fresh_var) = 1;
             hard_clause.push_back(fresh_var);
             add_hard_clause(hard_clause);
             // other implication: soft_clause implies neg fresh_var
@@ -269,44 +339,53 @@ namespace leximaxIST {
 
     void Solver::add_soft_clauses(const std::vector<std::pair<uint64_t, Clause>> &soft_clauses)
     {
-        // if (soft_clauses.empty()) {
-        //     print_error_msg("In function leximaxIST::Solver::add_soft_clauses, empty objective function");
-        //     exit(EXIT_FAILURE);
-        // }
-        ++m_num_objectives;
-        // set m_snet_info to a vector of (0,0) pairs
-        m_snet_info.resize(m_num_objectives, std::pair(0,0));
-        m_objectives.resize(m_num_objectives);
-        m_sorted_vecs.resize(m_num_objectives);
-        // set m_all_relax_vars to a vector of empty lists
-        m_all_relax_vars.resize(m_num_objectives);
-        // set m_sorted_relax_collection to a vector of empty vectors
-        m_sorted_relax_collection.resize(m_num_objectives);
+        new_objective();
         for (const auto &soft_clause : soft_clauses)
             update_id_count(soft_clause.second);
         // convert clause satisfiaction maximisation to minimisation of sum of variables
         if (m_verbosity == 2)
             std::cout << "c ---- Input soft clauses conversion to variables ----\n";
-        int i (m_num_objectives - 1); // position in m_objectives of the current objective
-        for (const auto &soft_clause : soft_clauses) {
-            // neg fresh_var implies soft_clause
-            int fresh_var (fresh());
-            Clause hard_clause (soft_clause.second); // copy constructor
-            hard_clause.push_back(fresh_var);
-            add_hard_clause(hard_clause);
-            // Add the blocking literal weight times to "simulate" weighted clause
-            for (size_t j = 0; j < soft_clause.first; ++j)
-                m_objectives.at(i).push_back(fresh_var);
-            // // other implication: soft_clause implies neg fresh_var
-            // for (const int soft_lit : soft_clause) {
-            //     Clause cl {-soft_lit, -fresh_var};
-            //     add_hard_clause(cl);
-            // }
-        }
+        for (const auto &soft_clause : soft_clauses)
+            add_soft_clause(soft_clause.first, soft_clause.second);
         // update status - if optimum found then it becomes sat, otherwise status is not changed
         if (m_status == 'o')
             m_status = 's';
     }
+
+    void Solver::add_soft_clauses(const std::vector<uint64_t> &weights, const ClauseArena &soft_clauses)
+    {
+        new_objective();
+        for (ClauseRef soft_clause : soft_clauses)
+            update_id_count(soft_clause);
+        if (m_verbosity == 2)
+            std::cout << "c ---- Input soft clauses conversion to variables ----\n";
+        size_t j (0);
+        for (ClauseRef soft_clause : soft_clauses)
+            add_soft_clause(weights.at(j++), soft_clause);
+        if (m_status == 'o')
+            m_status = 's';
+    }
+
+    // soft clause of the last objective function, with weight w
+    void Solver::add_soft_clause(uint64_t w, ClauseRef soft_clause)
+    {
+        if (w == 0) // the clause does not contribute to the objective
+            return;
+        // neg fresh_var implies soft_clause
+        int fresh_var (fresh());
+        Clause hard_clause (soft_clause.begin(), soft_clause.end());
+        hard_clause.push_back(fresh_var);
+        add_hard_clause(hard_clause);
+        // the objective variable has the weight of the clause
+        m_objectives.back().push_back(fresh_var);
+        m_obj_weights.resize(fresh_var + 1, 0);
+        m_obj_weights.at(fresh_var) = w;
+        // // other implication: soft_clause implies neg fresh_var
+        // for (const int soft_lit : soft_clause) {
+        //     Clause cl {-soft_lit, -fresh_var};
+        //     add_hard_clause(cl);
+        // }
+    }
         
     void Solver::set_gia_incr(bool v) { m_gia_incr = v; }
     
@@ -334,6 +413,28 @@ namespace leximaxIST {
         }
         m_approx_tout = t;
     }
+    
+    void Solver::set_deadline(double seconds)
+    {
+        if (seconds <= 0) {
+            std::string msg ("Solver::set_deadline - argument '");
+            msg += std::to_string(seconds) + "' is not positive";
+            print_error_msg(msg);
+            exit(EXIT_FAILURE);
+        }
+        m_deadline.set_time(seconds);
+    }
+    
+    void Solver::set_memory_budget(double megabytes)
+    {
+        if (megabytes <= 0) {
+            std::string msg ("Solver::set_memory_budget - argument '");
+            msg += std::to_string(megabytes) + "' is not positive";
+            print_error_msg(msg);
+            exit(EXIT_FAILURE);
+        }
+        m_deadline.set_memory(megabytes);
+    }
         
     void Solver::set_mss_nb_limit(int n) 
     {
@@ -353,4 +454,87 @@ namespace leximaxIST {
     
     void Solver::set_disjoint_cores(bool v) { m_disjoint_cores = v; }
     
+    void Solver::set_half_comparators(bool v) { m_half_comparators = v; }
+    
+    void Solver::set_sorter(const std::string &sorter)
+    {
+        if (sorter != "odd_even" && sorter != "totalizer" && sorter != "pairwise" && sorter != "auto") {
+            std::string msg ("In function leximaxIST::Solver::set_sorter, ");
+            msg += "Invalid sorted vector encoding: '" + sorter + "'";
+            print_error_msg(msg);
+            exit(EXIT_FAILURE);
+        }
+        m_sorter = sorter;
+    }
+    
+    void Solver::set_retention(const std::string &policy)
+    {
+        if (policy != "all" && policy != "inputs" && policy != "none") {
+            std::string msg ("In function leximaxIST::Solver::set_retention, ");
+            msg += "Invalid clause retention policy: '" + policy + "'";
+            print_error_msg(msg);
+            exit(EXIT_FAILURE);
+        }
+        m_retention = policy;
+        m_input_hard.set_retain(policy != "none");
+        m_encoding.set_retain(policy == "all");
+    }
+    
+    // at verbosity 2 all variables are extracted, since print_sorted_true reads the sorted vectors
+    void Solver::configure_sat_solver(IpasirWrap *solver)
+    {
+        solver->set_model_vars(m_verbosity == 2 ? 0 : m_input_nb_vars);
+        solver->set_deadline(&m_deadline);
+    }
+    
+    void Solver::check_deadline()
+    {
+        if (m_deadline.check())
+            throw DeadlineReached();
+    }
+    
+    void Solver::interrupted()
+    {
+        if (!m_leave_tmp_files)
+            remove_tmp_files();
+        reset_file_name();
+        m_status = m_solution.empty() ? '?' : 's';
+        if (m_verbosity >= 1) {
+            if (m_deadline.reason() == _MEMOUT_)
+                std::cout << "c Memory budget exceeded";
+            else
+                std::cout << "c Deadline reached";
+            std::cout << ", stopping with the best solution found\n";
+        }
+    }
+    
+    void Solver::check_retention(bool approx) const
+    {
+        bool needs_inputs (false);
+        bool needs_encoding (false);
+        std::string alg;
+        if (approx) {
+            alg = m_approx;
+            // the non-incremental versions build a new SAT solver from the stored clauses (gia generates the encoding again)
+            needs_inputs = (m_approx == "mss" && !m_mss_incr) || (m_approx == "gia" && !m_gia_incr);
+        }
+        else {
+            alg = m_opt_mode;
+            // the external solvers read all the clauses from a file
+            needs_encoding = m_opt_mode == "external" || m_simplify_last || (m_maxsat_presolve && !m_maxsat_psol_cmd.empty());
+            // core_rebuild regenerates the encoding in a new SAT solver
+            needs_inputs = needs_encoding || m_opt_mode == "ilp" || m_opt_mode == "core_rebuild";
+        }
+        if ((needs_inputs && !m_input_hard.retains()) || (needs_encoding && !m_encoding.retains())) {
+            std::string msg ("The clause retention policy '" + m_retention + "' does not keep the clauses ");
+            msg += "needed by algorithm '" + alg + "'";
+            if (m_maxsat_presolve && !m_maxsat_psol_cmd.empty() && !approx)
+                msg += " with external MaxSAT presolving";
+            else if (m_simplify_last && !approx)
+                msg += " with simplify last";
+            print_error_msg(msg);
+            exit(EXIT_FAILURE);
+        }
+    }
+    
 }/* namespace leximaxIST */
@@ -52,11 +52,12 @@ namespace leximaxIST {
             // send signal to external solver with kill function
             // I think it might be unlikely, but it could happen: child has finished and I do not know it
             // in that case, kill() will fail because child does not exist any more
-            if (kill(m_child_pid, SIGTERM) != 0) {
+            // the external solver is the leader of its process group, which is signalled as a whole
+            if (kill(-m_child_pid, SIGTERM) != 0) {
                 std::string errno_str (strerror(errno));
                 std::string errmsg ("In Solver::terminate: when calling");
                 errmsg += " kill() to send a signal to the external solver (pid ";
-                errmsg += m_child_pid + "): '" + errno_str + "'";
+                errmsg += std::to_string(m_child_pid) + "): '" + errno_str + "'";
                 print_error_msg(errmsg);
                 if (!m_leave_tmp_files)
                     remove_tmp_files(); 
@@ -87,25 +88,8 @@ namespace leximaxIST {
                         return -1;
                     }
                     //m_sat = !(new_sol.empty());
-                    if (m_status == 's') { // otherwise unsat, nothing to do
-                        if (m_solution.empty()) // first iteration
-                            m_solution = std::move(new_sol);
-                        else {
-                            // check which solution is leximax-better
-                            std::vector<int> new_obj_vec (get_objective_vector(new_sol));
-                            std::vector<int> old_obj_vec (get_objective_vector(m_solution));
-                            std::sort(new_obj_vec.begin(), new_obj_vec.end(), descending_order);
-                            std::sort(old_obj_vec.begin(), old_obj_vec.end(), descending_order);
-                            for (size_t j (0); j < new_obj_vec.size(); ++j) {
-                                if (new_obj_vec[j] < old_obj_vec[j]) {
-                                    m_solution = std::move(new_sol);
-                                    break;
-                                }
-                                else if (new_obj_vec[j] > old_obj_vec[j])
-                                    break; // m_solution is better
-                            }
-                        }
-                    }
+                    if (m_status == 's') // otherwise unsat, nothing to do
+                        set_solution(new_sol); // keeps the leximax-better solution
                     if (!m_leave_tmp_files)
                         remove_tmp_files(); 
                     return 0;
@@ -0,0 +1,218 @@
+#include <leximaxIST_Solver.h>
+#include <leximaxIST_printing.h>
+#include <leximaxIST_Writer.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace leximaxIST {
+
+    /* Binary snapshot of the instance given to the solver (the input hard clauses, which include the
+     * definitions of the objective variables, and the objective functions), so that the parsing,
+     * the encoding of the PB constraints and the preprocessing are not repeated on every run.
+     * The file is read with mmap and the clauses are given to the SAT solver directly from the mapping.
+     * Layout (native byte order, every section starts at a multiple of 8 bytes):
+     *  - SnapshotHeader
+     *  - uint64_t clause_offsets[nb_clauses + 1]: clause i is lits[clause_offsets[i] .. clause_offsets[i + 1])
+     *  - int32_t lits[nb_lits]
+     *  - uint64_t obj_offsets[nb_objectives + 1]: objective i is obj_vars[obj_offsets[i] .. obj_offsets[i + 1])
+     *  - int32_t obj_vars[nb_obj_vars]
+     *  - uint64_t obj_weights[nb_obj_vars]: weight of each objective variable
+     */
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order; // snapshot_byte_order in the byte order of the machine that wrote the file
+        uint64_t nb_vars;
+        uint64_t nb_clauses;
+        uint64_t nb_lits;
+        uint64_t nb_objectives;
+        uint64_t nb_obj_vars;
+    };
+
+    static const char snapshot_magic[8] = {'L', 'X', 'I', 'S', 'T', 'S', 'N', 'P'};
+    static const uint32_t snapshot_version = 1;
+    static const uint32_t snapshot_byte_order = 0x01020304;
+
+    static uint64_t padded(uint64_t nb_bytes) { return (nb_bytes + 7) & ~static_cast<uint64_t>(7); }
+
+    static void write_padding(Writer &w, uint64_t nb_bytes)
+    {
+        static const char zeros[8] = {0};
+        w.write(zeros, padded(nb_bytes) - nb_bytes);
+    }
+
+    void Solver::write_snapshot(const std::string &file_name) const
+    {
+        if (!m_input_hard.retains()) {
+            print_error_msg("The clause retention policy '" + m_retention + "' does not keep the clauses needed by the snapshot");
+            exit(EXIT_FAILURE);
+        }
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+        header.version = snapshot_version;
+        header.byte_order = snapshot_byte_order;
+        header.nb_vars = m_id_count;
+        header.nb_clauses = m_input_hard.size();
+        header.nb_lits = m_input_hard.nb_lits();
+        header.nb_objectives = m_objectives.size();
+        for (const std::vector<int> &obj : m_objectives)
+            header.nb_obj_vars += obj.size();
+        Writer w;
+        w.open(file_name, false);
+        w.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t offset (0);
+        w.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        for (ClauseRef cl : m_input_hard) {
+            offset += cl.size();
+            w.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        }
+        for (ClauseRef cl : m_input_hard)
+            w.write(reinterpret_cast<const char*>(cl.begin()), cl.size() * sizeof(int32_t));
+        write_padding(w, header.nb_lits * sizeof(int32_t));
+        offset = 0;
+        w.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        for (const std::vector<int> &obj : m_objectives) {
+            offset += obj.size();
+            w.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        }
+        for (const std::vector<int> &obj : m_objectives)
+            w.write(reinterpret_cast<const char*>(obj.data()), obj.size() * sizeof(int32_t));
+        write_padding(w, header.nb_obj_vars * sizeof(int32_t));
+        for (const std::vector<int> &obj : m_objectives) {
+            for (int var : obj)
+                w.write(reinterpret_cast<const char*>(&m_obj_weights.at(var)), sizeof(uint64_t));
+        }
+        w.close();
+        if (!w.good()) {
+            print_error_msg("Unable to write the snapshot file " + file_name);
+            exit(EXIT_FAILURE);
+        }
+        if (m_verbosity > 0 && m_verbosity <= 2) {
+            std::cout << "c Snapshot written to " << file_name << " (" << w.nb_bytes() << " bytes, ";
+            std::cout << header.nb_clauses << " clauses, " << header.nb_objectives << " objective functions)\n";
+        }
+    }
+
+    static void snapshot_error(const std::string &file_name, const std::string &msg)
+    {
+        print_error_msg("Invalid snapshot file " + file_name + ": " + msg);
+        exit(EXIT_FAILURE);
+    }
+
+    void Solver::read_snapshot(const std::string &file_name)
+    {
+        const auto start (std::chrono::steady_clock::now());
+        if (m_num_objectives != 0 || m_input_hard.size() != 0 || m_id_count != 0) {
+            print_error_msg("In function leximaxIST::Solver::read_snapshot, the solver already has an instance");
+            exit(EXIT_FAILURE);
+        }
+        const int fd (open(file_name.c_str(), O_RDONLY | O_CLOEXEC));
+        if (fd == -1) {
+            print_error_msg("Unable to open the snapshot file " + file_name);
+            exit(EXIT_FAILURE);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            print_error_msg("Unable to get size of the snapshot file " + file_name);
+            exit(EXIT_FAILURE);
+        }
+        const uint64_t size (st.st_size);
+        if (size < sizeof(SnapshotHeader))
+            snapshot_error(file_name, "too small");
+        void *map (mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+        close(fd);
+        if (map == MAP_FAILED) {
+            print_error_msg("Unable to put in memory the snapshot file " + file_name);
+            exit(EXIT_FAILURE);
+        }
+        madvise(map, size, MADV_SEQUENTIAL);
+        const char *data (static_cast<const char*>(map));
+        SnapshotHeader header;
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0)
+            snapshot_error(file_name, "not a leximaxIST snapshot");
+        if (header.byte_order != snapshot_byte_order)
+            snapshot_error(file_name, "written on a machine with another byte order");
+        if (header.version != snapshot_version)
+            snapshot_error(file_name, "version " + std::to_string(header.version) + " (expected " + std::to_string(snapshot_version) + ")");
+        // each count is bounded by the size, so the sums below do not overflow
+        if (header.nb_vars > INT32_MAX || header.nb_clauses > size || header.nb_lits > size
+            || header.nb_objectives > size || header.nb_obj_vars > size)
+            snapshot_error(file_name, "corrupted header");
+        const uint64_t clause_offsets_pos (sizeof(SnapshotHeader));
+        const uint64_t lits_pos (clause_offsets_pos + (header.nb_clauses + 1) * sizeof(uint64_t));
+        const uint64_t obj_offsets_pos (lits_pos + padded(header.nb_lits * sizeof(int32_t)));
+        const uint64_t obj_vars_pos (obj_offsets_pos + (header.nb_objectives + 1) * sizeof(uint64_t));
+        const uint64_t obj_weights_pos (obj_vars_pos + padded(header.nb_obj_vars * sizeof(int32_t)));
+        if (obj_weights_pos + header.nb_obj_vars * sizeof(uint64_t) != size)
+            snapshot_error(file_name, "wrong size");
+        const uint64_t *clause_offsets (reinterpret_cast<const uint64_t*>(data + clause_offsets_pos));
+        const int *lits (reinterpret_cast<const int*>(data + lits_pos));
+        const uint64_t *obj_offsets (reinterpret_cast<const uint64_t*>(data + obj_offsets_pos));
+        const int *obj_vars (reinterpret_cast<const int*>(data + obj_vars_pos));
+        const uint64_t *obj_weights (reinterpret_cast<const uint64_t*>(data + obj_weights_pos));
+        const int nb_vars (header.nb_vars);
+        auto check_offsets = [&](const uint64_t *offsets, uint64_t n, uint64_t nb_elements) {
+            if (offsets[0] != 0 || offsets[n] != nb_elements)
+                snapshot_error(file_name, "corrupted offsets");
+            for (uint64_t i (0); i < n; ++i) {
+                if (offsets[i] > offsets[i + 1])
+                    snapshot_error(file_name, "corrupted offsets");
+            }
+        };
+        check_offsets(clause_offsets, header.nb_clauses, header.nb_lits);
+        check_offsets(obj_offsets, header.nb_objectives, header.nb_obj_vars);
+        for (uint64_t j (0); j < header.nb_lits; ++j) {
+            if (lits[j] == 0 || lits[j] < -nb_vars || lits[j] > nb_vars)
+                snapshot_error(file_name, "literal out of range");
+        }
+        for (uint64_t j (0); j < header.nb_obj_vars; ++j) {
+            if (obj_vars[j] <= 0 || obj_vars[j] > nb_vars)
+                snapshot_error(file_name, "objective variable out of range");
+        }
+        // as in add_soft_clause and reduce_weights: the weights are positive and the sum of each objective is an int
+        for (uint64_t i (0); i < header.nb_objectives; ++i) {
+            uint64_t sum (0);
+            for (uint64_t j (obj_offsets[i]); j < obj_offsets[i + 1]; ++j) {
+                if (obj_weights[j] == 0)
+                    snapshot_error(file_name, "objective weight is zero");
+                // a weight above INT_MAX exceeds it on its own, and the sum can not overflow before exceeding it
+                sum += std::min<uint64_t>(obj_weights[j], static_cast<uint64_t>(INT_MAX) + 1);
+                if (sum > INT_MAX)
+                    snapshot_error(file_name, "the sum of the weights of objective " + std::to_string(i + 1) + " exceeds INT_MAX");
+            }
+        }
+        // the clauses go from the mapping to the SAT solver (and to m_input_hard if it retains them)
+        m_input_hard.reserve(m_input_hard.retains() ? header.nb_clauses : 0, m_input_hard.retains() ? header.nb_lits : 0);
+        for (uint64_t i (0); i < header.nb_clauses; ++i)
+            add_hard_clause(ClauseRef(lits + clause_offsets[i], lits + clause_offsets[i + 1]));
+        m_obj_weights.resize(nb_vars + 1, 0);
+        for (uint64_t i (0); i < header.nb_objectives; ++i) {
+            new_objective();
+            m_objectives.back().assign(obj_vars + obj_offsets[i], obj_vars + obj_offsets[i + 1]);
+            for (uint64_t j (obj_offsets[i]); j < obj_offsets[i + 1]; ++j)
+                m_obj_weights.at(obj_vars[j]) = obj_weights[j];
+        }
+        if (m_id_count < nb_vars)
+            m_id_count = nb_vars;
+        munmap(map, size);
+        if (m_verbosity > 0 && m_verbosity <= 2) {
+            const double t (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            std::cout << "c Snapshot read in " << t << " s (" << header.nb_clauses << " clauses, ";
+            std::cout << header.nb_objectives << " objective functions)\n";
+        }
+    }
+
+}/* namespace leximaxIST */
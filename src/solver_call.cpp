@@ -1,10 +1,16 @@
 #include <leximaxIST_Solver.h>
+#include <leximaxIST_ILPBackend.h>
 #include <leximaxIST_rusage.h>
 #include <leximaxIST_parsing_utils.h>
 #include <leximaxIST_printing.h>
 #include <IpasirWrap.h>
 #include <zlib.h>
 #include <sys/wait.h>
+#include <sys/mman.h> // memfd_create()
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h> // posix_spawnp()
+#include <signal.h>
 #include <sys/resource.h> // for getrusage()
 #include <sys/types.h> // getpid(), I think
 #include <unistd.h>
@@ -21,56 +27,113 @@
 #include <cmath> // std::abs()
 #include <sstream>
 #include <cctype>
+#include <chrono>
+#include <thread> // std::this_thread::sleep_for()
 
 namespace leximaxIST {
 
     bool descending_order (int i, int j);
+    
+    int value_pos(const std::vector<int> &values, int value);
 
-    void Solver::call_ilp_solver(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i)
+    /* ith iteration of the ilp algorithm with an external ILP solver
+     * the incumbent solution is given to the solver as a MIP start (.mst file)
+     */
+    void Solver::call_ilp_solver(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars,
+                                 const std::vector<std::vector<int>> &relax_vars, int i)
     {
         // temporary file names
         const std::string base ("/tmp/" + std::to_string(getpid()) + "_" + std::to_string(i));
-        const std::string input_file_name (base + ".lp");
+        std::string input_file_name (base + ".lp");
+        std::string start_file_name (base + ".mst");
         const std::string sol_file_name (base + ".sol");
-        m_tmp_files.push_back(input_file_name);
-        m_tmp_files.push_back(sol_file_name);
         // write lp file for ilp solver
-        write_lp_file(constraints, max_vars, i);
+        double initial_time (read_cpu_time());
+        Writer os;
+        open_instance_file(os, input_file_name);
+        write_lp_file(os, constraints, max_vars, i);
+        end_instance_file(os, input_file_name, initial_time);
+        // write the MIP start
+        const bool has_start (!m_solution.empty());
+        if (has_start) {
+            initial_time = read_cpu_time();
+            open_instance_file(os, start_file_name);
+            write_mip_start(os, ilp_start(max_vars, relax_vars));
+            end_instance_file(os, start_file_name, initial_time);
+        }
+        std::vector<int> model;
         if (m_ilp_solver == "gurobi") {
-            // call gurobi
+            // call gurobi, which writes the solution to the .sol file
+            m_tmp_files.push_back(sol_file_name);
             std::string command ("gurobi_cl");
             command += " Threads=1 ResultFile=" + sol_file_name;
-            //command += " Threads=1 ResultFile=/tmp/foo.sol";
+            if (has_start)
+                command += " InputFile=" + start_file_name;
             command += " LogFile= LogToConsole=0 "; // disable logging
             command += input_file_name;
-            // call solver
-            system(command.c_str());
+            call_ext_solver(command, input_file_name, nullptr);
+            read_solver_output(model, sol_file_name, false);
         }
         else if (m_ilp_solver == "cplex") {
             std::string command ("cplex -c");
             command += " \"set logfile *\""; // disable log file cplex.log
             command += " \"set threads 1\""; // set threads to 1
             command += " \"read " + input_file_name + "\""; // read input
+            if (has_start)
+                command += " \"read " + start_file_name + "\""; // read MIP start
             command += " \"optimize\" \"display solution variables -\""; // solve and print solution to stdout
-            command += " > " + sol_file_name; // redirect stdout to the solution file
-            // call solver
-            system(command.c_str());
+            std::vector<char> output;
+            call_ext_solver(command, input_file_name, &output);
+            read_solver_output(model, std::move(output), false);
         }
         else {
             print_error_msg("Invalid ILP solver '" + m_ilp_solver + "'");
             exit(EXIT_FAILURE);
         }
-        // read gurobi .sol file and update m_solution
-        // read output of solver
-        std::vector<int> model;
-        read_solver_output(model, sol_file_name);
         // if ext solver is killed before it finds a sol, the problem might not be unsat
         set_solution(model); // update solution and print obj vector
         if (!m_leave_tmp_files)
             remove_tmp_files();
+        check_deadline(); // the solver may have been stopped at the deadline
     }
     
-    void Solver::read_gurobi_output(std::vector<int> &model, bool &sat, StreamBuffer &r)
+    /* ith iteration of the ilp algorithm with an ILP solver linked into leximaxIST
+     * the backend already has the first nb_sent constraints, the others are added to it
+     * the incumbent solution is given to the solver as a MIP start
+     */
+    void Solver::call_ilp_backend(ILPBackend &backend, const std::vector<ILPConstraint> &constraints, size_t &nb_sent,
+                                  const std::vector<int> &max_vars, const std::vector<std::vector<int>> &relax_vars, int i)
+    {
+        check_deadline();
+        while (backend.nb_vars() < m_id_count) {
+            const int var (backend.nb_vars() + 1);
+            backend.add_var(std::find(max_vars.begin(), max_vars.end(), var) == max_vars.end());
+        }
+        for (; nb_sent < constraints.size(); ++nb_sent)
+            backend.add_constraint(constraints[nb_sent]);
+        backend.minimise(max_vars.at(i));
+        backend.set_start(ilp_start(max_vars, relax_vars));
+        double initial_time;
+        if (m_verbosity >= 1) {
+            std::cout << "c Calling ILP solver...\n";
+            initial_time = read_cpu_time();
+        }
+        std::vector<int> values;
+        // a positive time limit, 0 means no limit
+        const double time_limit (m_deadline.has_time() ? std::max(m_deadline.remaining(), 0.001) : 0);
+        const int rv (backend.solve(time_limit, values));
+        if (m_verbosity >= 1)
+            print_time(read_cpu_time() - initial_time, "c ILP call CPU time: ");
+        if (rv == _OPTIMUM_ || rv == _SATISFIABLE_) {
+            std::vector<int> model (m_input_nb_vars + 1, 0);
+            for (int v (1); v <= m_input_nb_vars; ++v)
+                model[v] = values.at(v) > 0 ? v : -v;
+            set_solution(model);
+        }
+        check_deadline(); // the solver may have been stopped at the deadline
+    }
+    
+    void Solver::read_gurobi_output(std::vector<int> &model, bool &sat, FileBuffer &r)
     {
         while (*r != EOF) {
             if (*r != 'x')
@@ -105,27 +168,27 @@ namespace leximaxIST {
         }
     }
 /*
-    int Solver::read_glpk_output(std::vector<int> &model, bool &sat, StreamBuffer &r)
+    int Solver::read_glpk_output(std::vector<int> &model, bool &sat, FileBuffer &r)
     {
         // TODO
     }
 
-    int Solver::read_lpsolve_output(std::vector<int> &model, bool &sat, StreamBuffer &r)
+    int Solver::read_lpsolve_output(std::vector<int> &model, bool &sat, FileBuffer &r)
     {
         // TODO
     }
 
-    void Solver::read_scip_output(std::vector<int> &model, bool &sat, StreamBuffer &r)
+    void Solver::read_scip_output(std::vector<int> &model, bool &sat, FileBuffer &r)
     {
         // TODO
     }
 
-    void Solver::read_cbc_output(std::vector<int> &model, bool &sat, StreamBuffer &r)
+    void Solver::read_cbc_output(std::vector<int> &model, bool &sat, FileBuffer &r)
     {
         // TODO
     }
 */
-    void Solver::read_cplex_output(std::vector<int> &model, bool &sat, StreamBuffer &r)
+    void Solver::read_cplex_output(std::vector<int> &model, bool &sat, FileBuffer &r)
     {
         // set all variables to false, because we only get the variables that are true
         for (size_t v (1); v < m_input_nb_vars + 1; ++v)
@@ -163,7 +226,7 @@ namespace leximaxIST {
     }
 
     // if model.empty() in the end then unsat, else sat
-    void Solver::read_sat_output(std::vector<int> &model, bool &sat, StreamBuffer &r)
+    void Solver::read_sat_output(std::vector<int> &model, bool &sat, FileBuffer &r)
     {
         while (*r != EOF) {
             if (*r != 'v') {// ignore all the other lines
@@ -178,8 +241,16 @@ namespace leximaxIST {
                     if ((*r == 'x')) ++r;
                     if (*r < '0' || *r > '9') break;
                     const int l = parseInt(r);
-                    assert(model.size()>(size_t)l);
-                    model[l] = (sign ? l : -l);
+                    if (l > m_id_count) {
+                        print_error_msg("The solver output assigns variable " + std::to_string(l) + " but the instance only has "
+                                        + std::to_string(m_id_count) + " variables");
+                        if (!m_leave_tmp_files)
+                            remove_tmp_files();
+                        exit(EXIT_FAILURE);
+                    }
+                    // the external solver also assigns the variables of the encoding that we may not need
+                    if ((size_t)l < model.size())
+                        model[l] = (sign ? l : -l);
                 }
                 assert (*r=='\n');
                 ++r; // skip '\n'
@@ -187,49 +258,67 @@ namespace leximaxIST {
         }
     }
     
-    /* opens the file where the solution of the external solver is stored and
-     * writes the solution in the variable 'model'
-     */
-    void Solver::read_solver_output(std::vector<int> &model, const std::string &filename)
+    // reads the solution that the external solver wrote to a file (see read_solver_output below)
+    void Solver::read_solver_output(std::vector<int> &model, const std::string &filename, bool sat_output)
     {
-        gzFile of = gzopen(filename.c_str(), "rb");
-        if (of == Z_NULL) {
+        const int fd (open(filename.c_str(), O_RDONLY));
+        if (fd == -1) {
             const std::string errmsg (strerror(errno));
             print_error_msg("Can't open file '" + filename + "' for reading - " + errmsg);
             if (!m_leave_tmp_files)
                 remove_tmp_files();
             exit(EXIT_FAILURE);
         }
-        StreamBuffer r(of);
+        FileBuffer r(fd);
+        read_solver_output(model, r, sat_output);
+    }
+
+    // reads the solution that the external solver printed to its standard output
+    void Solver::read_solver_output(std::vector<int> &model, std::vector<char> &&output, bool sat_output)
+    {
+        FileBuffer r(std::move(output));
+        read_solver_output(model, r, sat_output);
+    }
+
+    /* writes the solution of the external solver in the variable 'model'
+     * if model is empty, it is resized to the number of input variables
+     * sat_output: whether r has the output of a (Max)SAT/PBO solver or of the ILP solver
+     */
+    void Solver::read_solver_output(std::vector<int> &model, FileBuffer &r, bool sat_output)
+    {
+        double initial_time;
+        if (m_verbosity >= 1 && m_verbosity <= 2)
+            initial_time = read_cpu_time();
         bool sat = false;
-        model.resize(static_cast<size_t>(m_input_nb_vars + 1), 0);
-        if (m_ilp_solver == "cplex")
+        if (model.empty())
+            model.resize(static_cast<size_t>(m_input_nb_vars + 1), 0);
+        if (sat_output)
+            read_sat_output(model, sat, r);
+        else if (m_ilp_solver == "cplex")
             read_cplex_output(model, sat, r);
         else if (m_ilp_solver == "gurobi")
             read_gurobi_output(model, sat, r);
+        /*else if (m_ilp_solver == "glpk")
+            read_glpk_output(model, sat, r);
+        else if (m_ilp_solver == "scip")
+            read_scip_output(model, sat, r);
+        else if (m_ilp_solver == "cbc")
+            read_cbc_output(model, sat, r);
+        else if (m_ilp_solver == "lpsolve")
+            read_lpsolve_output(model, sat, r);*/
         else {
             print_error_msg("Invalid ILP solver '" + m_ilp_solver + "'");
             exit(EXIT_FAILURE);
         }
-        /*if (m_formalism == "wcnf" || m_formalism == "opb")
-            read_sat_output(model, sat, r);
-        else if (m_formalism == "lp") {
-            if (m_ilp_solver == "cplex")
-                read_cplex_output(model, sat, r);
-            else if (m_ilp_solver == "gurobi")
-                read_gurobi_output(model, sat, r);*/
-            /*else if (m_ilp_solver == "glpk")
-                read_glpk_output(model, sat, r);
-            else if (m_ilp_solver == "scip")
-                read_scip_output(model, sat, r);
-            else if (m_ilp_solver == "cbc")
-                read_cbc_output(model, sat, r);
-            else if (m_ilp_solver == "lpsolve")
-                read_lpsolve_output(model, sat, r);*/
-        //}
         if (!sat)
             model.clear();
-        gzclose(of);
+        if (m_verbosity >= 1 && m_verbosity <= 2) {
+            const double read_time (read_cpu_time() - initial_time);
+            std::cout << "c Solver output: " << r.nb_bytes() << " bytes parsed in " << read_time << " s";
+            if (read_time > 0)
+                std::cout << " (" << r.nb_bytes() / (1048576.0 * read_time) << " MB/s)";
+            std::cout << '\n';
+        }
     }
 
     void Solver::split_command(const std::string &command, std::vector<std::string> &command_split)
@@ -263,164 +352,274 @@ namespace leximaxIST {
                     found++;
                 found = command.find_first_of(" \"\'", found);
             }
-            // I just found the end of the piece of text
-            command_split.push_back(command.substr(pos, found - pos)/*.c_str()*/);
+            // I just found the end of the piece of text, the quotation marks are removed as in a shell
+            std::string arg (command.substr(pos, found - pos));
+            size_t quote_pos (arg.find_first_of("\"\'"));
+            while (quote_pos != std::string::npos) {
+                const size_t closing (arg.find(arg[quote_pos], quote_pos + 1));
+                arg.erase(closing, 1);
+                arg.erase(quote_pos, 1);
+                quote_pos = arg.find_first_of("\"\'", closing - 1);
+            }
+            command_split.push_back(arg);
             pos = found;
         }
         if (command_split.empty()) {
             print_error_msg("Empty external solver command");
             exit(EXIT_FAILURE);
         }
+        /* the command is not run by a shell, so pipes, redirections, variables, etc. would be passed as arguments
+         * (a '$' that does not start an expansion is kept, e.g. "solution $" prints the solution of cbc to stdout)
+         */
+        char quote (0);
+        for (size_t i (0); i < command.length(); ++i) {
+            const char c (command[i]);
+            const char next (i + 1 < command.length() ? command[i + 1] : ' ');
+            if (quote != 0) {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (c == '"' || c == '\'')
+                quote = c;
+            else if (c == '|' || c == '&' || c == ';' || c == '<' || c == '>' || c == '`' || c == '\\' || c == '\n'
+                     || (c == '$' && (std::isalpha(static_cast<unsigned char>(next)) || next == '_' || next == '{' || next == '('))) {
+                std::string msg ("The external solver command is run without a shell, so it can not use '");
+                msg += c;
+                msg += "' (quote it to pass it to the solver, or use a script)\n" + command + "\n";
+                msg += std::string(i, ' ') + "^";
+                print_error_msg(msg);
+                exit(EXIT_FAILURE);
+            }
+        }
     }
 
-    // TODO: move the part of setting the command to the caller
-    void Solver::call_ext_solver(const std::string &command)
+    /* Runs the external solver command in a child process (posix_spawnp, without a shell).
+     * The standard output of the solver is read through a pipe while the solver runs and
+     * appended to output (it is discarded if output is null). The standard error is discarded.
+     * If m_leave_tmp_files, the standard error and output are kept in file_name.err and file_name.sol.
+     * The solver runs in its own process group, whose id is m_child_pid until it finishes,
+     * so that terminate() can stop it and its children.
+     * At the deadline the solver gets SIGTERM, so that it can print its best solution,
+     * and SIGKILL if it is still running m_timeout milliseconds later.
+     */
+    void Solver::call_ext_solver(const std::string &command, const std::string &file_name, std::vector<char> *output)
     {
+        check_deadline();
         if (m_verbosity >= 1)
             std::cout << "c Calling external solver..." << '\n';
-       /* pid_t pid (fork()); // TODO: maybe change this part to m_child_pid
-        if (pid == -1) {
-            std::string errmsg (strerror(errno));
-            print_error_msg("Can't fork process: " + errmsg);
-            return -1;
+        std::vector<std::string> command_split;
+        split_command(command, command_split);
+        std::vector<char*> args;
+        for (std::string &arg : command_split)
+            args.push_back(&arg[0]);
+        args.push_back(nullptr);
+        int out_pipe[2];
+        if (pipe2(out_pipe, O_CLOEXEC) != 0) {
+            const std::string errmsg (strerror(errno));
+            print_error_msg("Can't create pipe for the external solver - " + errmsg);
+            if (!m_leave_tmp_files)
+                remove_tmp_files();
+            exit(EXIT_FAILURE);
         }
-        if (pid == 0) { // child process -> external solver
-            // open output_filename and error_filename
-            FILE *my_out_stream (nullptr);
-            if (m_formalism != "lp" || m_ilp_solver != "gurobi") {
-                my_out_stream = fopen(output_filename.c_str(), "w");
-                if (my_out_stream == nullptr) {
-                    print_error_msg("Can't open '" + output_filename + "' for writing");
-                    exit(-1);
-                }
-                
-            }
-            FILE *my_err_stream (fopen(error_filename.c_str(), "w"));
-            if (my_err_stream == nullptr) {
-                print_error_msg("Can't open '" + error_filename + "' for writing");
-                exit(-1);
-            }
-            // redirect std output to output_filename and std error to error_filename (if not gurobi)
-            if (m_formalism != "lp" || m_ilp_solver != "gurobi") {
-                if (dup2(fileno(my_out_stream), 1) == -1) {
-                    print_error_msg("Can't redirect Standard Output of external solver");
-                    exit(-1);
-                }
-            }
-            // copy screen (in file descriptor 2) to a new file descriptor
-            // why? to redirect std error back to screen later on
-            int newfd (dup(2));
-            if (newfd == -1) {
-                print_error_msg("Can't redirect Standard Error of external solver");
-                exit(-1);
+        const std::string err_file_name (m_leave_tmp_files ? file_name + ".err" : "/dev/null");
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, out_pipe[1], 1);
+        posix_spawn_file_actions_addopen(&actions, 2, err_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP); // process group 0 is a new group
+        pid_t pid;
+        const int rv (posix_spawnp(&pid, args.at(0), &actions, &attr, args.data(), environ));
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attr);
+        close(out_pipe[1]);
+        if (rv != 0) {
+            close(out_pipe[0]);
+            const std::string errmsg (strerror(rv));
+            print_error_msg("Can't run external solver '" + command_split.at(0) + "' - " + errmsg);
+            if (!m_leave_tmp_files)
+                remove_tmp_files();
+            exit(EXIT_FAILURE);
+        }
+        m_child_pid = pid;
+        std::vector<char> discarded;
+        std::vector<char> &out (output != nullptr ? *output : discarded);
+        const size_t initial_size (out.size());
+        int stage (0); // 0 - running, 1 - SIGTERM sent, 2 - SIGKILL sent
+        std::chrono::steady_clock::time_point kill_time;
+        // milliseconds until the next stage (-1 if there is no limit)
+        auto time_left = [&]() {
+            if (stage == 0 && m_deadline.has_time())
+                return static_cast<int>(std::min(std::ceil(m_deadline.remaining() * 1000), 1e9));
+            if (stage == 1) {
+                const auto left (std::chrono::duration_cast<std::chrono::milliseconds>(kill_time - std::chrono::steady_clock::now()));
+                return std::max(static_cast<int>(left.count()), 0);
             }
-            if (dup2(fileno(my_err_stream), 2) == -1) {
-                print_error_msg("Can't redirect Standard Error of external solver");
-                exit(-1);
+            return -1;
+        };
+        auto next_stage = [&]() {
+            if (stage == 0) {
+                if (m_verbosity >= 1)
+                    std::cout << "c Stopping external solver at the deadline" << '\n';
+                kill(-pid, SIGTERM);
+                kill_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(static_cast<long>(m_timeout));
             }
-            // convert command to vector of strings (split by whitespace)
-            std::vector<std::string> command_split;
-            if (split_command(command, command_split) == -1)
-                exit(-1);
-            /*command_split.clear();
-            command_split.push_back("grep");
-            command_split.push_back("'packup'");
-            command_split.push_back("/home/miguelcabral/thesis/old_packup/Makefile");*/
-            // convert to array for execv function
-            /*std::vector<char*> args(command_split.size() + 1, new char[30]{}); // memory leak - no problems because child process dies afterward?
-            //char **args (new char*[command_split.size()]);
-            for (size_t i (0); i < command_split.size(); ++i) {
-                size_t length (command_split[i].copy(args[i], command_split[i].size()));
-                args[i][length] = '\0';
-                std::cerr << "i="<< i << std::endl;
-                std::cerr << args[i] << std::endl;
+            else
+                kill(-pid, SIGKILL);
+            ++stage;
+        };
+        // read until the solver closes its output, stopping the solver at the deadline
+        while (true) {
+            struct pollfd pfd {out_pipe[0], POLLIN, 0};
+            const int nb_ready (poll(&pfd, 1, time_left()));
+            if (nb_ready == 0) { // time is up
+                next_stage();
+                continue;
             }
-            args[command_split.size()] = nullptr;*/
-            /*std::cout << "command_split: ";
-            for (std::string &s : command_split)
-                std::cout << s << ", ";
-            std::cout << std::endl;*/
-            // call solver
-            //std::string ola ("/bin/grep");
-            /*if (execv(args[0]/*ola.c_str()*//*, args.data()) == -1) {
-                std::string errmsg (strerror(errno));
-                // redirect std error back to screen
-                dup2(newfd, 2); // if this fails does not matter, terminate child process anyway
-                print_error_msg("Something went wrong when calling the external solver: " + errmsg);
-                exit(-1);
+            if (nb_ready < 0) {
+                if (errno == EINTR) // e.g. terminate() was called by a signal handler
+                    continue;
+                const std::string errmsg (strerror(errno));
+                print_error_msg("Error reading the output of the external solver - " + errmsg);
+                kill(-pid, SIGKILL);
+                exit(EXIT_FAILURE);
             }
+            const size_t size (out.size());
+            out.resize(size + ext_read_size);
+            const ssize_t nb_read (read(out_pipe[0], out.data() + size, ext_read_size));
+            out.resize(size + (nb_read > 0 ? nb_read : 0));
+            if (output == nullptr)
+                out.clear();
+            if (nb_read == 0 || (nb_read < 0 && errno != EINTR && errno != EAGAIN))
+                break; // the solver closed its output
         }
-        // parent process - store child pid for signal handling
-        m_child_pid = pid;
-        // waitpid for child process
+        close(out_pipe[0]);
+        // the solver may close its output and keep running, so the wait is also stopped at the deadline
         int pid_status;
-        if (waitpid(pid, &pid_status, 0) == -1) {
-            std::string errmsg (strerror(errno));
-            print_error_msg("Error waiting for child process: " + errmsg);
-            return -1;
+        while (true) {
+            const pid_t waited (waitpid(pid, &pid_status, WNOHANG));
+            // fails with ECHILD if terminate() has already waited for the solver
+            if (waited == pid || (waited == -1 && errno != EINTR))
+                break;
+            const int wait_ms (time_left());
+            if (wait_ms == 0)
+                next_stage();
+            else // after SIGKILL there is no limit, the solver can not ignore it
+                std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms == -1 ? 10 : std::min(wait_ms, 10)));
         }
-        /*if (WEXITSTATUS(pid_status)) {
-            std::string errmsg (strerror(errno));
-            print_error_msg("The external solver finished with non-zero error status: " + errmsg);
-            return -1;
-        }*/
-        system(command.c_str());
         // set to zero, i.e. no external solver is currently running
         m_child_pid = 0;
+        if (m_leave_tmp_files && output != nullptr) {
+            std::ofstream sol (file_name + ".sol", std::ios::binary);
+            sol.write(out.data() + initial_size, out.size() - initial_size);
+        }
     }
 
-    void Solver::write_cnf_file(int i)
+    /* Opens out on a new input file of an external solver, named file_name, which is a temporary file.
+     * The instance is kept in memory (memfd_create) and file_name is a symbolic link to it,
+     * so the solver can still tell the format from the extension and no data is written to disk.
+     * If m_leave_tmp_files (or memory files are not supported), file_name is a regular file.
+     * If m_gzip_input, the file is compressed and ".gz" is appended to file_name.
+     */
+    void Solver::open_instance_file(Writer &out, std::string &file_name)
     {
-        m_file_name += "_" + std::to_string(i) + ".cnf";
-        std::ofstream out (m_file_name);
-        if (!out) {
-            print_error_msg("Can't open " + m_file_name + " for writing");
+        if (m_gzip_input)
+            file_name += ".gz";
+        m_tmp_files.push_back(file_name);
+        std::string path (file_name);
+        const int mem_fd (m_leave_tmp_files ? -1 : memfd_create("leximaxIST", MFD_CLOEXEC));
+        if (mem_fd != -1) {
+            const std::string fd (std::to_string(mem_fd));
+            // the solver reads the memory file through the file descriptor of this process
+            const std::string target ("/proc/" + std::to_string(getpid()) + "/fd/" + fd);
+            remove(file_name.c_str());
+            if (symlink(target.c_str(), file_name.c_str()) == 0) {
+                path = "/proc/self/fd/" + fd;
+                m_instance_fds.push_back(mem_fd);
+            }
+            else
+                close(mem_fd);
+        }
+        out.open(path, m_gzip_input);
+        if (!out.good()) {
+            print_error_msg("Can't open " + file_name + " for writing");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // closes the input file of the external solver, initial_time is the CPU time when the writing started
+    void Solver::end_instance_file(Writer &out, const std::string &file_name, double initial_time)
+    {
+        out.close();
+        if (!out.good()) {
+            const std::string errmsg (strerror(errno));
+            print_error_msg("Can't write " + file_name + " - " + errmsg);
+            if (!m_leave_tmp_files)
+                remove_tmp_files();
             exit(EXIT_FAILURE);
         }
+        if (m_verbosity >= 1 && m_verbosity <= 2) {
+            const double write_time (read_cpu_time() - initial_time);
+            std::cout << "c Solver input: " << out.nb_bytes() << " bytes written in " << write_time << " s";
+            if (write_time > 0)
+                std::cout << " (" << out.nb_bytes() / (1048576.0 * write_time) << " MB/s)";
+            std::cout << '\n';
+        }
+    }
+
+    void Solver::close_instance_file()
+    {
+        for (int fd : m_instance_fds)
+            close(fd);
+        m_instance_fds.clear();
+    }
+
+    void Solver::write_cnf_file(int i)
+    {
+        const double initial_time (read_cpu_time());
+        m_file_name += "_" + std::to_string(i) + ".cnf";
+        Writer out;
+        open_instance_file(out, m_file_name);
         // print header
-        out << "p cnf " << m_id_count << " " << m_input_hard.size() << '\n';
+        out << "p cnf " << m_id_count << ' ' << m_input_hard.size() << '\n';
         print_hard_clauses(out);
-        out.close();
+        end_instance_file(out, m_file_name, initial_time);
     }
     
     void Solver::write_wcnf_file(int i)
     {
+        const double initial_time (read_cpu_time());
         m_file_name += "_" + std::to_string(i) + ".wcnf";
-        std::ofstream out (m_file_name);
-        if (!out) {
-            print_error_msg("Can't open " + m_file_name + " for writing");
-            exit(EXIT_FAILURE);
-        }
+        Writer out;
+        open_instance_file(out, m_file_name);
         // prepare input for the solver
-        size_t weight = m_soft_clauses.size() + 1;
-        out << "p wcnf " << m_id_count << " " << m_input_hard.size() + m_encoding.size() << " " << weight << '\n';
+        out << "p wcnf " << m_id_count << ' ' << m_input_hard.size() + m_encoding.size() << ' ' << hard_weight() << '\n';
         print_hard_clauses(out);
         print_soft_clauses(out);
-        out.close();
+        end_instance_file(out, m_file_name, initial_time);
     }
 
     void Solver::write_opb_file(int i)
     {
+        const double initial_time (read_cpu_time());
         m_file_name += "_" + std::to_string(i) + ".opb";
-        std::ofstream out (m_file_name);
-        if (!out.is_open()) {
-            print_error_msg("Can't open " + m_file_name + " for writing");
-            exit(EXIT_FAILURE);
-        }
+        Writer out;
+        open_instance_file(out, m_file_name);
         // prepare input for the solver
         out << "* #variable= " << m_id_count;
         out << " #constraint= " << m_input_hard.size() + m_encoding.size() << '\n';
         if (m_soft_clauses.size() > 0) {// print minimization function
             out << "min:";
-            for (int neg_var : m_soft_clauses)
-                out << " " << "+1" << m_multiplication_string << "x" << -neg_var;
+            for (size_t j (0); j < m_soft_clauses.size(); ++j)
+                out << " +" << m_soft_weights.at(j) << m_multiplication_string << 'x' << -m_soft_clauses[j];
             out << ";\n";
         }
-        for (const Clause &cl : m_input_hard)
+        for (const ClauseRef cl : m_input_hard)
             print_pb_constraint(cl, out);
-        for (const Clause &cl : m_encoding)
+        for (const ClauseRef cl : m_encoding)
             print_pb_constraint(cl, out);
-        out.close();
+        end_instance_file(out, m_file_name, initial_time);
     }
 
     void Solver::write_solver_input(int i)
@@ -456,44 +655,47 @@ namespace leximaxIST {
             if (m_ilp_solver == "scip")
                 command += "-f " + m_file_name;
             if (m_ilp_solver == "gurobi") {
+                m_tmp_files.push_back(m_file_name + ".sol");
                 command = "gurobi_cl";
                 command += " Threads=1 ResultFile=" + m_file_name + ".sol";
-                command += " LogFile=\"\" LogToConsole=0 "; // disable logging
+                command += " LogFile= LogToConsole=0 "; // disable logging
                 command += m_file_name;
             }
         }
         else
             command += m_file_name;
-        if (m_formalism != "lp" || m_ilp_solver != "gurobi")
-            command += " > " + m_file_name + ".sol";
-        command += " 2> " + m_file_name + ".err";
+        // gurobi writes the solution to a file, the other solvers print it
+        const bool result_file (m_formalism == "lp" && m_ilp_solver == "gurobi");
+        std::vector<char> output;
         double initial_time, final_time;
         if (m_verbosity >= 1 && m_verbosity <= 2)
             initial_time = read_cpu_time();
-        call_ext_solver(command);
+        call_ext_solver(command, m_file_name, result_file ? nullptr : &output);
         if (m_verbosity >= 1 && m_verbosity <= 2) {
             final_time = read_cpu_time();
             print_time(final_time - initial_time, "c Minimisation CPU time: ");
         }
         // read output of solver
         std::vector<int> model;
-        read_solver_output(model, m_file_name + ".sol");
+        if (result_file)
+            read_solver_output(model, m_file_name + ".sol", false);
+        else
+            read_solver_output(model, std::move(output), m_formalism != "lp");
         // if ext solver is killed before it finds a sol, the problem might not be unsat
         set_solution(model); // update solution and print obj vector
         if (!m_leave_tmp_files)
             remove_tmp_files();
         // set m_file_name back to pid
         reset_file_name();
+        check_deadline(); // the solver may have been stopped at the deadline
     }
 
     void Solver::write_lp_file(int i)
     {
+        const double initial_time (read_cpu_time());
         m_file_name += "_" + std::to_string(i) + ".lp";
-        std::ofstream output(m_file_name); 
-        if (!output) {
-            print_error_msg("Could not open " + m_file_name + " for writing");
-            exit(EXIT_FAILURE);
-        }
+        Writer output;
+        open_instance_file(output, m_file_name);
         // prepare input for the solver
         output << "Minimize\n";
         output << " obj: ";
@@ -501,10 +703,11 @@ namespace leximaxIST {
             size_t nb_vars_in_line (0);
             for (size_t j (0); j < m_soft_clauses.size(); ++j) {
                 int soft_var (-m_soft_clauses[j]);
-                if (j == 0)
-                    output << 'x' << soft_var;
-                else
-                    output << " + " << 'x' << soft_var;
+                if (j != 0)
+                    output << " + ";
+                if (m_soft_weights.at(j) != 1)
+                    output << m_soft_weights.at(j) << ' ';
+                output << 'x' << soft_var;
                 nb_vars_in_line++;
                 if (nb_vars_in_line == 5) {
                     output << '\n';
@@ -515,50 +718,64 @@ namespace leximaxIST {
         }
         output << "Subject To\n";
         // print constraints
-        for (const Clause &cl : m_input_hard)
+        for (const ClauseRef cl : m_input_hard)
             print_lp_constraint(cl, output);
-        for (const Clause &cl : m_encoding)
+        for (const ClauseRef cl : m_encoding)
             print_lp_constraint(cl, output);
         // print all variables after Binaries
         output << "Binaries\n";
         for (int j (1); j <= m_id_count; ++j)
-            output << "x" << j << '\n';
+            output << 'x' << j << '\n';
         output << "End";
-        output.close();
+        end_instance_file(output, m_file_name, initial_time);
     }
     
-    void Solver::write_lp_file(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i) const
+    void Solver::write_lp_file(Writer &os, const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i) const
     {
-        const std::string filename ("/tmp/" + std::to_string(getpid()) + "_" + std::to_string(i) + ".lp");
-        std::ofstream os(filename); 
-        if (!os) {
-            print_error_msg("Could not open '" + filename + "' for writing");
-            exit(EXIT_FAILURE);
-        }
         // prepare input for the solver
         os << "Minimize\n";
-        os << " obj: " << "x" << max_vars.at(i) << '\n';
+        os << " obj: " << 'x' << max_vars.at(i) << '\n';
         os << "Subject To\n";
         // print constraints
         for (const ILPConstraint &ilpc : constraints)
             ilpc.print(os);
         os << "Binaries\n";
         // print all variables except for the maximum integer variables
+        std::vector<bool> is_max_var (m_id_count + 1, false);
+        for (int max_v : max_vars)
+            is_max_var.at(max_v) = true;
         for (int j (1); j <= m_id_count; ++j) {
-            // find j in max_vars
-            bool in_max_vars (false);
-            for (int max_v : max_vars) {
-                if (max_v == j)
-                    in_max_vars = true;
-            }
-            if (!in_max_vars)
-                os << "x" << j << '\n';
+            if (!is_max_var[j])
+                os << 'x' << j << '\n';
         }
         os << "Generals\n";
         for (size_t j (0); j < max_vars.size(); ++j)
-            os << "x" << max_vars.at(j) << '\n';
+            os << 'x' << max_vars.at(j) << '\n';
         os << "End";
-        os.close();
+    }
+
+    /* writes values (indexed by variable) as a MIP start
+     * gurobi reads the MST format, one "variable value" pair per line,
+     * and cplex reads its XML solution format, where the variables are identified by name only
+     * (cplex numbers the columns in the order they appear in the lp file, not as x1, x2, ...)
+     */
+    void Solver::write_mip_start(Writer &os, const std::vector<int> &values) const
+    {
+        const bool cplex (m_ilp_solver == "cplex");
+        if (cplex) {
+            os << "<?xml version=\"1.0\"?>\n<CPLEXSolutions version=\"1.2\">\n";
+            os << " <CPLEXSolution version=\"1.2\">\n";
+            os << "  <header problemName=\"leximaxIST\" solutionName=\"m1\" solutionIndex=\"0\"/>\n";
+            os << "  <variables>\n";
+        }
+        for (size_t v (1); v < values.size(); ++v) {
+            if (cplex)
+                os << "   <variable name=\"x" << v << "\" value=\"" << values[v] << "\"/>\n";
+            else
+                os << 'x' << v << ' ' << values[v] << '\n';
+        }
+        if (cplex)
+            os << "  </variables>\n </CPLEXSolution>\n</CPLEXSolutions>\n";
     }
     
     void Solver::remove_tmp_files()
@@ -566,6 +783,7 @@ namespace leximaxIST {
         for (const std::string &tmp_file : m_tmp_files)
             remove(tmp_file.c_str());
         m_tmp_files.clear();
+        close_instance_file();
     }
     
     int mss_choose_obj_seq (const std::vector<std::vector<int>> &todo_vec)
@@ -611,11 +829,11 @@ namespace leximaxIST {
         // compute the upper bounds
         std::vector<int> upper_bounds (m_num_objectives);
         for (int j (0); j < m_num_objectives; ++j)
-            upper_bounds.at(j) = m_objectives.at(j).size() - mss.at(j).size();
+            upper_bounds.at(j) = weight_sum(m_objectives.at(j)) - weight_sum(mss.at(j));
         // first check if the maximum can not be improved
         for (int j (0); j < m_num_objectives; ++j) {
-            const int todo_size (todo_vec.at(j).size());
-            if (upper_bounds.at(j) - todo_size >= best_max)
+            const int todo_weight (weight_sum(todo_vec.at(j)));
+            if (upper_bounds.at(j) - todo_weight >= best_max)
                 return -1;
         }
         const int max (*std::max_element(upper_bounds.begin(), upper_bounds.end()));
@@ -653,22 +871,32 @@ namespace leximaxIST {
             // compute the maximum of the best case decreased upper bounds
             // add clauses for each objective until the upper bound is decreased to max, if possible
             std::vector<int> upper_bounds (m_num_objectives);
-            for (int j (0); j < m_num_objectives; ++j)
-                upper_bounds.at(j) = m_objectives.at(j).size() - mss.at(j).size();
-            int max (upper_bounds.at(0) - vars_to_add.at(0).size());
+            std::vector<int> add_weights (m_num_objectives, 0); // weight of the variables to add, by objective
+            for (int j (0); j < m_num_objectives; ++j) {
+                upper_bounds.at(j) = weight_sum(m_objectives.at(j)) - weight_sum(mss.at(j));
+                for (int i : vars_to_add.at(j))
+                    add_weights.at(j) += weight(todo_vec.at(j).at(i));
+            }
+            int max (upper_bounds.at(0) - add_weights.at(0));
             for (int j (1); j < m_num_objectives; ++j) {
-                const int best_case_ub (upper_bounds.at(j) - vars_to_add.at(j).size());
+                const int best_case_ub (upper_bounds.at(j) - add_weights.at(j));
                 if (max < best_case_ub)
                     max = best_case_ub;
             }
             for (int j (0); j < m_num_objectives; ++j) {
                 const std::vector<int> add (vars_to_add.at(j));
                 std::vector<int> &todo (todo_vec[j]);
-                int limit_to_add; // number of variables to add to objective j
+                const int nb_add (add.size());
+                int limit_to_add (0); // number of variables to add to objective j
                 if (m_mss_add_cls == 0)
-                    limit_to_add = add.size(); // all
-                else
-                    limit_to_add = upper_bounds.at(j) - max; // even out upper bounds
+                    limit_to_add = nb_add; // all
+                else { // even out upper bounds
+                    int ub (upper_bounds.at(j));
+                    while (limit_to_add < nb_add && ub - weight(todo.at(add.at(limit_to_add))) >= max) {
+                        ub -= weight(todo.at(add.at(limit_to_add)));
+                        ++limit_to_add;
+                    }
+                }
                 // add clauses to mss and remove them from todo
                 // must do so from end to begining, because of how we erase from todo
                 for (int k (limit_to_add - 1); k >= 0; --k) { // Do not change the order!
@@ -702,10 +930,14 @@ namespace leximaxIST {
         if (m_verbosity >= 1)
             print_mss_enum_info();
         int nb_msses (0);
-        std::vector<int> obj_vec (get_objective_vector());
-        int best_max (*std::max_element(obj_vec.begin(), obj_vec.end()));
+        int best_max (m_solution_sorted.at(0));
         std::vector<Clause> blocking_cls;
         IpasirWrap *solver (nullptr);
+        // the input clauses and the blocking clauses, each non-incremental iteration starts from a copy
+        IpasirWrap snapshot (true);
+        configure_sat_solver(&snapshot); // the copies have the same model variables
+        if (!m_mss_incr)
+            snapshot.addClauses(m_input_hard);
         double initial_time (read_cpu_time());
         while (true) {
             if (m_mss_nb_limit > 0 && nb_msses >= m_mss_nb_limit)
@@ -715,8 +947,7 @@ namespace leximaxIST {
                 solver = m_sat_solver;
             else {
                 solver = &new_solver;
-                solver->addClauses(m_input_hard);
-                solver->addClauses(blocking_cls);
+                snapshot.copy_to(new_solver);
             }
             std::vector<std::vector<int>> mss (m_num_objectives);
             solver->set_timeout(m_approx_tout, initial_time);
@@ -744,8 +975,10 @@ namespace leximaxIST {
             }
             if (m_mss_incr)
                 add_hard_clause(block_mss);
-            else
+            else {
                 blocking_cls.push_back(block_mss);
+                snapshot.addClause(block_mss);
+            }
             ++nb_msses;
         }
         if (m_verbosity == 2) {
@@ -777,15 +1010,15 @@ namespace leximaxIST {
         if (rv != 10)
             return rv; // UNSAT or interrupted
         // SAT, but the MSS may be empty. If so, all MSSes have been found
-        std::vector<int> model (solver->model()); // copy
-        const std::vector<int> &obj_vec (set_solution(solver->model())); // move
-        best_max = *std::max_element(obj_vec.begin(), obj_vec.end()); 
         std::vector<std::vector<int>> todo_vec (m_num_objectives);
         for (int i (0); i < m_num_objectives; ++i) {
             const std::vector<int> &objective (m_objectives.at(i));
             todo_vec[i] = objective; // copy assignment
         }
-        mss_add_falsified (solver, model, mss, todo_vec, assumps);
+        // the model is read before set_solution moves it
+        mss_add_falsified (solver, solver->model(), mss, todo_vec, assumps);
+        const std::vector<int> &obj_vec (set_solution(solver->model())); // move
+        best_max = *std::max_element(obj_vec.begin(), obj_vec.end()); 
         int nb_calls (1);
         while (true /*stops when obj_index == -1 or if SAT call is interrupted*/) {
             if (m_verbosity == 2)
@@ -801,9 +1034,6 @@ namespace leximaxIST {
                 break;
             }
             if (rv_local == 10) { // SAT
-                model = solver->model(); // copy
-                const std::vector<int> &obj_vec (set_solution(solver->model())); // move
-                best_max = *std::max_element(obj_vec.begin(), obj_vec.end());
                 // add clause to the mss
                 if (!m_mss_incr) {
                     assumps.pop_back();
@@ -813,7 +1043,9 @@ namespace leximaxIST {
                 mss.at(obj_index).push_back(-next_var);
                 // remove next_var from todo (BEFORE mss_add_falsified)
                 erase_from_todo(todo_vec, obj_index, 0);
-                mss_add_falsified (solver, model, mss, todo_vec, assumps);
+                mss_add_falsified (solver, solver->model(), mss, todo_vec, assumps);
+                const std::vector<int> &obj_vec (set_solution(solver->model())); // move
+                best_max = *std::max_element(obj_vec.begin(), obj_vec.end());
             }
             else { // UNSAT
                 // add clause to the mcs (backbone literals)
@@ -846,42 +1078,33 @@ namespace leximaxIST {
         return lb;
     }
     
-    /* Calls external MaxSAT solver on the problem of the sum of all objectives
+    /* Minimises the sum of all objectives with the internal OLL search or,
+     * if m_maxsat_psol_cmd is set, calls that external MaxSAT solver
      * Updates m_solution if the new solution is leximax better
      * Returns the (optimum) value of the sum of all objectives
      */
     int Solver::maxsat_presolve()
     {
-        if (m_maxsat_psol_cmd.empty()) {
-            print_error_msg("Empty MaxSAT presolve command");
-            exit(EXIT_FAILURE);
-        }
+        if (m_maxsat_psol_cmd.empty())
+            return oll_presolve();
         // soft clauses are negations of all objective variables
         m_soft_clauses.clear();
+        m_soft_weights.clear();
         for (const std::vector<int> &obj : m_objectives) {
-            for (int x : obj)
+            for (int x : obj) {
                 m_soft_clauses.push_back(-x);
+                m_soft_weights.push_back(weight(x));
+            }
         }
         write_wcnf_file(0);
         std::string command (m_maxsat_psol_cmd);
-        std::string output_filename (m_file_name + ".sol");
         command += " " + m_file_name;
-        command += " > " + output_filename;
-        command += " 2> " + m_file_name + ".err";
-        call_ext_solver(command);
+        std::vector<char> output;
+        call_ext_solver(command, m_file_name, &output);
         // read output
-        gzFile of = gzopen(output_filename.c_str(), "rb");
-        if (of == Z_NULL) {
-            print_error_msg("Can't open file '" + output_filename + "' for reading");
-            if (!m_leave_tmp_files)
-                remove_tmp_files();
-            exit(EXIT_FAILURE);
-        }
-        StreamBuffer r(of);
-        bool sat = false;
         // choose the best solution in terms of the leximax order
         std::vector<int> model (m_id_count + 1, 0);
-        read_sat_output(model, sat, r);
+        read_solver_output(model, std::move(output), true);
         const std::vector<int> &obj_vec (get_objective_vector(model));
         int sum (0);
         for (int obj_value : obj_vec)
@@ -891,36 +1114,51 @@ namespace leximaxIST {
             remove_tmp_files();
         // set m_file_name back to pid
         reset_file_name();
+        check_deadline(); // if the solver was stopped, sum is not the minimum
         return sum;
     }
     
     void Solver::approximate()
     {
         double initial_time (read_cpu_time());
-        // check if problem is satisfiable
-        if (!call_sat_solver(m_sat_solver, {})) {
-            m_status = 'u';
-            return;
+        check_retention(true);
+        m_input_nb_vars = m_id_count;
+        configure_sat_solver(m_sat_solver);
+        reduce_weights();
+        try {
+            // check if problem is satisfiable
+            if (!call_sat_solver(m_sat_solver, {})) {
+                m_status = 'u';
+                return;
+            }
+            m_status = 's'; // update status to SATISFIABLE
+            if (m_approx == "gia") {
+                if (m_verbosity >= 1)
+                    std::cout << "c Approximating using Guided Improvement Algorithm (GIA)...\n";
+                gia();
+            }
+            else if (m_approx == "mss") {
+                if (m_verbosity >= 1)
+                    std::cout << "c Approximating using Maximal Satisfiable Subsets...\n";
+                mss_enumerate();
+            }
+            else {
+                print_error_msg("Invalid approximation algorithm");
+                exit(EXIT_FAILURE);
+            }
         }
-        m_status = 's'; // update status to SATISFIABLE
-        if (m_approx == "gia") {
-            if (m_verbosity >= 1)
-                std::cout << "c Approximating using Guided Improvement Algorithm (GIA)...\n";
-            // encode sorted vectors with sorting network
-            for (int j (0); j < m_num_objectives; ++j)
-                encode_sorted(m_objectives.at(j), j);
-            encode_bounds(0, 0); // upper bound all objs based on the solution given by the SAT solver
-            gia();
-        }
-        else if (m_approx == "mss") {
-            if (m_verbosity >= 1)
-                std::cout << "c Approximating using Maximal Satisfiable Subsets...\n";
-            mss_enumerate();
+        catch (const DeadlineReached&) {
+            interrupted();
+            return;
         }
-        else {
-            print_error_msg("Invalid approximation algorithm");
-            exit(EXIT_FAILURE);
+        catch (const std::bad_alloc&) {
+            m_deadline.interrupt(_MEMOUT_);
+            interrupted();
+            return;
         }
+        // the SAT calls of mss and gia return when interrupted by the deadline
+        if (m_deadline.reached())
+            interrupted();
         if (m_verbosity >= 1)
             print_time(read_cpu_time() - initial_time, "c Approximation CPU time: ");
     }
@@ -938,13 +1176,30 @@ namespace leximaxIST {
         int max_index (0);
         bool skip (false);
         double initial_time (read_cpu_time());
+        // encode sorted vectors with sorting network (up to the upper bound given by the first solution)
+        const int first_id (m_id_count);
+        const int ub (incumbent_max());
+        for (int j (0); j < m_num_objectives; ++j)
+            encode_sorted(m_objectives.at(j), j, comparator_polarity(_POLARITY_FULL_), ub); // GIA fixes previous maxima from below
+        encode_bounds(0, 0); // upper bound all objs based on the solution given by the SAT solver
+        // the input clauses and the encoding, each non-incremental iteration starts from a copy
+        IpasirWrap snapshot (true);
+        size_t nb_encoding_cls (0); // number of clauses of m_encoding in the snapshot
+        configure_sat_solver(&snapshot); // the copies have the same model variables
+        if (!m_gia_incr) {
+            snapshot.addClauses(m_input_hard);
+            if (!m_encoding.retains())
+                gia_encode_snapshot(snapshot, first_id, ub);
+        }
         while (true /*stops when interrupted or last max can not be improved*/) {
             IpasirWrap new_solver;
             IpasirWrap *solver (nullptr);
             if (!m_gia_incr) {
+                // the encoding only grows (upper bounds on the sorted vectors)
+                for (; m_encoding.retains() && nb_encoding_cls < m_encoding.size(); ++nb_encoding_cls)
+                    snapshot.addClause(m_encoding[nb_encoding_cls]);
                 solver = &new_solver;
-                solver->addClauses(m_input_hard);
-                solver->addClauses(m_encoding);
+                snapshot.copy_to(new_solver);
             }
             else
                 solver = m_sat_solver;
@@ -965,13 +1220,12 @@ namespace leximaxIST {
             if (max_index == m_num_objectives)
                 break;
             // check if the ith max can be improved without restrictions on smaller objs
-            const std::vector<int> &obj_vec = get_objective_vector();
+            const std::vector<int> &obj_vec (m_solution_obj_vec);
             if (m_verbosity == 2) {
                 std::cout << "c Current objective vector: ";
                 print_obj_vector(obj_vec);
             }
-            std::vector<int> s_obj_vec (obj_vec);
-            std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
+            const std::vector<int> &s_obj_vec (m_solution_sorted);
             if (s_obj_vec.at(max_index) == 0)
                 break;
             std::vector<int> assumps;
@@ -981,8 +1235,11 @@ namespace leximaxIST {
             decrease_max(assumps, max_index, obj_vec);
             // solve with m_sat_solver because the new_solver is now forever unsat
             // set upper bound on all objectives as hard clauses
-            if (max_index == 0) 
+            if (max_index == 0) {
                 encode_ub_sorted(s_obj_vec.at(max_index));
+                if (!m_gia_incr && !m_encoding.retains())
+                    gia_encode_snapshot(snapshot, 0, s_obj_vec.at(max_index));
+            }
             double t (0.0);
             if (m_verbosity >= 1) {
                 t = read_cpu_time();
@@ -1008,6 +1265,36 @@ namespace leximaxIST {
         m_sat_solver->set_timeout(std::numeric_limits<double>::max(), 0);
     }
     
+    /* non-incremental GIA when m_encoding does not keep the encoding: as in core_rebuild, the encoding
+     * is generated again from the objectives, in the snapshot of gia(); from the variable first_id, the
+     * same sorting networks up to ub have the same variables as in m_sat_solver (if first_id is 0,
+     * only the upper bound ub on all objectives is added)
+     */
+    void Solver::gia_encode_snapshot(IpasirWrap &snapshot, int first_id, int ub)
+    {
+        // the encoding clauses go to m_sat_solver (see encoding_clause_added)
+        IpasirWrap *sat_solver (m_sat_solver);
+        m_sat_solver = &snapshot;
+        try {
+            if (first_id != 0) {
+                const int id_count (m_id_count);
+                m_id_count = first_id;
+                for (int j (0); j < m_num_objectives; ++j)
+                    encode_sorted(m_objectives.at(j), j, comparator_polarity(_POLARITY_FULL_), ub);
+                if (m_id_count != id_count) {
+                    print_error_msg("In Solver::gia_encode_snapshot(), the encoding has other variables");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            encode_ub_sorted(ub);
+        }
+        catch (...) {
+            m_sat_solver = sat_solver;
+            throw;
+        }
+        m_sat_solver = sat_solver;
+    }
+    
     /* adds to unit_clauses the clauses that:
      * fix some objectives whose values are equal to previous maxima
      * CONVENTION: if there are previous maxima equal to the current maximum,
@@ -1015,6 +1302,7 @@ namespace leximaxIST {
      */
     void Solver::fix_previous_max(std::vector<int> &unit_clauses, int max_index, const std::vector<int> &obj_vec) const
     {
+        check_polarity(_POLARITY_FULL_); // the objectives are fixed from above and from below
         std::vector<int> s_obj_vec (obj_vec);
         std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
         int min_prev (0);
@@ -1026,13 +1314,12 @@ namespace leximaxIST {
             // i is the nb of fixed objs; j is the obj index
             const int obj_val (obj_vec.at(j));
             if (obj_val >= min_prev) {
-                const std::vector<int> &sorted_vec (m_sorted_vecs.at(j));
-                const int size (sorted_vec.size());
-                const int pos (size - obj_val); // 0 <= pos <= size
-                if (pos < size)
-                    unit_clauses.push_back(sorted_vec.at(pos)); // lower bound
-                if (pos - 1 >= 0)
-                    unit_clauses.push_back(-sorted_vec.at(pos - 1)); // upper bound
+                const int lb_lit (obj_val > 0 ? sorted_geq(j, obj_val) : 0);
+                const int ub_lit (sorted_geq(j, obj_val + 1));
+                if (lb_lit != 0)
+                    unit_clauses.push_back(lb_lit); // lower bound
+                if (ub_lit != 0)
+                    unit_clauses.push_back(-ub_lit); // upper bound
                 if (m_verbosity == 2)
                     std::cout << "c Objective " << j << ": = " << obj_val << '\n';
                 ++i; // one more fixed
@@ -1045,6 +1332,7 @@ namespace leximaxIST {
      */
     void Solver::decrease_max(std::vector<int> &unit_clauses, int max_index, const std::vector<int> &obj_vec) const
     {
+        check_polarity(_POLARITY_UPWARD_);
         std::vector<int> s_obj_vec (obj_vec);
         std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
         int min_prev (0);
@@ -1058,24 +1346,20 @@ namespace leximaxIST {
             if (obj_val >= min_prev)
                 ++i; // fixed obj
             else {
-                const std::vector<int> &sorted_vec (m_sorted_vecs.at(j));
-                const int size (sorted_vec.size());
                 const int ub (s_obj_vec.at(max_index) - 1);
-                const int pos (size - ub); // 0 <= pos <= size
-                if (pos - 1 >= 0)
-                    unit_clauses.push_back(-sorted_vec.at(pos - 1)); // upper bound
+                const int ub_lit (sorted_geq(j, ub + 1));
+                if (ub_lit != 0)
+                    unit_clauses.push_back(-ub_lit); // upper bound
                 if (m_verbosity == 2)
                     std::cout << "c Objective " << j << ": <= " << ub << '\n';
             }
         }
         // bound the remaining objs
         for (; j < m_num_objectives; ++j) {
-            const std::vector<int> &sorted_vec (m_sorted_vecs.at(j));
-            const int size (sorted_vec.size());
             const int ub (s_obj_vec.at(max_index) - 1); // <= max-1
-            const int pos (size - ub); // 0 <= pos <= size
-            if (pos - 1 >= 0)
-                unit_clauses.push_back(-sorted_vec.at(pos - 1)); // upper bound
+            const int ub_lit (sorted_geq(j, ub + 1));
+            if (ub_lit != 0)
+                unit_clauses.push_back(-ub_lit); // upper bound
             if (m_verbosity == 2)
                 std::cout << "c Objective " << j << ": <= " << ub << '\n';
         }
@@ -1085,14 +1369,13 @@ namespace leximaxIST {
      */
     void Solver::bound_objs(std::vector<int> &unit_clauses, int max, const std::vector<int> &obj_vec) const
     {
+        check_polarity(_POLARITY_UPWARD_);
         for (int i (0); i < m_num_objectives; ++i) {
-            const std::vector<int> &sorted_vec (m_sorted_vecs.at(i));
             const int obj_val (obj_vec.at(i));
-            const int size (sorted_vec.size());
             if (obj_val < max) {
-                const int pos (size - obj_val - 1); // -1 <= pos <= size - 1
-                if (pos >= 0)
-                    unit_clauses.push_back(-sorted_vec.at(pos)); // upper bound
+                const int ub_lit (sorted_geq(i, obj_val + 1));
+                if (ub_lit != 0)
+                    unit_clauses.push_back(-ub_lit); // upper bound
                 if (m_verbosity == 2)
                     std::cout << "c Objective " << i << ": <= " << obj_val << '\n';
             }
@@ -1116,13 +1399,12 @@ namespace leximaxIST {
         int max_index_local (max_index);
         while (true/* ends when unsat or interrupted */) {
             std::vector<int> assumps;
-            const std::vector<int> &obj_vec = get_objective_vector();
+            const std::vector<int> &obj_vec (m_solution_obj_vec);
             if (m_verbosity == 2) {
                 std::cout << "c Current objective vector: ";
                 print_obj_vector(obj_vec);
             }
-            std::vector<int> s_obj_vec (obj_vec);
-            std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
+            const std::vector<int> &s_obj_vec (m_solution_sorted); // changes when a better solution is found
             const int max (s_obj_vec.at(max_index_local));
             if (max == 0) {
                 rv = 20; // unsat - can not improve max
@@ -1189,7 +1471,7 @@ namespace leximaxIST {
         return rv;
     }
     
-    /* Presolve: Find solutions to get bounds on the optimal first maximum
+    /* Presolve (after the satisfiability check): Find solutions to get bounds on the optimal first maximum
      * Returns the minimum value of the sum of the obj functions, if m_maxsat_presolve
      * Otherwise returns 0
      * Sets m_solution which can be used to retrieve the upper bound
@@ -1197,15 +1479,6 @@ namespace leximaxIST {
     int Solver::presolve()
     {   
         int sum (0);
-        if (m_verbosity >= 1) {
-            std::cout << "c Presolving...\n";
-            std::cout << "c Checking satisfiability...\n";
-        }
-        if (!call_sat_solver(m_sat_solver, {})) {
-            m_status = 'u';
-            return 0;
-        }
-        m_status = 's';
         if (m_maxsat_presolve) {
             double initial_time;
             if (m_verbosity >= 1) {
@@ -1235,36 +1508,30 @@ namespace leximaxIST {
     {
         const std::vector<int> &core (m_sat_solver->conflict());
         // get the position in m_soft_clauses of the var with the greatest id in the core
-        // NOTE: we assume m_soft_clauses is sorted in increasing order
-        for (int pos (m_soft_clauses.size() - 1); pos >= 0; --pos) {
-            const int var (std::abs(m_soft_clauses.at(pos)));
-            // try to find var in core
-            bool found (false);
-            for (int lit : core) {
-                if (std::abs(lit) == var) {
-                    found = true;
-                    break;
-                }
-            }
-            if (found) { // update lower bound and return
-                // update the lower bound pos = size - lb, hence, lb = size - pos
-                const int new_lb = m_soft_clauses.size() - pos;
-                if (new_lb <= lb) {
-                    print_error_msg("In Solver::update_lb(), lb did not increase");
-                    exit(EXIT_FAILURE);
-                }
-                lb = new_lb;
-                break;
+        // NOTE: we assume m_soft_clauses is sorted in increasing order, so each position is found by binary search
+        int max_pos (-1);
+        for (int lit : core) {
+            const int var (std::abs(lit));
+            std::vector<int>::const_iterator it (std::lower_bound(m_soft_clauses.begin(), m_soft_clauses.end(), var,
+                [](int sc, int v) { return std::abs(sc) < v; }));
+            if (it != m_soft_clauses.end() && std::abs(*it) == var && it - m_soft_clauses.begin() > max_pos)
+                max_pos = it - m_soft_clauses.begin();
+        }
+        if (max_pos != -1) { // update lower bound
+            // the soft variable of the smallest value in the core is true
+            const int new_lb = m_max_values.at(max_pos);
+            if (new_lb <= lb) {
+                print_error_msg("In Solver::update_lb(), lb did not increase");
+                exit(EXIT_FAILURE);
             }
+            lb = new_lb;
         }
         // check core size. If core size > 1, get the relevant variable and add it as hard
-        // cost >= lb means at least lb ones
-        // size - 1 means 1 one, size - 2 means 2 ones, ...
+        // cost >= lb means that the soft variable of the smallest value that is at least lb is true
         if (m_verbosity >= 1)
             std::cout << "c core size: " << core.size() << '\n';
         if (core.size() > 1) {
-            const int size (m_soft_clauses.size());
-            const int sc = m_soft_clauses.at(size - lb);
+            const int sc = m_soft_clauses.at(value_pos(m_max_values, lb));
             add_clause(-sc);
         }
     }
@@ -1274,7 +1541,6 @@ namespace leximaxIST {
         int nb_calls (0);
         if (m_verbosity >= 1)
             print_bounds(lb, ub);
-        int size (m_soft_clauses.size());
         while (ub != lb) {
             int k;
             if (m_opt_mode == "bin")
@@ -1283,9 +1549,9 @@ namespace leximaxIST {
                 k = ub - 1;
             else if (m_opt_mode == "lin_us")
                 k = lb;
-            // y <= k means size - k zeros; last position = size - k - 1
+            // y <= k means zeros for the values larger than k; last position = limit
             // adding all neg vars to assumps may allow lb to increase by more than 1
-            const int limit (size - k - 1);
+            const int limit (value_pos(m_max_values, k + 1));
             std::vector<int> assumps (limit + 1);
             for (int j (0); j <= limit; ++j)
                 assumps.at(j) = m_soft_clauses.at(j);
@@ -1296,14 +1562,14 @@ namespace leximaxIST {
             if (m_verbosity >= 1)
                 print_time(read_cpu_time() - initial_time, "c SAT call CPU time: ");
             if (rv == 0) {
+                check_deadline();
                 print_error_msg("SAT solver interrupted with no timeout!");
                 exit(EXIT_FAILURE);
             }
             if (rv == 10) { // cost <= k
                 // get solution and refine upper bound
-                std::vector<int> s_obj_vec (set_solution(m_sat_solver->model()));
-                std::sort (s_obj_vec.begin(), s_obj_vec.end(), descending_order);
-                ub = s_obj_vec.at(i); // if obj value is, by chance, less than k
+                set_solution(m_sat_solver->model());
+                ub = m_solution_sorted.at(i); // if obj value is, by chance, less than k
                 encode_ub_soft(ub); // bound the cost in hard clauses, not as assumptions
             }
             else { // cost >= k + 1
@@ -1329,9 +1595,7 @@ namespace leximaxIST {
                 std::cout << "c Linear UNSAT-SAT ";
             std::cout << "search of optimum with incremental SAT solver...\n";
         }
-        std::vector<int> s_obj_vec (get_objective_vector());
-        std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
-        const int ub (s_obj_vec.at(i));
+        const int ub (m_solution_sorted.at(i));
         double initial_time;
         if (m_verbosity >= 1)
             initial_time = read_cpu_time();
@@ -1357,6 +1621,7 @@ namespace leximaxIST {
         if (m_verbosity >= 1)
             print_time(read_cpu_time() - initial_time, "c SAT call CPU time: ");
         if (rv == 0) {
+            check_deadline();
             print_error_msg("SAT Solver Interrupted!");
             exit(EXIT_FAILURE);
         }
@@ -3,6 +3,7 @@
 #include <leximaxIST_types.h>
 #include <utility>
 #include <vector>
+#include <algorithm>
 
 namespace leximaxIST {
 
@@ -13,23 +14,30 @@ namespace leximaxIST {
     * the smallest of the outputs, if i < j
     * the greatest of the outputs, if i > j.*/
 
-    void Solver::encode_max(int var_out_max, int var_in1, int var_in2)
+    void Solver::encode_max(int var_out_max, int var_in1, int var_in2, int polarity)
     {
         // encode var_out_max is equivalent to var_in1 OR var_in2
-        add_clause(-var_out_max, var_in1, var_in2);
-        add_clause(var_out_max, -var_in1);
-        add_clause(var_out_max, -var_in2);
+        if (polarity != _POLARITY_UPWARD_)
+            add_clause(-var_out_max, var_in1, var_in2);
+        if (polarity != _POLARITY_DOWNWARD_) {
+            add_clause(var_out_max, -var_in1);
+            add_clause(var_out_max, -var_in2);
+        }
     }
 
-    void Solver::encode_min(int var_out_min, int var_in1, int var_in2)
+    void Solver::encode_min(int var_out_min, int var_in1, int var_in2, int polarity)
     {
         // encode var_out_min is equivalent to var_in1 AND var_in2
-        add_clause(-var_out_min, var_in1);
-        add_clause(-var_out_min, var_in2);
-        add_clause(var_out_min, -var_in1, -var_in2);
+        if (polarity != _POLARITY_UPWARD_) {
+            add_clause(-var_out_min, var_in1);
+            add_clause(-var_out_min, var_in2);
+        }
+        if (polarity != _POLARITY_DOWNWARD_)
+            add_clause(var_out_min, -var_in1, -var_in2);
     }
 
-    void Solver::insert_comparator(int el1, int el2, const std::vector<int> *objective, SNET &sorting_network)
+    // polarity: which half of the comparator is encoded (_POLARITY_FULL_ for both)
+    void Solver::insert_comparator(int el1, int el2, const std::vector<int> *objective, SNET &sorting_network, int polarity)
     {
         if (m_verbosity == 2)
             std::cout << "c Inserting comparator between wires " << el1 << " and " << el2 << '\n';
@@ -39,8 +47,8 @@ namespace leximaxIST {
         int var_out_min = fresh();
         int var_out_max = fresh();
         // encode outputs, if el1 > el2 then el1 is the largest, that is, the or. Otherwise, el1 is the smallest, i.e. the and.
-        encode_max(var_out_max, var_in1, var_in2);
-        encode_min(var_out_min, var_in1, var_in2);
+        encode_max(var_out_max, var_in1, var_in2, polarity);
+        encode_min(var_out_min, var_in1, var_in2, polarity);
         std::pair<int,int> comp1 (el2, 0);
         std::pair<int,int> comp2 (el1, 0);
         if(el1 > el2)
@@ -66,7 +74,7 @@ namespace leximaxIST {
     }
 
     // returns the number of comparators added to the sorting network by this function
-    int Solver::odd_even_merge(std::pair<std::pair<int,int>,int> seq1, std::pair<std::pair<int,int>,int> seq2, const std::vector<int> *objective, SNET &sorting_network)
+    int Solver::odd_even_merge(std::pair<std::pair<int,int>,int> seq1, std::pair<std::pair<int,int>,int> seq2, const std::vector<int> *objective, SNET &sorting_network, int polarity)
     {
         int nb_comparators (0);
         int el1;
@@ -80,7 +88,7 @@ namespace leximaxIST {
             // merge two elements with a single comparator.
             el1 = seq1.first.first;
             el2 = seq2.first.first;
-            insert_comparator(el1, el2, objective, sorting_network);
+            insert_comparator(el1, el2, objective, sorting_network, polarity);
             ++nb_comparators;
         }
         else {
@@ -94,28 +102,28 @@ namespace leximaxIST {
             std::pair<std::pair<int,int>,int> odd1(p1, 2*offset1);
             std::pair<int,int> p2(first2, ceiling_of_half(size2));
             std::pair<std::pair<int,int>,int> odd2(p2, 2*offset2);
-            nb_comparators += odd_even_merge(odd1, odd2, objective, sorting_network);
+            nb_comparators += odd_even_merge(odd1, odd2, objective, sorting_network, polarity);
             // merge even subsequences
             // size of even subsequence is the floor of half of the size of the original sequence
             p1 = std::make_pair(first1 + offset1, size1/2);
             std::pair<std::pair<int,int>,int> even1(p1, 2*offset1);
             p2 = std::make_pair(first2 + offset2, size2/2);
             std::pair<std::pair<int,int>,int> even2(p2, 2*offset2);
-            nb_comparators += odd_even_merge(even1, even2, objective, sorting_network);
+            nb_comparators += odd_even_merge(even1, even2, objective, sorting_network, polarity);
             // comparison-interchange
             for(int i{2}; i <= size1; i = i + 2){
                 if(i == size1){
                     // connect last of seq1 to first element of seq2
                     el1 = first1 + offset1*(size1-1);
                     el2 = first2;
-                    insert_comparator(el1, el2, objective, sorting_network);
+                    insert_comparator(el1, el2, objective, sorting_network, polarity);
                     ++nb_comparators;
                 }
                 else{
                     // connect i-th of seq1 with i+1-th of seq1
                     el1 = first1 + offset1*(i-1);
                     el2 = el1 + offset1;
-                    insert_comparator(el1, el2, objective, sorting_network);
+                    insert_comparator(el1, el2, objective, sorting_network, polarity);
                     ++nb_comparators;
                 }
             }
@@ -124,7 +132,7 @@ namespace leximaxIST {
                     // connect i-th of seq2 with i+1-th of seq2
                     el1 = first2 + offset2*(i-1);
                     el2 = el1 + offset2;
-                    insert_comparator(el1, el2, objective, sorting_network); 
+                    insert_comparator(el1, el2, objective, sorting_network, polarity); 
                     ++nb_comparators;
             }
         }
@@ -132,7 +140,7 @@ namespace leximaxIST {
     }
 
     // returns the number of comparators of the sorting network
-    int Solver::encode_network(const std::pair<int,int> elems_to_sort, const std::vector<int> *objective, SNET &sorting_network)
+    int Solver::encode_network(const std::pair<int,int> elems_to_sort, const std::vector<int> *objective, SNET &sorting_network, int polarity)
     {
         /* in the case the sorting network only has one element (this is important for the core-guided algorithm)
         * we must set the pair to (0, objective->at(0))
@@ -156,69 +164,380 @@ namespace leximaxIST {
             std::pair<int,int> split1(first_elem, m);
             std::pair<int,int> split2(first_elem + m, n);
             // recursively sort the first m elements and the last n elements
-            nb_comparators += encode_network(split1, objective, sorting_network);
-            nb_comparators += encode_network(split2, objective, sorting_network);
+            nb_comparators += encode_network(split1, objective, sorting_network, polarity);
+            nb_comparators += encode_network(split2, objective, sorting_network, polarity);
             // merge the sorted m elements and the sorted n elements
             std::pair<std::pair<int,int>,int> seq1(split1,1);
             std::pair<std::pair<int,int>,int> seq2(split2,1);
-            nb_comparators += odd_even_merge(seq1, seq2, objective, sorting_network);
+            nb_comparators += odd_even_merge(seq1, seq2, objective, sorting_network, polarity);
+        }
+        return nb_comparators;
+    }
+    
+    /* Pairwise sorting network (Parberry): the inputs are compared in pairs, the larger and the smaller
+     * elements of the pairs are sorted recursively and then merged.
+     * The wires are padded with 0 (constant false) up to a power of two, the comparators with a constant
+     * input have no clauses. In these functions the wires are sorted in descending order.
+     */
+    std::pair<int,int> Solver::pairwise_comparator(int in1, int in2, int polarity, int &nb_comparators)
+    {
+        if (in1 == 0 || in2 == 0)
+            return std::make_pair(in1 == 0 ? in2 : in1, 0);
+        const int var_out_max (fresh());
+        const int var_out_min (fresh());
+        encode_max(var_out_max, in1, in2, polarity);
+        encode_min(var_out_min, in1, in2, polarity);
+        ++nb_comparators;
+        return std::make_pair(var_out_max, var_out_min);
+    }
+    
+    // merges sorted sequences of the same size such that larger[j] >= smaller[j] for all j
+    std::vector<int> Solver::pairwise_merge(const std::vector<int> &larger, const std::vector<int> &smaller, int polarity, int &nb_comparators)
+    {
+        const size_t n (larger.size());
+        if (n == 1)
+            return {larger.at(0), smaller.at(0)};
+        std::vector<int> larger_odd, larger_even, smaller_odd, smaller_even;
+        for (size_t j (0); j < n; ++j) {
+            (j % 2 == 0 ? larger_odd : larger_even).push_back(larger.at(j));
+            (j % 2 == 0 ? smaller_odd : smaller_even).push_back(smaller.at(j));
+        }
+        const std::vector<int> odd (pairwise_merge(larger_odd, smaller_odd, polarity, nb_comparators));
+        const std::vector<int> even (pairwise_merge(larger_even, smaller_even, polarity, nb_comparators));
+        std::vector<int> merged (1, odd.at(0));
+        for (size_t j (0); j + 1 < n; ++j) {
+            const std::pair<int,int> outputs (pairwise_comparator(odd.at(j + 1), even.at(j), polarity, nb_comparators));
+            merged.push_back(outputs.first);
+            merged.push_back(outputs.second);
+        }
+        merged.push_back(even.at(n - 1));
+        return merged;
+    }
+    
+    std::vector<int> Solver::pairwise_sort(const std::vector<int> &wires, int polarity, int &nb_comparators)
+    {
+        if (wires.size() == 1)
+            return wires;
+        std::vector<int> larger, smaller;
+        for (size_t j (0); j < wires.size(); j += 2) {
+            const std::pair<int,int> outputs (pairwise_comparator(wires.at(j), wires.at(j + 1), polarity, nb_comparators));
+            larger.push_back(outputs.first);
+            smaller.push_back(outputs.second);
+        }
+        return pairwise_merge(pairwise_sort(larger, polarity, nb_comparators), pairwise_sort(smaller, polarity, nb_comparators), polarity, nb_comparators);
+    }
+    
+    // outputs in ascending order, returns the number of comparators
+    int Solver::encode_pairwise(const std::vector<int> &objective, std::vector<int> &outputs, int polarity)
+    {
+        int nb_comparators (0);
+        size_t nb_wires (1);
+        while (nb_wires < objective.size())
+            nb_wires *= 2;
+        std::vector<int> wires (objective);
+        wires.resize(nb_wires, 0);
+        const std::vector<int> sorted (pairwise_sort(wires, polarity, nb_comparators));
+        // the smallest nb_wires - objective.size() outputs are false
+        outputs.resize(objective.size());
+        for (size_t j (0); j < outputs.size(); ++j)
+            outputs.at(j) = sorted.at(outputs.size() - 1 - j);
+        return nb_comparators;
+    }
+    
+    /* Selection network: the k largest outputs of a sorting network of objective (in ascending order).
+     * The inputs are split in blocks of k elements, each block is sorted and merged with the k largest
+     * elements of the previous blocks, the smaller outputs of the merge are discarded.
+     * The network has O(n log^2 k) comparators instead of O(n log^2 n).
+     * The blocks are sorted with the pairwise network if sorter is _SORTER_PAIRWISE_.
+     * Returns the number of comparators.
+     */
+    int Solver::encode_selection(const std::vector<int> &objective, int k, std::vector<int> &outputs, int polarity, int sorter)
+    {
+        int nb_comparators (0);
+        outputs.clear();
+        for (size_t first (0); first < objective.size(); first += k) {
+            const size_t block_size (std::min(objective.size() - first, static_cast<size_t>(k)));
+            const std::vector<int> block (objective.begin() + first, objective.begin() + first + block_size);
+            std::vector<int> sorted_block;
+            if (m_verbosity == 2)
+                std::cout << "c Sorting block of " << block_size << " elements\n";
+            if (sorter == _SORTER_PAIRWISE_)
+                nb_comparators += encode_pairwise(block, sorted_block, polarity);
+            else {
+                SNET block_network(block_size, {-1,-1});
+                nb_comparators += encode_network(std::make_pair(0, block_size), &block, block_network, polarity);
+                for (const std::pair<int,int> &wire : block_network)
+                    sorted_block.push_back(wire.second);
+            }
+            // the first block_size entries of merge_network are the k largest outputs so far (outputs is empty for the first block)
+            const size_t old_size (outputs.size());
+            SNET merge_network(old_size + block_size, {-1,-1});
+            for (size_t j (0); j < old_size; ++j)
+                merge_network.at(j) = std::make_pair(0, outputs.at(j));
+            for (size_t j (0); j < block_size; ++j)
+                merge_network.at(old_size + j) = std::make_pair(0, sorted_block.at(j));
+            std::pair<std::pair<int,int>,int> seq1(std::make_pair(0, old_size), 1);
+            std::pair<std::pair<int,int>,int> seq2(std::make_pair(old_size, block_size), 1);
+            nb_comparators += odd_even_merge(seq1, seq2, nullptr, merge_network, polarity);
+            // keep the k largest outputs
+            const size_t nb_outputs (std::min(merge_network.size(), static_cast<size_t>(k)));
+            outputs.resize(nb_outputs);
+            for (size_t j (0); j < nb_outputs; ++j)
+                outputs.at(j) = merge_network.at(merge_network.size() - nb_outputs + j).second;
+        }
+        return nb_comparators;
+    }
+    
+    /* The weighted objectives are sorted with a generalized totalizer instead of a sorting network.
+     * The outputs of a node are pairs (sum, var), one for each value that the weighted sum
+     * of the inputs of the node can take (except 0), in increasing order of sum.
+     * var is true if and only if the weighted sum of the inputs is greater than or equal to sum.
+     * The sums greater than max_sum are not distinguished: the output of max_sum is true iff the sum is at least max_sum.
+     * Returns the number of clauses added.
+     */
+    int Solver::gte_merge(const GTE_OUT &outputs1, const GTE_OUT &outputs2, GTE_OUT &outputs, int polarity, int max_sum)
+    {
+        if (outputs1.empty() || outputs2.empty()) {
+            outputs = outputs1.empty() ? outputs2 : outputs1;
+            return 0;
+        }
+        // the values that the sum can take
+        std::vector<int> sums;
+        for (const std::pair<int,int> &p2 : outputs2) {
+            sums.push_back(p2.first);
+            for (const std::pair<int,int> &p1 : outputs1)
+                sums.push_back(std::min(p1.first + p2.first, max_sum));
+        }
+        for (const std::pair<int,int> &p1 : outputs1)
+            sums.push_back(p1.first);
+        std::sort(sums.begin(), sums.end());
+        sums.erase(std::unique(sums.begin(), sums.end()), sums.end());
+        outputs.resize(sums.size());
+        for (size_t k (0); k < sums.size(); ++k)
+            outputs.at(k) = std::make_pair(sums.at(k), fresh());
+        // output variable of the smallest sum greater than or equal to s
+        auto output_geq = [&sums, &outputs, max_sum] (int s) {
+            return outputs.at(std::lower_bound(sums.begin(), sums.end(), std::min(s, max_sum)) - sums.begin()).second;
+        };
+        int nb_clauses (0);
+        // the sum is at least the sum of the inputs that are true
+        for (const std::pair<int,int> &p1 : outputs1) {
+            if (polarity == _POLARITY_DOWNWARD_)
+                break;
+            add_clause(-p1.second, output_geq(p1.first));
+            ++nb_clauses;
+        }
+        for (const std::pair<int,int> &p2 : outputs2) {
+            if (polarity == _POLARITY_DOWNWARD_)
+                break;
+            add_clause(-p2.second, output_geq(p2.first));
+            ++nb_clauses;
+            for (const std::pair<int,int> &p1 : outputs1) {
+                add_clause(-p1.second, -p2.second, output_geq(p1.first + p2.first));
+                ++nb_clauses;
+            }
+        }
+        // if the first sum is less than the (k+1)th value and the second less than the (l+1)th value
+        // then the sum is at most the sum of the kth and lth values
+        for (size_t k (0); k <= outputs1.size() && polarity != _POLARITY_UPWARD_; ++k) {
+            for (size_t l (0); l <= outputs2.size(); ++l) {
+                const int s1 (k == 0 ? 0 : outputs1.at(k - 1).first);
+                const int s2 (l == 0 ? 0 : outputs2.at(l - 1).first);
+                if (s1 + s2 >= sums.back()) // also if an input sum might be larger than max_sum
+                    continue;
+                Clause cl {-output_geq(s1 + s2 + 1)};
+                if (k < outputs1.size())
+                    cl.push_back(outputs1.at(k).second);
+                if (l < outputs2.size())
+                    cl.push_back(outputs2.at(l).second);
+                add_clause_enc(cl);
+                ++nb_clauses;
+            }
         }
+        // order encoding of the outputs
+        for (size_t k (1); k < outputs.size(); ++k) {
+            add_clause(-outputs.at(k).second, outputs.at(k - 1).second);
+            ++nb_clauses;
+        }
+        return nb_clauses;
+    }
+    
+    // returns the number of clauses of the generalized totalizer (sums are truncated at max_sum)
+    int Solver::encode_gte(const std::pair<int,int> elems_to_sort, const std::vector<int> &objective, GTE_OUT &outputs, int polarity, int max_sum)
+    {
+        const int size (elems_to_sort.second);
+        const int first_elem (elems_to_sort.first);
+        if (size == 0) {
+            outputs.clear();
+            return 0;
+        }
+        if (size == 1) {
+            const int var (objective.at(first_elem));
+            outputs.assign(1, std::make_pair(std::min(weight(var), max_sum), var));
+            return 0;
+        }
+        const int m (size/2);
+        GTE_OUT outputs1;
+        GTE_OUT outputs2;
+        int nb_clauses (encode_gte(std::make_pair(first_elem, m), objective, outputs1, polarity, max_sum));
+        nb_clauses += encode_gte(std::make_pair(first_elem + m, size - m), objective, outputs2, polarity, max_sum);
+        nb_clauses += gte_merge(outputs1, outputs2, outputs, polarity, max_sum);
+        return nb_clauses;
+    }
+    
+    /* sorted_vec has one entry per value of the sum, in decreasing order of value:
+     * the sum is at least values[k] iff sorted_vec[k] is true
+     */
+    void gte_to_sorted(const GTE_OUT &outputs, std::vector<int> &sorted_vec, std::vector<int> &values)
+    {
+        sorted_vec.resize(outputs.size());
+        values.resize(outputs.size());
+        for (size_t k (0); k < outputs.size(); ++k) {
+            sorted_vec.at(k) = outputs.at(outputs.size() - 1 - k).second;
+            values.at(k) = outputs.at(outputs.size() - 1 - k).first;
+        }
+    }
+    
+    void sorted_to_gte(const std::vector<int> &sorted_vec, const std::vector<int> &values, GTE_OUT &outputs)
+    {
+        outputs.resize(sorted_vec.size());
+        for (size_t k (0); k < sorted_vec.size(); ++k)
+            outputs.at(k) = std::make_pair(values.at(sorted_vec.size() - 1 - k), sorted_vec.at(sorted_vec.size() - 1 - k));
+    }
+    
+    // the values of the outputs of a sorting network: the sum is at least size - k iff output k is true
+    void unit_values(size_t size, std::vector<int> &values)
+    {
+        values.resize(size);
+        for (size_t k (0); k < size; ++k)
+            values.at(k) = size - k;
+    }
+    
+    // the outputs of a sorting network in ascending order of sum
+    void network_to_gte(const std::vector<int> &sorted_vec, GTE_OUT &outputs)
+    {
+        std::vector<int> values;
+        unit_values(sorted_vec.size(), values);
+        sorted_to_gte(sorted_vec, values, outputs);
+    }
+    
+    // sorts obj_vars with the encoding of the objective, returns the number of comparators (or clauses)
+    int Solver::sort_run(const std::vector<int> &obj_vars, int sorter, int polarity, GTE_OUT &run)
+    {
+        if (sorter == _SORTER_TOTALIZER_)
+            return encode_gte(std::make_pair(0, obj_vars.size()), obj_vars, run, polarity, weight_sum(obj_vars));
+        std::vector<int> sorted_vec;
+        int nb_comparators (0);
+        if (sorter == _SORTER_PAIRWISE_)
+            nb_comparators = encode_pairwise(obj_vars, sorted_vec, polarity);
+        else {
+            SNET sorting_network(obj_vars.size(), {-1,-1});
+            const std::pair<int,int> elems_to_sort(0, obj_vars.size());
+            nb_comparators = encode_network(elems_to_sort, &obj_vars, sorting_network, polarity);
+            for (const std::pair<int,int> &wire : sorting_network)
+                sorted_vec.push_back(wire.second);
+        }
+        network_to_gte(sorted_vec, run);
+        return nb_comparators;
+    }
+    
+    // merges two sorted runs into merged, returns the number of comparators (or clauses)
+    int Solver::merge_runs(const GTE_OUT &run1, const GTE_OUT &run2, int sorter, int polarity, GTE_OUT &merged)
+    {
+        if (m_verbosity == 2)
+            std::cout << "c Merging sorted runs of sizes " << run1.size() << " and " << run2.size() << '\n';
+        if (sorter == _SORTER_TOTALIZER_) {
+            // generalized totalizer node with the outputs of the runs as children
+            const int max_sum ((run1.empty() ? 0 : run1.back().first) + (run2.empty() ? 0 : run2.back().first));
+            return gte_merge(run1, run2, merged, polarity, max_sum);
+        }
+        const size_t size1 (run1.size());
+        const size_t size2 (run2.size());
+        SNET merge_network(size1 + size2, {-1,-1});
+        /* the first of the pair is the wire that is connected to i, through the last comparator
+         * in this case we don't know, so we put 0.
+         * we can put any value as long as it is different from -1.
+         * -1 is used for the case there is no comparator connecting wire i.
+         * The wires are in ascending order, that is, in decreasing order of sum.
+         */
+        for (size_t i (0); i < size1; ++i)
+            merge_network.at(i) = std::make_pair(0, run1.at(size1 - 1 - i).second);
+        for (size_t i (0); i < size2; ++i)
+            merge_network.at(size1 + i) = std::make_pair(0, run2.at(size2 - 1 - i).second);
+        const std::pair<std::pair<int, int>, int> seq1 (std::make_pair(0, size1), 1); // ((first wire, number of elements), offset)
+        const std::pair<std::pair<int, int>, int> seq2 (std::make_pair(size1, size2), 1);
+        // Since the sorting network has comparators connecting all wires, hence the nullptr. It is not used.
+        const int nb_comparators (odd_even_merge(seq1, seq2, nullptr, merge_network, polarity));
+        std::vector<int> sorted_vec (size1 + size2, 0);
+        for (size_t i (0); i < size1 + size2; ++i)
+            sorted_vec.at(i) = merge_network.at(i).second;
+        network_to_gte(sorted_vec, merged);
         return nb_comparators;
     }
     
-    /* Create a sorting network to sort the obj_vars
-     * Merge this sorting network with the old sorting network - the outputs are initially in sorted_vec
-     * sorted_vec is changed and set to the outputs of the new (larger) sorting network.
+    /* Sort the obj_vars and add them to the sorted vector.
+     * The sorted variables of each objective are kept in a forest of sorted runs (m_sorted_runs), where each run
+     * is more than twice as large as the next one. A new run is merged with the previous ones while their sizes
+     * are similar, so each variable goes through O(log n) merges and the depth of the network stays small.
+     * sorted_vec is set to the merge of all runs. The merges of the runs that did not change are kept
+     * (m_sorted_prefixes), so only the new (or merged) last run is merged into them.
      */
     void Solver::merge_core_guided(const std::vector<std::vector<int>> &inputs_to_sort, const std::vector<std::vector<int>> &unit_core_vars)
     {
+        // the sorted vectors of the core-guided search are only bounded from above
+        const int polarity (comparator_polarity(_POLARITY_UPWARD_));
+        if (polarity != _POLARITY_FULL_)
+            m_sorted_polarity = polarity; // the merged network only has the clauses of its weakest part
         for (size_t obj_index (0); obj_index < inputs_to_sort.size(); ++obj_index) {
             const std::vector<int> &obj_vars (inputs_to_sort.at(obj_index));
             if (obj_vars.size() > 0) {
                 if (m_verbosity >= 1)
                     std::cout << "c Increasing the " << ordinal(obj_index + 1) << " sorting network...\n";
+                std::vector<int> &sorted_vec = m_sorted_vecs.at(obj_index);
+                std::vector<int> &values = m_sorted_values.at(obj_index);
+                std::vector<GTE_OUT> &runs = m_sorted_runs.at(obj_index);
+                std::vector<GTE_OUT> &prefixes = m_sorted_prefixes.at(obj_index);
+                const int sorter (objective_sorter(obj_index));
+                // remove unit_core_vars from the end of sorted_vec
+                sorted_vec.resize(sorted_vec.size() - unit_core_vars.at(obj_index).size());
+                values.resize(sorted_vec.size());
+                for (int &value : values)
+                    value -= weight_sum(unit_core_vars.at(obj_index));
+                // the sorted vector of the disjoint cores presolving is the first run
+                if (runs.empty() && !sorted_vec.empty()) {
+                    runs.push_back(GTE_OUT());
+                    sorted_to_gte(sorted_vec, values, runs.back());
+                }
                 // Create a sorting network to sort the obj_vars
-                SNET sort_new_vars(obj_vars.size(), {-1,-1});
-                const std::pair<int,int> elems_to_sort(0, obj_vars.size());
                 if (m_verbosity == 2)
                     std::cout << "c Sorting the new variables\n";
+                runs.push_back(GTE_OUT());
                 // update sorting network info - nb wires and comparators
-                m_snet_info.at(obj_index).second += encode_network(elems_to_sort, &obj_vars, sort_new_vars);
+                m_snet_info.at(obj_index).second += sort_run(obj_vars, sorter, polarity, runs.back());
                 m_snet_info.at(obj_index).first += obj_vars.size();
-                // Merge
-                // the first old_size entries are equal to the old sorting network
-                std::vector<int> &sorted_vec = m_sorted_vecs.at(obj_index);
-                // remove unit_core_vars from the end of sorted_vec
-                for (size_t k (0); k < unit_core_vars.at(obj_index).size(); ++k)
-                    sorted_vec.pop_back();
-                const size_t old_size (sorted_vec.size());
-                SNET new_sort_net(old_size + obj_vars.size(), {-1,-1});
-                for (size_t i (0); i < old_size; ++i) {
-                    /* the first of the pair is the wire that is connected to i, through the last comparator
-                    * in this case we don't know, so we put 0.
-                    * we can put any value as long as it is different from -1.
-                    * -1 is used for the case there is no comparator connecting wire i.
-                    */
-                    new_sort_net.at(i).first = 0;
-                    // the second of the pair is the variable associated with the output of the last comparator of wire i.
-                    new_sort_net.at(i).second = sorted_vec.at(i);
+                // merge the runs of similar size
+                while (runs.size() > 1 && 2 * runs.back().size() > runs.at(runs.size() - 2).size()) {
+                    GTE_OUT merged;
+                    m_snet_info.at(obj_index).second += merge_runs(runs.at(runs.size() - 2), runs.back(), sorter, polarity, merged);
+                    runs.pop_back();
+                    runs.back().swap(merged);
                 }
-                // the last obj_vars.size() entries are equal to sort_new_vars
-                for (size_t i (old_size); i < old_size + obj_vars.size(); ++i) {
-                    new_sort_net.at(i) = sort_new_vars.at(i - old_size);
-                }
-                const std::pair<int, int> p1 (0, old_size);
-                const std::pair<int, int> p2 (old_size, obj_vars.size());
-                const std::pair<std::pair<int, int>, int> seq1 (p1, 1); // ((first wire, number of elements), offset)
-                const std::pair<std::pair<int, int>, int> seq2 (p2, 1);
                 if (m_verbosity == 2)
-                    std::cout << "c Merging the sorting networks\n";
-                // Since the sorting network has comparators connecting all wires, hence the nullptr. It is not used.
-                m_snet_info.at(obj_index).second += odd_even_merge(seq1, seq2, nullptr, new_sort_net); // also, update m_snet_info
-                // set sorted_vec to the outputs of new_sort_net
-                sorted_vec.resize(old_size + obj_vars.size());
-                for (size_t i (0); i < old_size + obj_vars.size(); ++i)
-                    sorted_vec.at(i) = new_sort_net.at(i).second;
+                    std::cout << "c Number of sorted runs: " << runs.size() << '\n';
+                // only the last run is new (or the result of merges), the merges of the previous runs are kept
+                prefixes.resize(std::min(prefixes.size(), runs.size() - 1));
+                while (prefixes.size() < runs.size()) {
+                    const GTE_OUT &run (runs.at(prefixes.size()));
+                    if (prefixes.empty())
+                        prefixes.push_back(run);
+                    else {
+                        GTE_OUT merged;
+                        m_snet_info.at(obj_index).second += merge_runs(prefixes.back(), run, sorter, polarity, merged);
+                        prefixes.push_back(merged);
+                    }
+                }
+                // set sorted_vec to the outputs of the merge of all runs
+                gte_to_sorted(prefixes.back(), sorted_vec, values);
                 add_unit_core_vars(unit_core_vars, obj_index);
             }
         }
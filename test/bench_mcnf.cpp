@@ -0,0 +1,84 @@
+/* Throughput of the MCNF parser: a random instance with nb_clauses hard clauses (first argument,
+ * default 4000000) and as many soft clauses in 3 objectives is written to a temporary file,
+ * uncompressed and gzipped, and parsed with leximaxIST::Mcnf (the mapped and the streamed path).
+ */
+#include <Mcnf.h>
+#include <zlib.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+    // parses file_name and checks the number of clauses, returns the MB/s of the decompressed bytes
+    double bench(const std::string &file_name, size_t nb_hard, size_t nb_soft, double &seconds)
+    {
+        leximaxIST::Mcnf mcnf (file_name);
+        size_t nb_parsed_soft (0);
+        for (const leximaxIST::ClauseArena &softs : mcnf.softs)
+            nb_parsed_soft += softs.size();
+        if (mcnf.hards.size() != nb_hard || nb_parsed_soft != nb_soft) {
+            std::cerr << "Wrong number of clauses in " << file_name << '\n';
+            exit(EXIT_FAILURE);
+        }
+        seconds = mcnf.parse_time;
+        return mcnf.nb_bytes / (1048576.0 * mcnf.parse_time);
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    const int nb_clauses (argc > 1 ? atoi(argv[1]) : 4000000);
+    const int nb_vars (nb_clauses / 4 + 1);
+    char file_name[] = "/tmp/bench_mcnfXXXXXX";
+    const int fd (mkstemp(file_name));
+    if (fd == -1) {
+        std::cerr << "Can't create a temporary file\n";
+        return 1;
+    }
+    close(fd);
+    const std::string gz_name (std::string(file_name) + ".gz");
+    FILE *out (fopen(file_name, "w"));
+    gzFile gz_out (gzopen(gz_name.c_str(), "wb1"));
+    std::mt19937 rng (12345);
+    std::string line;
+    char lit[16];
+    fprintf(out, "c generated by bench_mcnf\n");
+    for (int c (0); c < 2 * nb_clauses; ++c) {
+        line.clear();
+        if (c < nb_clauses)
+            line += "h";
+        else
+            line += "o" + std::to_string(1 + c % 3) + " " + std::to_string(1 + rng() % 10);
+        const int size (1 + rng() % 5);
+        for (int i (0); i < size; ++i) {
+            snprintf(lit, sizeof(lit), " %d", static_cast<int>((rng() & 1) ? 1 + rng() % nb_vars : -(1 + rng() % nb_vars)));
+            line += lit;
+        }
+        line += " 0\n";
+        fputs(line.c_str(), out);
+        gzputs(gz_out, line.c_str());
+    }
+    fclose(out);
+    gzclose(gz_out);
+    double seconds (0);
+    // the first parse also brings the file into the page cache
+    bench(file_name, nb_clauses, nb_clauses, seconds);
+    const double mapped (bench(file_name, nb_clauses, nb_clauses, seconds));
+    const double mapped_seconds (seconds);
+    const double streamed (bench(gz_name, nb_clauses, nb_clauses, seconds));
+    FILE *f (fopen(file_name, "rb"));
+    fseek(f, 0, SEEK_END);
+    const double megabytes (ftell(f) / 1048576.0);
+    fclose(f);
+    unlink(file_name);
+    unlink(gz_name.c_str());
+    std::cout << "bench_mcnf: " << 2 * nb_clauses << " clauses, " << megabytes << " MB\n";
+    std::cout << "  mapped:  " << mapped_seconds << " s (" << mapped << " MB/s)\n";
+    std::cout << "  gzipped: " << seconds << " s (" << streamed << " MB/s of decompressed input)\n";
+    return 0;
+}
@@ -0,0 +1,122 @@
+/* Throughput of the parsing of the output of an external solver: the 'v' lines of a model
+ * with nb_vars variables (first argument, default 10000000) are written to a temporary file and
+ * read with the whole-file FileBuffer (mapped as in Solver::read_solver_output, and read with zlib)
+ * and with the StreamBuffer of the original parser.
+ */
+#include <leximaxIST_parsing_utils.h>
+#include <zlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+    // same loop as Solver::read_sat_output, returns the sum of the literals
+    template<class B>
+    long long read_model(B &r)
+    {
+        long long sum (0);
+        while (*r != EOF) {
+            if (*r != 'v') {
+                leximaxIST::skipLine(r);
+                continue;
+            }
+            ++r; // skip 'v'
+            while (*r != '\n' && *r != EOF && *r != '\r') {
+                leximaxIST::skipTrueWhitespace(r);
+                if (*r != '-' && (*r < '0' || *r > '9'))
+                    break;
+                sum += leximaxIST::parseInt(r);
+            }
+            ++r; // skip '\n'
+        }
+        return sum;
+    }
+
+    // reads the model with a B built on the gzFile of the file
+    template<class B>
+    long long read_gz(const char *file_name)
+    {
+        gzFile in (gzopen(file_name, "rb"));
+        if (in == Z_NULL) {
+            std::cerr << "Can't open " << file_name << '\n';
+            exit(EXIT_FAILURE);
+        }
+        long long sum (0);
+        {
+            B r (in);
+            sum = read_model(r);
+        }
+        gzclose(in);
+        return sum;
+    }
+
+    // reads the model with a FileBuffer that maps the file
+    long long read_mapped(const char *file_name)
+    {
+        const int fd (open(file_name, O_RDONLY));
+        if (fd == -1) {
+            std::cerr << "Can't open " << file_name << '\n';
+            exit(EXIT_FAILURE);
+        }
+        leximaxIST::FileBuffer r (fd);
+        return read_model(r);
+    }
+
+    double bench(long long (*read)(const char*), const char *file_name, long long expected)
+    {
+        const std::chrono::steady_clock::time_point start (std::chrono::steady_clock::now());
+        const long long sum (read(file_name));
+        const std::chrono::duration<double> elapsed (std::chrono::steady_clock::now() - start);
+        if (sum != expected) {
+            std::cerr << "Wrong sum of the literals: " << sum << " instead of " << expected << '\n';
+            exit(EXIT_FAILURE);
+        }
+        return elapsed.count();
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    const int nb_vars (argc > 1 ? atoi(argv[1]) : 10000000);
+    char file_name[] = "/tmp/bench_parserXXXXXX";
+    const int fd (mkstemp(file_name));
+    if (fd == -1) {
+        std::cerr << "Can't create a temporary file\n";
+        return 1;
+    }
+    FILE *out (fdopen(fd, "w"));
+    std::mt19937 rng (12345);
+    long long expected (0);
+    fprintf(out, "c generated by bench_parser\ns OPTIMUM FOUND\no 42\n");
+    for (int v (1); v <= nb_vars; ++v) {
+        const int lit ((rng() & 1) ? v : -v);
+        expected += lit;
+        fprintf(out, (v % 20 == 1) ? "v %d" : " %d", lit);
+        if (v % 20 == 0 || v == nb_vars)
+            fputc('\n', out);
+    }
+    fclose(out);
+    FILE *f (fopen(file_name, "rb"));
+    fseek(f, 0, SEEK_END);
+    const double megabytes (ftell(f) / 1048576.0);
+    fclose(f);
+    // the first read also brings the file into the page cache
+    bench(read_mapped, file_name, expected);
+    const double t_mapped (bench(read_mapped, file_name, expected));
+    // as for a gzipped output, whose size is not known
+    const double t_read (bench(read_gz<leximaxIST::FileBuffer>, file_name, expected));
+    const double t_stream (bench(read_gz<leximaxIST::StreamBuffer>, file_name, expected));
+    unlink(file_name);
+    std::cout << "bench_parser: " << nb_vars << " variables, " << megabytes << " MB\n";
+    std::cout << "  FileBuffer (mapped): " << t_mapped << " s (" << megabytes / t_mapped << " MB/s)\n";
+    std::cout << "  FileBuffer (gzread): " << t_read << " s (" << megabytes / t_read << " MB/s)\n";
+    std::cout << "  StreamBuffer:        " << t_stream << " s (" << megabytes / t_stream << " MB/s)\n";
+    return 0;
+}
@@ -0,0 +1,76 @@
+/* Throughput of the writers of the input files of the external solvers: a random instance with
+ * nb_clauses hard clauses (first argument, default 1000000) and 3 objectives is solved in the
+ * external mode with each format (wcnf, opb and lp), uncompressed and gzipped, and the
+ * "c Solver input" line of the solver gives the bytes written and the MB/s of each writer.
+ * The external solver command is 'true', so the solver stops after writing the first instance.
+ */
+#include <leximaxIST_Solver.h>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // solves the instance with the given format and returns the "c Solver input" line of the log
+    std::string bench(const leximaxIST::ClauseArena &hard, const std::vector<std::vector<leximaxIST::Clause>> &objs,
+                      const std::string &format, bool gzip)
+    {
+        leximaxIST::Solver solver;
+        solver.add_hard_clauses(hard);
+        for (const std::vector<leximaxIST::Clause> &soft_clauses : objs)
+            solver.add_soft_clauses(soft_clauses);
+        solver.set_opt_mode("external");
+        solver.set_formalism(format);
+        if (format == "lp")
+            solver.set_ilp_solver("cplex");
+        solver.set_ext_solver_cmd("true");
+        solver.set_gzip_input(gzip);
+        solver.set_verbosity(1);
+        std::ostringstream log;
+        std::streambuf *cout_buf (std::cout.rdbuf(log.rdbuf()));
+        solver.optimise();
+        std::cout.rdbuf(cout_buf);
+        std::istringstream lines (log.str());
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.compare(0, 16, "c Solver input: ") == 0)
+                return line.substr(16);
+        }
+        std::cerr << "No instance was written in the " << format << " format\n";
+        exit(EXIT_FAILURE);
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    const int nb_clauses (argc > 1 ? atoi(argv[1]) : 1000000);
+    const int nb_vars (nb_clauses / 4 + 1);
+    std::mt19937 rng (12345);
+    leximaxIST::ClauseArena hard;
+    leximaxIST::Clause clause;
+    for (int c (0); c < nb_clauses; ++c) {
+        clause.clear();
+        const int size (1 + rng() % 5);
+        for (int i (0); i < size; ++i) {
+            const int var (1 + rng() % nb_vars);
+            // the first literal is positive, so the SAT solver finds a model at once
+            clause.push_back((i == 0 || (rng() & 1)) ? var : -var);
+        }
+        hard.push_back(clause);
+    }
+    // small objectives, so the sorting networks do not dominate the instance
+    std::vector<std::vector<leximaxIST::Clause>> objs (3);
+    for (int i (0); i < 3; ++i) {
+        for (int j (0); j < 200; ++j)
+            objs[i].push_back(leximaxIST::Clause(1, 1 + rng() % nb_vars));
+    }
+    std::cout << "bench_writer: " << nb_clauses << " hard clauses\n";
+    for (const std::string format : {"wcnf", "opb", "lp"}) {
+        std::cout << "  " << format << ":    " << bench(hard, objs, format, false) << '\n';
+        std::cout << "  " << format << ".gz: " << bench(hard, objs, format, true) << '\n';
+    }
+    return 0;
+}
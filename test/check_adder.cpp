@@ -0,0 +1,127 @@
+/* Checks the Adder PB encoding: for every assignment of the input variables of a
+ * random constraint sum coeffs[i] * lits[i] <= rhs, the CNF must be satisfiable
+ * iff the assignment satisfies the constraint. Some coefficients are larger than rhs.
+ */
+#include <Enc_Adder.h>
+#include <ClauseBuffer.h>
+#include <leximaxIST_ClauseArena.h>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+    // DPLL on a small CNF; values[v] is 1, -1 or 0 (unassigned)
+    bool satisfiable(const leximaxIST::ClauseArena &cnf, std::vector<int> &values)
+    {
+        bool propagated (true);
+        std::vector<int> trail;
+        while (propagated) {
+            propagated = false;
+            for (leximaxIST::ClauseRef cl : cnf) {
+                int nb_free (0);
+                int free_lit (0);
+                bool sat (false);
+                for (int lit : cl) {
+                    const int val (lit > 0 ? values[lit] : -values[-lit]);
+                    if (val == 1) {
+                        sat = true;
+                        break;
+                    }
+                    if (val == 0) {
+                        ++nb_free;
+                        free_lit = lit;
+                    }
+                }
+                if (sat)
+                    continue;
+                if (nb_free == 0) {
+                    for (int var : trail)
+                        values[var] = 0;
+                    return false;
+                }
+                if (nb_free == 1) {
+                    const int var (std::abs(free_lit));
+                    values[var] = free_lit > 0 ? 1 : -1;
+                    trail.push_back(var);
+                    propagated = true;
+                }
+            }
+        }
+        int var (1);
+        while (var < (int) values.size() && values[var] != 0)
+            ++var;
+        bool result (var == (int) values.size());
+        for (int val (1); !result && val >= -1; val -= 2) {
+            values[var] = val;
+            result = satisfiable(cnf, values);
+            values[var] = 0;
+        }
+        for (int v : trail)
+            values[v] = 0;
+        return result;
+    }
+
+    // returns the number of assignments where the encoding is wrong
+    int check_constraint(const std::vector<int> &lits, const std::vector<uint64_t> &coeffs, uint64_t rhs)
+    {
+        const int n (lits.size());
+        leximaxIST::ClauseBuffer buffer (n);
+        leximaxIST::Adder adder;
+        std::vector<int> enc_lits (lits);
+        std::vector<uint64_t> enc_coeffs (coeffs);
+        adder.encode(buffer, enc_lits, enc_coeffs, rhs);
+        int nb_wrong (0);
+        for (int a (0); a < (1 << n); ++a) {
+            std::vector<int> values (n + buffer.nb_fresh() + 1, 0);
+            uint64_t sum (0);
+            for (int i (0); i < n; ++i) {
+                const bool true_var (a & (1 << i));
+                values[i + 1] = true_var ? 1 : -1;
+                if (true_var == (lits[i] > 0))
+                    sum += coeffs[i];
+            }
+            if (satisfiable(buffer.clauses(), values) != (sum <= rhs))
+                ++nb_wrong;
+        }
+        return nb_wrong;
+    }
+
+}
+
+int main()
+{
+    int nb_fails (0);
+    // 3 x1 + x2 + x3 <= 2: x1 must be false
+    nb_fails += check_constraint({1, 2, 3}, {3, 1, 1}, 2) != 0;
+    // a coefficient above rhs with a bit that rhs does not have
+    nb_fails += check_constraint({1, 2, 3, -4}, {9, 2, 3, 1}, 4) != 0;
+    std::mt19937 gen (12345);
+    for (int t (0); t < 500; ++t) {
+        const int n (1 + gen() % 7);
+        std::vector<int> lits;
+        std::vector<uint64_t> coeffs;
+        uint64_t total (0);
+        for (int i (0); i < n; ++i) {
+            lits.push_back(gen() % 2 ? i + 1 : -(i + 1));
+            coeffs.push_back(gen() % 12);
+            total += coeffs.back();
+        }
+        const uint64_t rhs (1 + gen() % (total + 1));
+        if (check_constraint(lits, coeffs, rhs) != 0) {
+            ++nb_fails;
+            std::cerr << "Wrong Adder encoding of:";
+            for (int i (0); i < n; ++i)
+                std::cerr << " +" << coeffs[i] << (lits[i] > 0 ? " x" : " ~x") << std::abs(lits[i]);
+            std::cerr << " <= " << rhs << '\n';
+        }
+    }
+    if (nb_fails != 0) {
+        std::cerr << "check_adder: " << nb_fails << " wrong encodings\n";
+        return 1;
+    }
+    std::cout << "check_adder: OK\n";
+    return 0;
+}
@@ -0,0 +1,40 @@
+/* Checks that the encoding of the PB and cardinality constraints does not depend on the
+ * number of threads: a random instance with several batches of constraints is encoded with
+ * 1 and with more threads, with each encoding, and the clauses given to the solver
+ * (the snapshots) must be the same.
+ */
+#include "opb_snapshot.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main()
+{
+    const std::string file_name (opb_snapshot::temp_file("check_encode_threads"));
+    // about 275000 literals, i.e. 5 batches of FormulaEncoder
+    opb_snapshot::generate_opb(file_name, 2000, 50000, 3, 12345);
+    const std::vector<std::pair<int, int>> encodings {
+        {leximaxIST::_PB_AUTO_, leximaxIST::_CARD_AUTO_},
+        {leximaxIST::_PB_SWC_, leximaxIST::_CARD_TOTALIZER_},
+        {leximaxIST::_PB_GTE_, leximaxIST::_CARD_CNETWORKS_},
+        {leximaxIST::_PB_ADDER_, leximaxIST::_CARD_MTOTALIZER_}
+    };
+    int nb_fails (0);
+    for (const std::pair<int, int> &enc : encodings) {
+        const std::vector<char> expected (opb_snapshot::snapshot(file_name, 1, 1, enc.first, enc.second));
+        for (int nb_threads : {3, 8}) {
+            if (opb_snapshot::snapshot(file_name, 1, nb_threads, enc.first, enc.second) != expected) {
+                ++nb_fails;
+                std::cerr << "Different clauses with " << nb_threads << " threads, PB encoding " << enc.first;
+                std::cerr << " and cardinality encoding " << enc.second << '\n';
+            }
+        }
+    }
+    unlink(file_name.c_str());
+    if (nb_fails != 0) {
+        std::cerr << "check_encode_threads: " << nb_fails << " different encodings\n";
+        return 1;
+    }
+    std::cout << "check_encode_threads: OK\n";
+    return 0;
+}
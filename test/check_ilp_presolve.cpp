@@ -0,0 +1,119 @@
+/* Checks the ILP algorithm with the ILP solver Cbc linked into leximaxIST, with and without the
+ * MaxSAT presolve (whose totalizers are in the encoding when the ILP model is built): the optimal
+ * objective vector of small random weighted instances must be the one found by brute force.
+ * Only built with 'make CBC=1 check'.
+ */
+#include <leximaxIST_Solver.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    const int nb_vars (8);
+
+    struct Instance {
+        std::vector<leximaxIST::Clause> hard;
+        std::vector<std::vector<std::pair<uint64_t, leximaxIST::Clause>>> objectives;
+    };
+
+    Instance generate(unsigned seed)
+    {
+        std::mt19937 gen (seed);
+        auto random_clause = [&](int max_size) {
+            leximaxIST::Clause cl;
+            const int size (1 + gen() % max_size);
+            for (int k (0); k < size; ++k) {
+                const int var (1 + gen() % nb_vars);
+                cl.push_back((gen() & 1) ? var : -var);
+            }
+            return cl;
+        };
+        Instance instance;
+        for (int c (0); c < 10; ++c)
+            instance.hard.push_back(random_clause(3));
+        instance.objectives.resize(2 + gen() % 3);
+        for (std::vector<std::pair<uint64_t, leximaxIST::Clause>> &objective : instance.objectives) {
+            for (int j (0); j < 4; ++j)
+                objective.push_back(std::make_pair(1 + gen() % 5, random_clause(2)));
+        }
+        return instance;
+    }
+
+    bool satisfied(const leximaxIST::Clause &cl, unsigned assignment)
+    {
+        for (int l : cl) {
+            if (((assignment >> (std::abs(l) - 1)) & 1) == (l > 0 ? 1u : 0u))
+                return true;
+        }
+        return false;
+    }
+
+    // leximax-optimal sorted objective vector, empty if the hard clauses are unsatisfiable
+    std::vector<int> brute_force(const Instance &instance)
+    {
+        std::vector<int> best;
+        for (unsigned a (0); a < (1u << nb_vars); ++a) {
+            if (!std::all_of(instance.hard.begin(), instance.hard.end(),
+                             [a](const leximaxIST::Clause &cl) { return satisfied(cl, a); }))
+                continue;
+            std::vector<int> obj_vec;
+            for (const std::vector<std::pair<uint64_t, leximaxIST::Clause>> &objective : instance.objectives) {
+                int value (0);
+                for (const std::pair<uint64_t, leximaxIST::Clause> &soft : objective)
+                    value += satisfied(soft.second, a) ? 0 : soft.first;
+                obj_vec.push_back(value);
+            }
+            std::sort(obj_vec.begin(), obj_vec.end(), std::greater<int>());
+            if (best.empty() || obj_vec < best)
+                best = obj_vec;
+        }
+        return best;
+    }
+
+    std::vector<int> solve(const Instance &instance, bool presolve)
+    {
+        leximaxIST::Solver solver;
+        for (const leximaxIST::Clause &cl : instance.hard)
+            solver.add_hard_clause(cl);
+        for (const std::vector<std::pair<uint64_t, leximaxIST::Clause>> &objective : instance.objectives)
+            solver.add_soft_clauses(objective);
+        solver.set_opt_mode("ilp");
+        solver.set_ilp_solver("cbc");
+        solver.set_maxsat_presolve(presolve);
+        solver.optimise();
+        std::vector<int> obj_vec (solver.get_objective_vector());
+        std::sort(obj_vec.begin(), obj_vec.end(), std::greater<int>());
+        return obj_vec;
+    }
+
+}
+
+int main()
+{
+    int nb_fails (0);
+    for (unsigned seed (0); seed < 30; ++seed) {
+        const Instance instance (generate(seed));
+        const std::vector<int> expected (brute_force(instance));
+        if (expected.empty())
+            continue;
+        for (bool presolve : {false, true}) {
+            if (solve(instance, presolve) != expected) {
+                ++nb_fails;
+                std::cerr << "Wrong optimum of seed " << seed << (presolve ? " with" : " without");
+                std::cerr << " the MaxSAT presolve\n";
+            }
+        }
+    }
+    if (nb_fails != 0) {
+        std::cerr << "check_ilp_presolve: " << nb_fails << " wrong optima\n";
+        return 1;
+    }
+    std::cout << "check_ilp_presolve: OK\n";
+    return 0;
+}
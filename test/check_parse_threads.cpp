@@ -0,0 +1,85 @@
+/* Checks that the parsing of OPB files does not depend on the number of threads: a random
+ * instance large enough to be parsed in chunks is parsed with 1 and with more threads, and
+ * the formulas (variables and their names, constraints and objectives) must be the same.
+ */
+#include "opb_snapshot.h"
+#include <sys/stat.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // the first difference between the formulas, empty if they are the same
+    std::string difference(leximaxIST::MaxSATFormula &f, leximaxIST::MaxSATFormula &g)
+    {
+        if (f.nVars() != g.nVars())
+            return "number of variables";
+        if (f.getIndexToName() != g.getIndexToName())
+            return "names of the variables";
+        if (f.nHard() != g.nHard())
+            return "number of clauses";
+        for (int i (0); i < f.nHard(); ++i) {
+            if (f.getHardClause(i).clause != g.getHardClause(i).clause)
+                return "clause " + std::to_string(i);
+        }
+        if (f.nPB() != g.nPB())
+            return "number of PB constraints";
+        for (int i (0); i < f.nPB(); ++i) {
+            const leximaxIST::PB &p (f.getPBConstraint(i));
+            const leximaxIST::PB &q (g.getPBConstraint(i));
+            if (p._lits != q._lits || p._coeffs != q._coeffs || p._rhs != q._rhs || p._sign != q._sign)
+                return "PB constraint " + std::to_string(i);
+        }
+        if (f.nCard() != g.nCard())
+            return "number of cardinality constraints";
+        for (int i (0); i < f.nCard(); ++i) {
+            const leximaxIST::Card &c (f.getCardinalityConstraint(i));
+            const leximaxIST::Card &d (g.getCardinalityConstraint(i));
+            if (c._lits != d._lits || c._rhs != d._rhs)
+                return "cardinality constraint " + std::to_string(i);
+        }
+        if (f.nObjFunctions() != g.nObjFunctions())
+            return "number of objectives";
+        for (int i (0); i < f.nObjFunctions(); ++i) {
+            const leximaxIST::PBObjFunction &o (f.getObjFunction(i));
+            const leximaxIST::PBObjFunction &p (g.getObjFunction(i));
+            if (o._lits != p._lits || o._coeffs != p._coeffs || o._const != p._const)
+                return "objective " + std::to_string(i);
+        }
+        return "";
+    }
+
+}
+
+int main()
+{
+    const std::string file_name (opb_snapshot::temp_file("check_parse_threads"));
+    // ParserPB only splits files of at least 16 MB
+    opb_snapshot::generate_opb(file_name, 50000, 360000, 3, 54321);
+    struct stat st;
+    if (stat(file_name.c_str(), &st) != 0 || st.st_size < (1 << 24)) {
+        std::cerr << "check_parse_threads: the instance is too small to be parsed in chunks\n";
+        unlink(file_name.c_str());
+        return 1;
+    }
+    leximaxIST::MaxSATFormula expected;
+    leximaxIST::ParserPB (&expected, 1).parse(file_name.c_str());
+    int nb_fails (0);
+    for (int nb_threads : {2, 3, 8}) {
+        leximaxIST::MaxSATFormula formula;
+        leximaxIST::ParserPB (&formula, nb_threads).parse(file_name.c_str());
+        const std::string diff (difference(expected, formula));
+        if (!diff.empty()) {
+            ++nb_fails;
+            std::cerr << "Different " << diff << " with " << nb_threads << " threads\n";
+        }
+    }
+    unlink(file_name.c_str());
+    if (nb_fails != 0) {
+        std::cerr << "check_parse_threads: " << nb_fails << " different formulas\n";
+        return 1;
+    }
+    std::cout << "check_parse_threads: OK\n";
+    return 0;
+}
@@ -0,0 +1,60 @@
+/* Checks the predicted sizes of the PB encodings, which choose the encoding of each constraint
+ * with --pb-enc auto: for random constraints sum coeffs[i] * lits[i] <= rhs (some coefficients
+ * larger than rhs), the numbers of clauses and of fresh variables predicted for SWC, GTE and the
+ * Adder must be those of the encoding.
+ */
+#include <Encoder.h>
+#include <ClauseBuffer.h>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+int main()
+{
+    const std::vector<std::pair<int, std::string>> encodings {
+        {leximaxIST::_PB_SWC_, "SWC"}, {leximaxIST::_PB_GTE_, "GTE"}, {leximaxIST::_PB_ADDER_, "Adder"}
+    };
+    int nb_fails (0);
+    std::mt19937 gen (24680);
+    for (int t (0); t < 3000; ++t) {
+        const int n (2 + gen() % 20);
+        std::vector<int> lits;
+        std::vector<uint64_t> coeffs;
+        uint64_t total (0);
+        for (int i (0); i < n; ++i) {
+            lits.push_back(gen() % 2 ? i + 1 : -(i + 1));
+            coeffs.push_back(1 + gen() % 20);
+            total += coeffs.back();
+        }
+        const uint64_t rhs (1 + gen() % total);
+        for (const std::pair<int, std::string> &enc : encodings) {
+            int nb_vars (0);
+            leximaxIST::Encoder predictor (leximaxIST::_INCREMENTAL_NONE_, leximaxIST::_CARD_TOTALIZER_,
+                                           leximaxIST::_AMO_LADDER_, enc.first);
+            const int nb_clauses (predictor.predictPB(lits, coeffs, rhs, &nb_vars));
+            leximaxIST::ClauseBuffer buffer (n);
+            leximaxIST::Encoder encoder (leximaxIST::_INCREMENTAL_NONE_, leximaxIST::_CARD_TOTALIZER_,
+                                         leximaxIST::_AMO_LADDER_, enc.first);
+            std::vector<int> enc_lits (lits);
+            std::vector<uint64_t> enc_coeffs (coeffs);
+            encoder.encodePB(buffer, enc_lits, enc_coeffs, rhs);
+            if (nb_clauses != static_cast<int>(buffer.nb_clauses()) || nb_vars != buffer.nb_fresh()) {
+                ++nb_fails;
+                std::cerr << enc.second << " predicted " << nb_clauses << " clauses and " << nb_vars;
+                std::cerr << " variables instead of " << buffer.nb_clauses() << " and " << buffer.nb_fresh() << " for:";
+                for (int i (0); i < n; ++i)
+                    std::cerr << " +" << coeffs[i] << (lits[i] > 0 ? " x" : " ~x") << std::abs(lits[i]);
+                std::cerr << " <= " << rhs << '\n';
+            }
+        }
+    }
+    if (nb_fails != 0) {
+        std::cerr << "check_predict: " << nb_fails << " wrong predictions\n";
+        return 1;
+    }
+    std::cout << "check_predict: OK\n";
+    return 0;
+}
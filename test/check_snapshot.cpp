@@ -0,0 +1,143 @@
+/* Checks the snapshots of Solver::write_snapshot and Solver::read_snapshot: the snapshot of a
+ * random OPB instance is read into a new solver and written again, and the two snapshots (clauses,
+ * objective functions and weights) must be the same. A small weighted instance must have the same
+ * optimal objective vector before and after the round trip, also with the objective variables
+ * in another order (so they are not consecutive any more), and read_snapshot must reject
+ * snapshots with a zero weight or with an objective whose sum of weights exceeds INT_MAX.
+ */
+#include "opb_snapshot.h"
+#include <sys/wait.h>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    void write_bytes(const std::string &file_name, const std::vector<char> &bytes)
+    {
+        std::ofstream out (file_name, std::ios::binary);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    // the snapshot of a solver that read file_name
+    std::vector<char> round_trip(const std::string &file_name)
+    {
+        leximaxIST::Solver solver;
+        solver.read_snapshot(file_name);
+        const std::string copy_name (opb_snapshot::temp_file("check_snapshot"));
+        solver.write_snapshot(copy_name);
+        std::ifstream in (copy_name, std::ios::binary);
+        std::vector<char> bytes ((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        unlink(copy_name.c_str());
+        return bytes;
+    }
+
+    // true if read_snapshot rejects bytes, i.e. the process that reads them exits with EXIT_FAILURE
+    bool rejected(const std::string &file_name, const std::vector<char> &bytes)
+    {
+        write_bytes(file_name, bytes);
+        const pid_t pid (fork());
+        if (pid == 0) {
+            const int null_fd (open("/dev/null", O_WRONLY));
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+            leximaxIST::Solver solver;
+            solver.read_snapshot(file_name);
+            _exit(0);
+        }
+        int status (0);
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE;
+    }
+
+    /* swaps the first two variables of the first objective, and their weights, in a snapshot with
+     * nb_obj_vars objective variables: the obj_vars and obj_weights sections are at the end of the file
+     */
+    std::vector<char> with_swapped_vars(std::vector<char> bytes, size_t nb_obj_vars)
+    {
+        char *weights (bytes.data() + bytes.size() - nb_obj_vars * sizeof(uint64_t));
+        char *vars (weights - ((nb_obj_vars * sizeof(int32_t) + 7) & ~static_cast<size_t>(7)));
+        std::swap_ranges(vars, vars + sizeof(int32_t), vars + sizeof(int32_t));
+        std::swap_ranges(weights, weights + sizeof(uint64_t), weights + sizeof(uint64_t));
+        return bytes;
+    }
+
+    // bytes with the weight of the last objective variable (the last 8 bytes of a snapshot) set to w
+    std::vector<char> with_last_weight(std::vector<char> bytes, uint64_t w)
+    {
+        memcpy(bytes.data() + bytes.size() - sizeof(w), &w, sizeof(w));
+        return bytes;
+    }
+
+}
+
+int main()
+{
+    int nb_fails (0);
+    const std::string opb_name (opb_snapshot::temp_file("check_snapshot"));
+    const std::string snapshot_name (opb_snapshot::temp_file("check_snapshot"));
+    opb_snapshot::generate_opb(opb_name, 2000, 20000, 3, 2468);
+    const std::vector<char> expected (opb_snapshot::snapshot(opb_name, 1, 1, leximaxIST::_PB_AUTO_, leximaxIST::_CARD_AUTO_));
+    unlink(opb_name.c_str());
+    write_bytes(snapshot_name, expected);
+    if (round_trip(snapshot_name) != expected) {
+        ++nb_fails;
+        std::cerr << "Different snapshot after reading and writing it\n";
+    }
+    // small weighted instance, solved before and after the round trip
+    std::vector<int> obj_vector;
+    std::vector<char> small_snapshot;
+    for (int run (0); run < 3; ++run) {
+        leximaxIST::Solver solver;
+        if (run == 0) {
+            const std::vector<leximaxIST::Clause> hard {{1, 2, 3}, {-1, -2}, {-2, -3}, {4, 5}};
+            for (const leximaxIST::Clause &cl : hard)
+                solver.add_hard_clause(cl);
+            const std::vector<std::pair<uint64_t, leximaxIST::Clause>> soft_1 {{3, {-1}}, {2, {-4}}, {1, {-5}}};
+            const std::vector<std::pair<uint64_t, leximaxIST::Clause>> soft_2 {{4, {-2}}, {1, {-3}}, {2, {-5}}};
+            solver.add_soft_clauses(soft_1);
+            solver.add_soft_clauses(soft_2);
+            solver.write_snapshot(snapshot_name);
+            std::ifstream in (snapshot_name, std::ios::binary);
+            small_snapshot.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        else {
+            if (run == 2)
+                write_bytes(snapshot_name, with_swapped_vars(small_snapshot, 6));
+            solver.read_snapshot(snapshot_name);
+        }
+        solver.optimise();
+        if (run == 0)
+            obj_vector = solver.get_objective_vector();
+        else if (solver.get_objective_vector() != obj_vector) {
+            ++nb_fails;
+            std::cerr << "Different optimal objective vector after reading the snapshot";
+            std::cerr << (run == 2 ? " with non consecutive objective variables\n" : "\n");
+        }
+    }
+    if (!rejected(snapshot_name, with_last_weight(expected, 0))) {
+        ++nb_fails;
+        std::cerr << "A zero weight was accepted\n";
+    }
+    for (uint64_t w : {static_cast<uint64_t>(INT_MAX), UINT64_MAX}) {
+        if (!rejected(snapshot_name, with_last_weight(expected, w))) {
+            ++nb_fails;
+            std::cerr << "An objective with the weight " << w << " was accepted\n";
+        }
+    }
+    if (rejected(snapshot_name, expected)) {
+        ++nb_fails;
+        std::cerr << "A valid snapshot was rejected\n";
+    }
+    unlink(snapshot_name.c_str());
+    if (nb_fails != 0) {
+        std::cerr << "check_snapshot: " << nb_fails << " failed checks\n";
+        return 1;
+    }
+    std::cout << "check_snapshot: OK\n";
+    return 0;
+}
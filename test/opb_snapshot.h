@@ -0,0 +1,115 @@
+/* Helpers of the checks of the OPB front end: a random PBMO instance generator, and the
+ * snapshot of the instance that the command line tool gives to the solver, i.e. the
+ * parsed hard clauses, the encoded PB and cardinality constraints and the objectives,
+ * as written by Solver::write_snapshot. Two runs gave the solver the same instance iff
+ * their snapshots have the same bytes.
+ */
+#ifndef OPB_SNAPSHOT_H
+#define OPB_SNAPSHOT_H
+
+#include <leximaxIST_Solver.h>
+#include <ParserPB.h>
+#include <FormulaEncoder.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace opb_snapshot {
+
+    // name of a new temporary file
+    inline std::string temp_file(const std::string &prefix)
+    {
+        std::string name ("/tmp/" + prefix + "XXXXXX");
+        const int fd (mkstemp(&name[0]));
+        if (fd == -1) {
+            std::cerr << "Can't create a temporary file\n";
+            exit(EXIT_FAILURE);
+        }
+        close(fd);
+        return name;
+    }
+
+    /* writes nb_constraints random constraints over nb_vars variables and nb_objectives objectives:
+     * PB constraints (<=, >= and =, some coefficients larger than the rhs), cardinality constraints
+     * and at-most-one constraints, with negated literals (and no variable twice in a constraint)
+     */
+    inline void generate_opb(const std::string &file_name, int nb_vars, int nb_constraints, int nb_objectives,
+                             unsigned seed)
+    {
+        std::mt19937 gen (seed);
+        FILE *out (fopen(file_name.c_str(), "w"));
+        if (out == nullptr) {
+            std::cerr << "Can't write " << file_name << '\n';
+            exit(EXIT_FAILURE);
+        }
+        fprintf(out, "* #variable= %d #constraint= %d\n", nb_vars, nb_constraints);
+        for (int o (0); o < nb_objectives; ++o) {
+            fprintf(out, "min:");
+            for (int v (1 + o); v <= nb_vars; v += nb_objectives)
+                fprintf(out, " +%d x%d", static_cast<int>(1 + gen() % 5), v);
+            fprintf(out, " ;\n");
+        }
+        const char *signs[3] = {"<=", ">=", "="};
+        for (int c (0); c < nb_constraints; ++c) {
+            const int kind (gen() % 3); // 0 - PB, 1 - cardinality, 2 - at most one
+            const int size (2 + gen() % 8);
+            std::vector<int> vars;
+            while (static_cast<int>(vars.size()) < size) {
+                const int var (1 + gen() % nb_vars);
+                if (std::find(vars.begin(), vars.end(), var) == vars.end())
+                    vars.push_back(var);
+            }
+            int total (0);
+            for (int var : vars) {
+                const int coeff (kind == 0 ? 1 + gen() % 5 : 1);
+                total += coeff;
+                fprintf(out, "+%d %sx%d ", coeff, (gen() % 4 == 0) ? "~" : "", var);
+            }
+            if (kind == 2)
+                fprintf(out, "<= 1 ;\n");
+            else
+                fprintf(out, "%s %d ;\n", signs[gen() % 3], static_cast<int>(1 + gen() % total));
+        }
+        fclose(out);
+    }
+
+    // the snapshot of the instance of file_name, as built by the command line tool
+    inline std::vector<char> snapshot(const std::string &file_name, int parse_threads, int encode_threads,
+                                      int pb_enc, int card_enc)
+    {
+        leximaxIST::Solver solver;
+        leximaxIST::MaxSATFormula maxsat_formula;
+        leximaxIST::ParserPB parser_pb (&maxsat_formula, parse_threads);
+        parser_pb.parse(file_name.c_str());
+        for (size_t pos (0); pos < maxsat_formula.nHard(); ++pos) {
+            std::vector<int> hc (maxsat_formula.getHardClause(pos).clause);
+            solver.add_hard_clause(hc);
+        }
+        solver.reserve_vars(maxsat_formula.nVars());
+        leximaxIST::FormulaEncoder formula_encoder (&maxsat_formula, pb_enc, card_enc, encode_threads);
+        formula_encoder.encode(solver);
+        for (int i (0); i < maxsat_formula.nObjFunctions(); ++i) {
+            std::vector<std::pair<uint64_t, leximaxIST::Clause>> soft_clauses;
+            const leximaxIST::PBObjFunction &obj (maxsat_formula.getObjFunction(i));
+            for (size_t j (0); j < obj._lits.size(); ++j)
+                soft_clauses.push_back(std::make_pair(obj._coeffs.at(j), leximaxIST::Clause(1, -obj._lits.at(j))));
+            solver.add_soft_clauses(soft_clauses);
+        }
+        const std::string snapshot_name (temp_file("opb_snapshot"));
+        solver.write_snapshot(snapshot_name);
+        std::ifstream in (snapshot_name, std::ios::binary);
+        std::vector<char> bytes ((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        unlink(snapshot_name.c_str());
+        return bytes;
+    }
+
+}
+
+#endif